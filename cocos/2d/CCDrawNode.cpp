@@ -24,6 +24,7 @@
 
 #include "2d/CCDrawNode.h"
 #include <stddef.h> // offsetof
+#include <cfloat>
 #include "base/ccTypes.h"
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
@@ -32,6 +33,7 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "2d/CCActionCatmullRom.h"
+#include "2d/CCCamera.h"
 #include "base/ccUtils.h"
 #include "renderer/ccShaders.h"
 #include "renderer/backend/ProgramState.h"
@@ -96,6 +98,13 @@ void DrawNode::ensureCapacity(int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
     
+    if (_baked)
+    {
+        CCLOG("DrawNode: drawing into a baked node discards its baked content");
+        clear();
+    }
+    _cullingDirty = true;
+    
     if(_bufferCount + count > _bufferCapacity)
     {
         _bufferCapacity += MAX(_bufferCapacity, count);
@@ -110,6 +119,13 @@ void DrawNode::ensureCapacityGLPoint(int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
     
+    if (_baked)
+    {
+        CCLOG("DrawNode: drawing into a baked node discards its baked content");
+        clear();
+    }
+    _cullingDirty = true;
+    
     if(_bufferCountGLPoint + count > _bufferCapacityGLPoint)
     {
         _bufferCapacityGLPoint += MAX(_bufferCapacityGLPoint, count);
@@ -124,6 +140,13 @@ void DrawNode::ensureCapacityGLLine(int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
     
+    if (_baked)
+    {
+        CCLOG("DrawNode: drawing into a baked node discards its baked content");
+        clear();
+    }
+    _cullingDirty = true;
+    
     if(_bufferCountGLLine + count > _bufferCapacityGLLine)
     {
         _bufferCapacityGLLine += MAX(_bufferCapacityGLLine, count);
@@ -237,7 +260,9 @@ void DrawNode::updateUniforms(const Mat4 &transform, CustomCommand& cmd)
 
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    if(_bufferCount)
+    bool culling = _cullingEnabled && !_primitives.empty() && updateVisibleRect(transform);
+
+    if(prepareLayerCommand(LAYER_TRIANGLE, culling))
     {
         updateBlendState(_customCommand);
         updateUniforms(transform, _customCommand);
@@ -245,7 +270,7 @@ void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         renderer->addCommand(&_customCommand);
     }
     
-    if(_bufferCountGLPoint)
+    if(prepareLayerCommand(LAYER_POINT, culling))
     {
         updateBlendState(_customCommandGLPoint);
         updateUniforms(transform, _customCommandGLPoint);
@@ -253,7 +278,7 @@ void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         renderer->addCommand(&_customCommandGLPoint);
     }
     
-    if(_bufferCountGLLine)
+    if(prepareLayerCommand(LAYER_LINE, culling))
     {
         updateBlendState(_customCommandGLLine);
         updateUniforms(transform, _customCommandGLLine);
@@ -261,6 +286,9 @@ void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         _customCommandGLLine.init(_globalZOrder);
         renderer->addCommand(&_customCommandGLLine);
     }
+
+    if (culling)
+        _cullingDirty = false;
 }
 
 void DrawNode::drawPoint(const Vec2& position, const float pointSize, const Color4F &color)
@@ -734,6 +762,360 @@ void DrawNode::clear()
     _bufferCountGLPoint = 0;
     _dirtyGLPoint = true;
     _lineWidth = _defaultLineWidth;
+
+    _primitives.clear();
+    _recordingPrimitive = false;
+    _baked = false;
+    _cullingDirty = true;
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+        _removedCount[layer] = 0;
+}
+
+void DrawNode::beginPrimitive()
+{
+    CCASSERT(!_recordingPrimitive, "DrawNode: primitives can't be nested");
+    if (_baked)
+        clear();
+
+    _recordingPrimitive = true;
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        _pendingPrimitive.start[layer] = getLayerCount(layer);
+        _pendingPrimitive.count[layer] = 0;
+    }
+}
+
+DrawNode::PrimitiveHandle DrawNode::endPrimitive()
+{
+    CCASSERT(_recordingPrimitive, "DrawNode: endPrimitive() called without beginPrimitive()");
+    if (!_recordingPrimitive)
+        return 0;
+    _recordingPrimitive = false;
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    int total = 0;
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        int start = _pendingPrimitive.start[layer];
+        int count = getLayerCount(layer) - start;
+        _pendingPrimitive.count[layer] = count;
+        total += count;
+
+        const V2F_C4B_T2F* vertices = getLayerBuffer(layer) + start;
+        for (int i = 0; i < count; ++i)
+        {
+            // points carry their size in texCoords.u, lines are rasterized with _lineWidth
+            float extent = 0.0f;
+            if (layer == LAYER_POINT)
+                extent = vertices[i].texCoords.u * 0.5f;
+            else if (layer == LAYER_LINE)
+                extent = _lineWidth * 0.5f;
+
+            minX = std::min(minX, vertices[i].vertices.x - extent);
+            minY = std::min(minY, vertices[i].vertices.y - extent);
+            maxX = std::max(maxX, vertices[i].vertices.x + extent);
+            maxY = std::max(maxY, vertices[i].vertices.y + extent);
+        }
+    }
+
+    if (total == 0)
+        return 0;
+
+    _pendingPrimitive.bounds.setRect(minX, minY, maxX - minX, maxY - minY);
+    _pendingPrimitive.removed = false;
+
+    PrimitiveHandle handle = _nextPrimitiveHandle++;
+    _primitives[handle] = _pendingPrimitive;
+    _cullingDirty = true;
+    return handle;
+}
+
+bool DrawNode::removePrimitive(PrimitiveHandle handle)
+{
+    Primitive* primitive = findPrimitive(handle);
+    if (primitive == nullptr || _baked)
+        return false;
+
+    // collapse the vertices in place so that the ARRAY draw skips them without moving the rest of the buffer
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        V2F_C4B_T2F* vertices = getLayerBuffer(layer) + primitive->start[layer];
+        for (int i = 0; i < primitive->count[layer]; ++i)
+        {
+            vertices[i] = {vertices[0].vertices, Color4B(0, 0, 0, 0), Tex2F(0.0, 0.0)};
+        }
+        _removedCount[layer] += primitive->count[layer];
+    }
+    primitive->removed = true;
+    uploadPrimitive(*primitive);
+    _cullingDirty = true;
+
+    bool shouldCompact = false;
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        if (_removedCount[layer] * 2 > getLayerCount(layer))
+            shouldCompact = true;
+    }
+    if (shouldCompact && !_recordingPrimitive)
+        compactPrimitives();
+
+    return true;
+}
+
+bool DrawNode::setPrimitiveColor(PrimitiveHandle handle, const Color4F &color)
+{
+    Primitive* primitive = findPrimitive(handle);
+    if (primitive == nullptr || _baked)
+        return false;
+
+    Color4B col(color);
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        V2F_C4B_T2F* vertices = getLayerBuffer(layer) + primitive->start[layer];
+        for (int i = 0; i < primitive->count[layer]; ++i)
+        {
+            vertices[i].colors = col;
+        }
+    }
+    uploadPrimitive(*primitive);
+    return true;
+}
+
+bool DrawNode::movePrimitive(PrimitiveHandle handle, const Vec2 &offset)
+{
+    Primitive* primitive = findPrimitive(handle);
+    if (primitive == nullptr || _baked)
+        return false;
+
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        V2F_C4B_T2F* vertices = getLayerBuffer(layer) + primitive->start[layer];
+        for (int i = 0; i < primitive->count[layer]; ++i)
+        {
+            vertices[i].vertices += offset;
+        }
+    }
+    primitive->bounds.origin += offset;
+    uploadPrimitive(*primitive);
+    _cullingDirty = true;
+    return true;
+}
+
+bool DrawNode::isPrimitiveValid(PrimitiveHandle handle) const
+{
+    auto iter = _primitives.find(handle);
+    return iter != _primitives.end() && !iter->second.removed;
+}
+
+void DrawNode::bake()
+{
+    CCASSERT(!_recordingPrimitive, "DrawNode: can't bake while recording a primitive");
+    if (_baked || _recordingPrimitive)
+        return;
+
+    compactPrimitives();
+
+    auto bakeLayer = [](CustomCommand& cmd, V2F_C4B_T2F*& buffer, int& capacity, int count) {
+        if (count > 0)
+        {
+            cmd.createVertexBuffer(sizeof(V2F_C4B_T2F), count, CustomCommand::BufferUsage::STATIC);
+            cmd.updateVertexBuffer(buffer, count*sizeof(V2F_C4B_T2F));
+        }
+        free(buffer);
+        buffer = nullptr;
+        capacity = 0;
+    };
+    bakeLayer(_customCommand, _buffer, _bufferCapacity, _bufferCount);
+    bakeLayer(_customCommandGLPoint, _bufferGLPoint, _bufferCapacityGLPoint, _bufferCountGLPoint);
+    bakeLayer(_customCommandGLLine, _bufferGLLine, _bufferCapacityGLLine, _bufferCountGLLine);
+
+    _baked = true;
+}
+
+void DrawNode::setCullingEnabled(bool enabled)
+{
+    _cullingEnabled = enabled;
+    _cullingDirty = true;
+}
+
+V2F_C4B_T2F* DrawNode::getLayerBuffer(int layer) const
+{
+    switch (layer)
+    {
+        case LAYER_POINT: return _bufferGLPoint;
+        case LAYER_LINE: return _bufferGLLine;
+        default: return _buffer;
+    }
+}
+
+int& DrawNode::getLayerCount(int layer)
+{
+    switch (layer)
+    {
+        case LAYER_POINT: return _bufferCountGLPoint;
+        case LAYER_LINE: return _bufferCountGLLine;
+        default: return _bufferCount;
+    }
+}
+
+CustomCommand& DrawNode::getLayerCommand(int layer)
+{
+    switch (layer)
+    {
+        case LAYER_POINT: return _customCommandGLPoint;
+        case LAYER_LINE: return _customCommandGLLine;
+        default: return _customCommand;
+    }
+}
+
+DrawNode::Primitive* DrawNode::findPrimitive(PrimitiveHandle handle)
+{
+    auto iter = _primitives.find(handle);
+    if (iter == _primitives.end() || iter->second.removed)
+        return nullptr;
+    return &iter->second;
+}
+
+void DrawNode::uploadPrimitive(const Primitive& primitive)
+{
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        int start = primitive.start[layer];
+        int count = primitive.count[layer];
+        if (count > 0)
+            getLayerCommand(layer).updateVertexBuffer(getLayerBuffer(layer) + start, start*sizeof(V2F_C4B_T2F), count*sizeof(V2F_C4B_T2F));
+    }
+}
+
+void DrawNode::compactPrimitives()
+{
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        if (_removedCount[layer] == 0)
+            continue;
+
+        // primitives are recorded in buffer order, so the map walks the buffer front to back
+        V2F_C4B_T2F* buffer = getLayerBuffer(layer);
+        int& count = getLayerCount(layer);
+        int write = 0;
+        int read = 0;
+        for (auto& entry : _primitives)
+        {
+            Primitive& primitive = entry.second;
+            int start = primitive.start[layer];
+
+            // geometry drawn outside of any primitive is kept as is
+            memmove(buffer + write, buffer + read, (start - read)*sizeof(V2F_C4B_T2F));
+            write += start - read;
+            read = start + primitive.count[layer];
+
+            if (primitive.removed)
+                continue;
+            memmove(buffer + write, buffer + start, primitive.count[layer]*sizeof(V2F_C4B_T2F));
+            primitive.start[layer] = write;
+            write += primitive.count[layer];
+        }
+        memmove(buffer + write, buffer + read, (count - read)*sizeof(V2F_C4B_T2F));
+        write += count - read;
+
+        count = write;
+        _removedCount[layer] = 0;
+
+        auto& cmd = getLayerCommand(layer);
+        cmd.updateVertexBuffer(buffer, 0, count*sizeof(V2F_C4B_T2F));
+        cmd.setVertexDrawInfo(0, count);
+    }
+
+    for (auto iter = _primitives.begin(); iter != _primitives.end();)
+    {
+        if (iter->second.removed)
+            iter = _primitives.erase(iter);
+        else
+            ++iter;
+    }
+    _cullingDirty = true;
+}
+
+bool DrawNode::updateVisibleRect(const Mat4 &transform)
+{
+    // same restriction as Renderer::checkVisibility, only the default camera maps world space onto the visible rect
+    auto camera = Camera::getVisitingCamera();
+    if (camera == nullptr || camera != Camera::getDefaultCamera())
+        return false;
+
+    Vec2 origin = _director->getVisibleOrigin();
+    Size size = _director->getVisibleSize();
+    Vec3 corners[4] = {
+        Vec3(origin.x, origin.y, 0.0f),
+        Vec3(origin.x + size.width, origin.y, 0.0f),
+        Vec3(origin.x, origin.y + size.height, 0.0f),
+        Vec3(origin.x + size.width, origin.y + size.height, 0.0f)
+    };
+
+    Mat4 worldToNode = transform.getInversed();
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (auto& corner : corners)
+    {
+        worldToNode.transformPoint(&corner);
+        minX = std::min(minX, corner.x);
+        minY = std::min(minY, corner.y);
+        maxX = std::max(maxX, corner.x);
+        maxY = std::max(maxY, corner.y);
+    }
+
+    Rect visibleRect(minX, minY, maxX - minX, maxY - minY);
+    if (!visibleRect.equals(_visibleRect))
+    {
+        _visibleRect = visibleRect;
+        _cullingDirty = true;
+    }
+    return true;
+}
+
+bool DrawNode::prepareLayerCommand(int layer, bool culling)
+{
+    auto& cmd = getLayerCommand(layer);
+    int count = getLayerCount(layer);
+    // 32 bit indices aren't supported by every GLES2 device, larger layers are drawn whole
+    if (!culling || count > 65536)
+    {
+        cmd.setDrawType(CustomCommand::DrawType::ARRAY);
+        return count > 0;
+    }
+
+    // the index list only changes with the geometry or the visible rect, a still camera reuses it
+    if (_cullingDirty)
+    {
+        _visibleIndices.clear();
+        int cursor = 0;
+        for (const auto& entry : _primitives)
+        {
+            const Primitive& primitive = entry.second;
+            int start = primitive.start[layer];
+            for (; cursor < start; ++cursor)
+                _visibleIndices.push_back(cursor);
+            cursor = start + primitive.count[layer];
+
+            if (primitive.removed || primitive.count[layer] == 0 || !_visibleRect.intersectsRect(primitive.bounds))
+                continue;
+            for (int i = start; i < cursor; ++i)
+                _visibleIndices.push_back(i);
+        }
+        for (; cursor < count; ++cursor)
+            _visibleIndices.push_back(cursor);
+
+        _visibleCount[layer] = (int)_visibleIndices.size();
+        if (_visibleIndices.size() > cmd.getIndexCapacity())
+        {
+            cmd.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, std::max(_visibleIndices.size(), cmd.getIndexCapacity() * 2), CustomCommand::BufferUsage::DYNAMIC);
+        }
+        if (!_visibleIndices.empty())
+            cmd.updateIndexBuffer(_visibleIndices.data(), _visibleIndices.size()*sizeof(unsigned short));
+    }
+
+    cmd.setDrawType(CustomCommand::DrawType::ELEMENT);
+    cmd.setIndexDrawInfo(0, _visibleCount[layer]);
+    return _visibleCount[layer] > 0;
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
@@ -37,6 +37,9 @@
 #include "renderer/CCCustomCommand.h"
 #include "math/CCMath.h"
 
+#include <map>
+#include <vector>
+
 NS_CC_BEGIN
 
 static const int DEFAULT_LINE_WIDTH = 2;
@@ -272,8 +275,62 @@ public:
      */
     void drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, const Color4F &color);
 
-    /** Clear the geometry in the node's buffer. */
+    /** Clear the geometry in the node's buffer, including recorded primitives and baked content. */
     void clear();
+
+    /** Handle of a primitive recorded with beginPrimitive()/endPrimitive(). 0 is never a valid handle. */
+    typedef unsigned int PrimitiveHandle;
+
+    /** Starts recording a primitive. Everything drawn until endPrimitive() is grouped under one handle
+     * that can later be recolored, moved or removed without touching the rest of the node.
+     */
+    void beginPrimitive();
+
+    /** Finishes the primitive started by beginPrimitive().
+     *
+     * @return The handle of the primitive, or 0 if nothing was drawn since beginPrimitive().
+     */
+    PrimitiveHandle endPrimitive();
+
+    /** Removes a primitive. Only its own vertices are re-uploaded; the buffer is compacted
+     * once removed vertices make up more than half of it.
+     *
+     * @return False if the handle is unknown or the node is baked.
+     */
+    bool removePrimitive(PrimitiveHandle handle);
+
+    /** Replaces the color of every vertex of a primitive and uploads only that vertex range.
+     *
+     * @return False if the handle is unknown or the node is baked.
+     */
+    bool setPrimitiveColor(PrimitiveHandle handle, const Color4F &color);
+
+    /** Translates a primitive by offset and uploads only its vertex range.
+     *
+     * @return False if the handle is unknown or the node is baked.
+     */
+    bool movePrimitive(PrimitiveHandle handle, const Vec2 &offset);
+
+    /** Returns whether handle refers to a live primitive. */
+    bool isPrimitiveValid(PrimitiveHandle handle) const;
+
+    /** Uploads the current geometry into tightly sized GPU buffers and releases the CPU side copy.
+     * A baked node can't be edited any more: primitive updates fail, and drawing into it starts
+     * over from an empty node. Call clear() to make it editable again.
+     */
+    void bake();
+
+    /** Returns whether the node was baked with bake(). */
+    bool isBaked() const { return _baked; }
+
+    /** Enables culling of recorded primitives that fall outside the visible rect of the default camera.
+     * Geometry drawn outside beginPrimitive()/endPrimitive() is always drawn. The index list is 16 bit,
+     * so a layer of more than 65536 vertices is drawn without culling.
+     */
+    void setCullingEnabled(bool enabled);
+
+    /** Returns whether primitive culling is enabled. */
+    bool isCullingEnabled() const { return _cullingEnabled; }
     /** Get the color mixed mode.
     * @lua NA
     */
@@ -320,6 +377,31 @@ protected:
     void updateBlendState(CustomCommand& cmd);
     void updateUniforms(const Mat4 &transform, CustomCommand& cmd);
 
+    enum PrimitiveLayer
+    {
+        LAYER_TRIANGLE,
+        LAYER_POINT,
+        LAYER_LINE,
+        LAYER_COUNT
+    };
+
+    struct Primitive
+    {
+        int  start[LAYER_COUNT];
+        int  count[LAYER_COUNT];
+        Rect bounds;
+        bool removed;
+    };
+
+    V2F_C4B_T2F* getLayerBuffer(int layer) const;
+    int& getLayerCount(int layer);
+    CustomCommand& getLayerCommand(int layer);
+    Primitive* findPrimitive(PrimitiveHandle handle);
+    void uploadPrimitive(const Primitive& primitive);
+    void compactPrimitives();
+    bool updateVisibleRect(const Mat4 &transform);
+    bool prepareLayerCommand(int layer, bool culling);
+
     int         _bufferCapacity = 0;
     int         _bufferCount = 0;
     V2F_C4B_T2F *_buffer = nullptr;
@@ -348,6 +430,18 @@ protected:
     bool        _dirtyGLPoint = false;
     bool        _dirtyGLLine = false;
     bool        _isolated = false;
+    bool        _baked = false;
+    bool        _cullingEnabled = false;
+    bool        _cullingDirty = true;
+    bool        _recordingPrimitive = false;
+
+    std::map<PrimitiveHandle, Primitive> _primitives;
+    PrimitiveHandle _nextPrimitiveHandle = 1;
+    Primitive   _pendingPrimitive;
+    int         _removedCount[LAYER_COUNT] = {0, 0, 0};
+    int         _visibleCount[LAYER_COUNT] = {0, 0, 0};
+    Rect        _visibleRect;
+    std::vector<unsigned short> _visibleIndices;
     float       _lineWidth = 0.0f;
     float       _defaultLineWidth = 0.0f;
 private:
@@ -30,12 +30,22 @@
 #elif CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 #include "platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
 #endif
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include "2d/CCFontFreeType.h"
+#include "2d/CCLabelLayoutCache.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
+#include "base/CCScheduler.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
 
@@ -44,6 +54,151 @@ const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
 
+namespace {
+    FontAtlas::GlyphRasterizationMode s_glyphRasterizationMode = FontAtlas::GlyphRasterizationMode::MAIN_THREAD;
+
+    // glyphs handed to one worker task, fewer aren't worth the hand-off
+    const size_t MinGlyphsPerTask = 8;
+
+    // "CCFA", followed by the version of the layout written by FontAtlas::saveToFile
+    const uint32_t AtlasFileMagic = 0x41464343;
+    const uint32_t AtlasFileVersion = 1;
+
+    template <typename T>
+    void writeValue(std::vector<unsigned char>& buffer, const T& value)
+    {
+        auto bytes = reinterpret_cast<const unsigned char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    /** Reads the values written by writeValue, failing instead of reading past the end. */
+    class AtlasFileReader
+    {
+    public:
+        AtlasFileReader(const unsigned char* data, size_t size) : _data(data), _size(size) {}
+
+        template <typename T>
+        bool read(T& value)
+        {
+            return read(&value, sizeof(T));
+        }
+
+        bool read(void* out, size_t length)
+        {
+            if (length > _size - _offset)
+                return false;
+            memcpy(out, _data + _offset, length);
+            _offset += length;
+            return true;
+        }
+
+    private:
+        const unsigned char* _data;
+        size_t _size;
+        size_t _offset = 0;
+    };
+
+    /** Worker threads shared by all font atlases. */
+    class GlyphRasterizerPool
+    {
+    public:
+        static GlyphRasterizerPool& getInstance()
+        {
+            static GlyphRasterizerPool pool;
+            return pool;
+        }
+
+        int getThreadCount() const { return static_cast<int>(_threads.size()); }
+
+        void enqueue(const std::function<void()>& task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.push(task);
+            }
+            _condition.notify_one();
+        }
+
+    private:
+        GlyphRasterizerPool()
+        {
+            unsigned int threadCount = std::thread::hardware_concurrency();
+            threadCount = std::max(1u, std::min(4u, threadCount > 1 ? threadCount - 1 : 1));
+            for (unsigned int i = 0; i < threadCount; ++i)
+            {
+                _threads.emplace_back(&GlyphRasterizerPool::run, this);
+            }
+        }
+
+        ~GlyphRasterizerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (auto& thread : _threads)
+            {
+                thread.join();
+            }
+        }
+
+        void run()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                    if (_stop && _tasks.empty())
+                        return;
+                    task = std::move(_tasks.front());
+                    _tasks.pop();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread> _threads;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop = false;
+    };
+}
+
+/** A glyph rendered into a cell of its own, waiting to be packed into a page. */
+struct FontAtlas::RenderedGlyph
+{
+    char32_t utf32Char = 0;
+    FontLetterDefinition definition;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+/** The fonts used by worker threads, each FT_Face is only used by one thread at a time. */
+struct FontAtlas::WorkerRasterizers
+{
+    std::vector<FontFreeType*> rasterizers;
+    std::vector<FontFreeType*> idleRasterizers;
+    std::vector<RenderedGlyph> renderedGlyphs;
+    int pendingTasks = 0;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+void FontAtlas::setGlyphRasterizationMode(GlyphRasterizationMode mode)
+{
+    s_glyphRasterizationMode = mode;
+}
+
+FontAtlas::GlyphRasterizationMode FontAtlas::getGlyphRasterizationMode()
+{
+    return s_glyphRasterizationMode;
+}
+
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 {
@@ -108,10 +263,28 @@ void FontAtlas::reinit()
 
     addTexture(texture,0);
     texture->release();
+
+    resetPacking();
 }
 
 FontAtlas::~FontAtlas()
 {
+    if (_workers)
+    {
+        // tasks still running use the rasterizers and this atlas
+        {
+            std::unique_lock<std::mutex> lock(_workers->mutex);
+            _workers->condition.wait(lock, [this] { return _workers->pendingTasks == 0; });
+        }
+        Director::getInstance()->getScheduler()->unschedule("FontAtlas::collectRenderedGlyphs", this);
+        for (auto rasterizer : _workers->rasterizers)
+        {
+            rasterizer->release();
+        }
+        delete _workers;
+        _workers = nullptr;
+    }
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     if (_fontFreeType && _rendererRecreatedListener)
     {
@@ -121,6 +294,8 @@ FontAtlas::~FontAtlas()
     }
 #endif
 
+    LabelLayoutCache::removeLayoutsForAtlas(this);
+
     _font->release();
     releaseTextures();
 
@@ -162,11 +337,9 @@ void FontAtlas::reset()
 {
     releaseTextures();
     
-    _currLineHeight = 0;
     _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
     _letterDefinitions.clear();
+    LabelLayoutCache::removeLayoutsForAtlas(this);
     
     reinit();
 }
@@ -178,6 +351,7 @@ void FontAtlas::releaseTextures()
         item.second->release();
     }
     _atlasTextures.clear();
+    _filledPages.clear();
 }
 
 void FontAtlas::purgeTexturesAtlas()
@@ -369,117 +543,481 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
     
     std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
     findNewCharacters(utf32Text, codeMapOfNewChar);
-    if (codeMapOfNewChar.empty())
+
+    std::vector<std::pair<char32_t, unsigned int>> newLetters;
+    newLetters.reserve(codeMapOfNewChar.size());
+    bool waitForLetters = false;
+    for (auto&& it : codeMapOfNewChar)
     {
-        return false;
+        if (_pendingLetters.find(it.first) == _pendingLetters.end())
+        {
+            newLetters.emplace_back(it.first, it.second);
+        }
+        else if (s_glyphRasterizationMode != GlyphRasterizationMode::WORKER_THREADS_DEFERRED)
+        {
+            // still being prewarmed, only deferred labels may go without it
+            waitForLetters = true;
+        }
+    }
+
+    if (newLetters.empty())
+    {
+        if (waitForLetters)
+        {
+            waitForPendingLetters();
+            return true;
+        }
+        // letters rasterized in the background may have arrived since the last frame
+        return _workers ? addRenderedGlyphs() : false;
     }
 
+    if (s_glyphRasterizationMode != GlyphRasterizationMode::MAIN_THREAD && rasterizeOnWorkers(newLetters))
+    {
+        if (s_glyphRasterizationMode == GlyphRasterizationMode::WORKER_THREADS_WAIT)
+        {
+            waitForPendingLetters();
+        }
+        else if (s_glyphRasterizationMode == GlyphRasterizationMode::WORKER_THREADS_DEFERRED)
+        {
+            scheduleGlyphCollection();
+        }
+        return true;
+    }
+
+    rasterizeLetters(newLetters);
+    if (waitForLetters)
+    {
+        waitForPendingLetters();
+    }
+    return true;
+}
+
+void FontAtlas::rasterizeLetters(const std::vector<std::pair<char32_t, unsigned int>>& letters)
+{
+    RenderedGlyph glyph;
+    for (auto&& it : letters)
+    {
+        rasterizeGlyph(_fontFreeType, it.first, it.second, glyph);
+        addRenderedGlyph(glyph);
+    }
+
+    flushDirtyRows();
+    ++_letterGeneration;
+}
+
+void FontAtlas::prewarmLetterDefinitions(const std::u32string& utf32Text, const std::function<void()>& callback)
+{
+    if (_fontFreeType != nullptr)
+    {
+        if (!_currentPageData)
+            reinit();
+
+        std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
+        findNewCharacters(utf32Text, codeMapOfNewChar);
+
+        std::vector<std::pair<char32_t, unsigned int>> newLetters;
+        newLetters.reserve(codeMapOfNewChar.size());
+        for (auto&& it : codeMapOfNewChar)
+        {
+            if (_pendingLetters.find(it.first) == _pendingLetters.end())
+            {
+                newLetters.emplace_back(it.first, it.second);
+            }
+        }
+
+        if (!newLetters.empty())
+        {
+            if (rasterizeOnWorkers(newLetters))
+                scheduleGlyphCollection();
+            else
+                rasterizeLetters(newLetters);
+        }
+    }
+
+    if (callback)
+    {
+        _prewarmCallbacks.push_back(callback);
+        if (_pendingLetters.empty())
+        {
+            callPrewarmCallbacks();
+        }
+    }
+}
+
+void FontAtlas::callPrewarmCallbacks()
+{
+    // a callback may prewarm again
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(_prewarmCallbacks);
+    for (auto&& callback : callbacks)
+    {
+        callback();
+    }
+}
+
+void FontAtlas::rasterizeGlyph(FontFreeType* rasterizer, char32_t utf32Char, unsigned int charCode, RenderedGlyph& glyph) const
+{
     int adjustForDistanceMap = _letterPadding / 2;
     int adjustForExtend = _letterEdgeExtend / 2;
     long bitmapWidth;
     long bitmapHeight;
-    int glyphHeight;
     Rect tempRect;
-    FontLetterDefinition tempDef;
+    FontLetterDefinition& tempDef = glyph.definition;
 
-    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? backend::PixelFormat::AI88 : backend::PixelFormat::A8;
+    glyph.utf32Char = utf32Char;
+    glyph.width = 0;
+    glyph.height = 0;
+    glyph.pixels.clear();
 
-    int startY = (int)_currentPageOrigY;
+    auto bitmap = rasterizer->getGlyphBitmap(charCode, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
+    if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+    {
+        tempDef.validDefinition = true;
+        tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
+        tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
+        tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+        tempDef.rotated = false;
 
-    for (auto&& it : codeMapOfNewChar)
+        // render into a cell of its own, it is copied into a page when it is packed
+        int bytesPerPixel = rasterizer->getOutlineSize() > 0 ? 2 : 1;
+        glyph.width = std::max(static_cast<int>(bitmapWidth), static_cast<int>(tempRect.size.width)) + _letterPadding + _letterEdgeExtend;
+        glyph.height = std::max(static_cast<int>(bitmapHeight), static_cast<int>(tempRect.size.height)) + _letterPadding + _letterEdgeExtend;
+        glyph.pixels.assign(glyph.width * glyph.height * bytesPerPixel, 0);
+        rasterizer->renderCharAt(glyph.pixels.data(), adjustForExtend, adjustForExtend, bitmap, bitmapWidth, bitmapHeight, glyph.width);
+    }
+    else
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
-        {
+        if(bitmap)
+            delete[] bitmap;
+        if (tempDef.xAdvance)
             tempDef.validDefinition = true;
-            tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width = 0;
+        tempDef.height = 0;
+        tempDef.U = 0;
+        tempDef.V = 0;
+        tempDef.offsetX = 0;
+        tempDef.offsetY = 0;
+        tempDef.textureID = 0;
+        tempDef.rotated = false;
+    }
+}
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+void FontAtlas::addRenderedGlyph(const RenderedGlyph& glyph)
+{
+    FontLetterDefinition letterDefinition = glyph.definition;
+
+    if (!glyph.pixels.empty())
+    {
+        // leave a pixel between glyphs, so that linear filtering doesn't pick up the neighbours
+        int x = 0;
+        int y = 0;
+        bool packed = packGlyph(glyph.width + 1, glyph.height + 1, x, y);
+        if (!packed && glyph.width < CacheTextureWidth && glyph.height < CacheTextureHeight)
+        {
+            flushDirtyRows();
+            addPage();
+            packed = packGlyph(glyph.width + 1, glyph.height + 1, x, y);
+        }
+
+        if (!packed)
+        {
+            CCLOG("cocos2d: FontAtlas: letter 0x%x doesn't fit in an atlas page", static_cast<unsigned int>(glyph.utf32Char));
+            letterDefinition.validDefinition = false;
+            letterDefinition.width = 0;
+            letterDefinition.height = 0;
+        }
+        else
+        {
+            int bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+            int rowBytes = glyph.width * bytesPerPixel;
+            for (int row = 0; row < glyph.height; ++row)
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    updateTextureContent(pixelFormat, startY);
-
-                    startY = 0;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    
-                    initTextureWithZeros(tex);
-
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    addTexture(tex, _currentPage);
-                    
-                    tex->release();
-                }
+                memcpy(_currentPageData + ((y + row) * CacheTextureWidth + x) * bytesPerPixel, glyph.pixels.data() + row * rowBytes, rowBytes);
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+            _dirtyTop = std::min(_dirtyTop, y);
+            _dirtyBottom = std::max(_dirtyBottom, y + glyph.height);
+
+            // take from pixels to points
+            auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+            letterDefinition.U = x / scaleFactor;
+            letterDefinition.V = y / scaleFactor;
+            letterDefinition.width = letterDefinition.width / scaleFactor;
+            letterDefinition.height = letterDefinition.height / scaleFactor;
+            letterDefinition.textureID = _currentPage;
+        }
+    }
+
+    _letterDefinitions[glyph.utf32Char] = letterDefinition;
+}
+
+bool FontAtlas::addRenderedGlyphs()
+{
+    std::vector<RenderedGlyph> renderedGlyphs;
+    {
+        std::lock_guard<std::mutex> lock(_workers->mutex);
+        renderedGlyphs.swap(_workers->renderedGlyphs);
+    }
+
+    if (renderedGlyphs.empty())
+    {
+        return false;
+    }
+
+    for (auto&& glyph : renderedGlyphs)
+    {
+        if (_pendingLetters.erase(glyph.utf32Char))
+        {
+            addRenderedGlyph(glyph);
+        }
+    }
+
+    flushDirtyRows();
+    ++_letterGeneration;
+
+    if (_pendingLetters.empty() && !_prewarmCallbacks.empty())
+    {
+        callPrewarmCallbacks();
+    }
+    return true;
+}
+
+bool FontAtlas::rasterizeOnWorkers(const std::vector<std::pair<char32_t, unsigned int>>& letters)
+{
+    auto& pool = GlyphRasterizerPool::getInstance();
+
+    if (_workers == nullptr)
+    {
+        // faces are created here, FreeType doesn't allow creating them from several threads
+        _workers = new (std::nothrow) WorkerRasterizers;
+        for (int i = 0; i < pool.getThreadCount(); ++i)
+        {
+            auto rasterizer = _fontFreeType->cloneForRasterization();
+            if (rasterizer == nullptr)
+                break;
+            _workers->rasterizers.push_back(rasterizer);
+        }
+        _workers->idleRasterizers = _workers->rasterizers;
+    }
+
+    if (_workers->rasterizers.empty())
+    {
+        return false;
+    }
+
+    size_t taskCount = std::min(_workers->rasterizers.size(), (letters.size() + MinGlyphsPerTask - 1) / MinGlyphsPerTask);
+    size_t lettersPerTask = (letters.size() + taskCount - 1) / taskCount;
+
+    for (auto&& letter : letters)
+    {
+        _pendingLetters.insert(letter.first);
+    }
+
+    for (size_t first = 0; first < letters.size(); first += lettersPerTask)
+    {
+        std::vector<std::pair<char32_t, unsigned int>> taskLetters(letters.begin() + first, letters.begin() + std::min(first + lettersPerTask, letters.size()));
+        WorkerRasterizers* workers = _workers;
+        {
+            std::lock_guard<std::mutex> lock(workers->mutex);
+            ++workers->pendingTasks;
+        }
+
+        pool.enqueue([this, workers, taskLetters]() {
+            FontFreeType* rasterizer = nullptr;
             {
-                _currLineHeight = glyphHeight;
+                std::unique_lock<std::mutex> lock(workers->mutex);
+                workers->condition.wait(lock, [workers] { return !workers->idleRasterizers.empty(); });
+                rasterizer = workers->idleRasterizers.back();
+                workers->idleRasterizers.pop_back();
             }
-            _fontFreeType->renderCharAt(_currentPageData, (int)_currentPageOrigX + adjustForExtend, (int)_currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
 
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width = tempDef.width / scaleFactor;
-            tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
-            tempDef.rotated = false;
-        }
-        else{
-            if(bitmap)
-                delete[] bitmap;
-            if (tempDef.xAdvance)
-                tempDef.validDefinition = true;
-            else
-                tempDef.validDefinition = false;
+            std::vector<RenderedGlyph> glyphs(taskLetters.size());
+            for (size_t i = 0; i < taskLetters.size(); ++i)
+            {
+                rasterizeGlyph(rasterizer, taskLetters[i].first, taskLetters[i].second, glyphs[i]);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(workers->mutex);
+                workers->idleRasterizers.push_back(rasterizer);
+                std::move(glyphs.begin(), glyphs.end(), std::back_inserter(workers->renderedGlyphs));
+                --workers->pendingTasks;
+            }
+            workers->condition.notify_all();
+        });
+    }
+
+    return true;
+}
+
+void FontAtlas::scheduleGlyphCollection()
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (!scheduler->isScheduled("FontAtlas::collectRenderedGlyphs", this))
+    {
+        scheduler->schedule(CC_CALLBACK_1(FontAtlas::collectRenderedGlyphs, this), this, 0, false, "FontAtlas::collectRenderedGlyphs");
+    }
+}
+
+void FontAtlas::collectRenderedGlyphs(float /*dt*/)
+{
+    addRenderedGlyphs();
+
+    if (_pendingLetters.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule("FontAtlas::collectRenderedGlyphs", this);
+    }
+}
+
+void FontAtlas::waitForPendingLetters()
+{
+    if (_workers == nullptr)
+    {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_workers->mutex);
+        _workers->condition.wait(lock, [this] { return _workers->pendingTasks == 0; });
+    }
+    addRenderedGlyphs();
+}
 
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            tempDef.rotated = false;
-            _currentPageOrigX += 1;
+void FontAtlas::resetPacking()
+{
+    _skyline.clear();
+    _skyline.push_back({0, 0, CacheTextureWidth});
+    _dirtyTop = CacheTextureHeight;
+    _dirtyBottom = 0;
+}
+
+bool FontAtlas::packGlyph(int width, int height, int& outX, int& outY)
+{
+    // skyline bottom-left: put the glyph where its top edge ends up lowest
+    int bestIndex = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    int bestY = 0;
+
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        int x = _skyline[i].x;
+        if (x + width > CacheTextureWidth)
+            break;
+
+        int y = _skyline[i].y;
+        int widthLeft = width;
+        size_t j = i;
+        while (widthLeft > 0 && j < _skyline.size())
+        {
+            y = std::max(y, _skyline[j].y);
+            widthLeft -= _skyline[j].width;
+            ++j;
         }
 
-        _letterDefinitions[it.first] = tempDef;
+        if (y + height > CacheTextureHeight)
+            continue;
+
+        if (y + height < bestTop || (y + height == bestTop && _skyline[i].width < bestWidth))
+        {
+            bestIndex = static_cast<int>(i);
+            bestTop = y + height;
+            bestWidth = _skyline[i].width;
+            bestY = y;
+        }
+    }
+
+    if (bestIndex < 0)
+    {
+        return false;
+    }
+
+    outX = _skyline[bestIndex].x;
+    outY = bestY;
+
+    SkylineNode node = {outX, bestY + height, width};
+    _skyline.insert(_skyline.begin() + bestIndex, node);
+
+    // shrink or remove the segments now covered by the new one
+    for (size_t i = bestIndex + 1; i < _skyline.size(); )
+    {
+        const SkylineNode& previous = _skyline[i - 1];
+        int overlap = previous.x + previous.width - _skyline[i].x;
+        if (overlap <= 0)
+            break;
+
+        _skyline[i].x += overlap;
+        _skyline[i].width -= overlap;
+        if (_skyline[i].width > 0)
+            break;
+
+        _skyline.erase(_skyline.begin() + i);
+    }
+
+    for (size_t i = 0; i + 1 < _skyline.size(); )
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
     }
 
-    updateTextureContent(pixelFormat, startY);
     return true;
 }
 
-void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY)
+void FontAtlas::addPage()
+{
+    if (_pageDataRetained)
+    {
+        _filledPages.emplace_back(_currentPageData, _currentPageData + _currentPageDataSize);
+    }
+    memset(_currentPageData, 0, _currentPageDataSize);
+    _currentPage++;
+    auto tex = new (std::nothrow) Texture2D;
+    
+    initTextureWithZeros(tex);
+
+    if (_antialiasEnabled)
+    {
+        tex->setAntiAliasTexParameters();
+    }
+    else
+    {
+        tex->setAliasTexParameters();
+    }
+    addTexture(tex, _currentPage);
+    
+    tex->release();
+
+    resetPacking();
+}
+
+void FontAtlas::flushDirtyRows()
+{
+    if (_dirtyBottom > _dirtyTop)
+    {
+        auto pixelFormat = _fontFreeType->getOutlineSize() > 0 ? backend::PixelFormat::AI88 : backend::PixelFormat::A8;
+        updateTextureContent(pixelFormat, _dirtyTop, _dirtyBottom);
+    }
+    _dirtyTop = CacheTextureHeight;
+    _dirtyBottom = 0;
+}
+
+void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY, int endY)
 {
     unsigned char *data = nullptr;
     auto outlineSize = _fontFreeType->getOutlineSize();
     if (outlineSize > 0 && format == backend::PixelFormat::AI88)
     {
-        int nLen = CacheTextureWidth * ((int)_currentPageOrigY - startY + _currLineHeight);
+        int nLen = CacheTextureWidth * (endY - startY);
         data = _currentPageData + CacheTextureWidth * (int)startY * 2;
         memset(_currentPageDataRGBA, 0, 4 * nLen);
         for (auto i = 0; i < nLen; i++)
@@ -487,13 +1025,180 @@ void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY)
             _currentPageDataRGBA[i*4] = data[i*2];
             _currentPageDataRGBA[i*4+3] = data[i*2+1];
         }
-        _atlasTextures[_currentPage]->updateWithData(_currentPageDataRGBA, 0, startY, CacheTextureWidth, (int)_currentPageOrigY - startY + _currLineHeight);
+        _atlasTextures[_currentPage]->updateWithData(_currentPageDataRGBA, 0, startY, CacheTextureWidth, endY - startY);
     }
     else
     {
         data = _currentPageData + CacheTextureWidth * (int)startY;
-       _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, (int)_currentPageOrigY - startY + _currLineHeight);
+       _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, endY - startY);
+    }
+}
+
+bool FontAtlas::saveToFile(const std::string& filePath) const
+{
+    if (_fontFreeType == nullptr || _currentPageData == nullptr || _filledPages.size() != static_cast<size_t>(_currentPage))
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> buffer;
+    buffer.reserve(_currentPageDataSize * (_currentPage + 1) + _letterDefinitions.size() * 48 + 256);
+    writeValue(buffer, AtlasFileMagic);
+    writeValue(buffer, AtlasFileVersion);
+    writeValue(buffer, CC_CONTENT_SCALE_FACTOR());
+    writeValue(buffer, static_cast<int32_t>(CacheTextureWidth));
+    writeValue(buffer, static_cast<int32_t>(CacheTextureHeight));
+    writeValue(buffer, static_cast<int32_t>(_currentPageDataSize));
+    writeValue(buffer, static_cast<int32_t>(_currentPage + 1));
+
+    // the packing state, so that letters added after loading go on filling the current page
+    writeValue(buffer, static_cast<uint32_t>(_skyline.size()));
+    for (auto&& node : _skyline)
+    {
+        writeValue(buffer, static_cast<int32_t>(node.x));
+        writeValue(buffer, static_cast<int32_t>(node.y));
+        writeValue(buffer, static_cast<int32_t>(node.width));
+    }
+
+    // pending letters aren't defined yet, they are rasterized again after loading
+    writeValue(buffer, static_cast<uint32_t>(_letterDefinitions.size()));
+    for (auto&& it : _letterDefinitions)
+    {
+        const FontLetterDefinition& definition = it.second;
+        writeValue(buffer, static_cast<uint32_t>(it.first));
+        writeValue(buffer, definition.U);
+        writeValue(buffer, definition.V);
+        writeValue(buffer, definition.width);
+        writeValue(buffer, definition.height);
+        writeValue(buffer, definition.offsetX);
+        writeValue(buffer, definition.offsetY);
+        writeValue(buffer, static_cast<int32_t>(definition.textureID));
+        writeValue(buffer, static_cast<int32_t>(definition.xAdvance));
+        writeValue(buffer, static_cast<uint8_t>(definition.validDefinition));
+        writeValue(buffer, static_cast<uint8_t>(definition.rotated));
+    }
+
+    for (auto&& page : _filledPages)
+    {
+        buffer.insert(buffer.end(), page.begin(), page.end());
+    }
+    buffer.insert(buffer.end(), _currentPageData, _currentPageData + _currentPageDataSize);
+
+    Data data;
+    data.copy(buffer.data(), buffer.size());
+    return FileUtils::getInstance()->writeDataToFile(data, filePath);
+}
+
+bool FontAtlas::loadFromFile(const std::string& filePath)
+{
+    if (_fontFreeType == nullptr || !_letterDefinitions.empty() || !_pendingLetters.empty())
+    {
+        return false;
     }
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filePath);
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    AtlasFileReader reader(data.getBytes(), static_cast<size_t>(data.getSize()));
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    float scaleFactor = 0.f;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t pageDataSize = 0;
+    int32_t pageCount = 0;
+    int expectedPageDataSize = CacheTextureWidth * CacheTextureHeight * (_fontFreeType->getOutlineSize() > 0 ? 2 : 1);
+    if (!reader.read(magic) || magic != AtlasFileMagic
+        || !reader.read(version) || version != AtlasFileVersion
+        || !reader.read(scaleFactor) || scaleFactor != CC_CONTENT_SCALE_FACTOR()
+        || !reader.read(width) || width != CacheTextureWidth
+        || !reader.read(height) || height != CacheTextureHeight
+        || !reader.read(pageDataSize) || pageDataSize != expectedPageDataSize
+        || !reader.read(pageCount) || pageCount <= 0)
+    {
+        return false;
+    }
+
+    uint32_t skylineSize = 0;
+    if (!reader.read(skylineSize) || skylineSize == 0)
+    {
+        return false;
+    }
+    std::vector<SkylineNode> skyline(skylineSize);
+    for (auto&& node : skyline)
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t nodeWidth = 0;
+        if (!reader.read(x) || !reader.read(y) || !reader.read(nodeWidth))
+        {
+            return false;
+        }
+        node = {x, y, nodeWidth};
+    }
+
+    uint32_t letterCount = 0;
+    if (!reader.read(letterCount))
+    {
+        return false;
+    }
+    std::unordered_map<char32_t, FontLetterDefinition> letterDefinitions;
+    letterDefinitions.reserve(letterCount);
+    for (uint32_t i = 0; i < letterCount; ++i)
+    {
+        uint32_t utf32Char = 0;
+        FontLetterDefinition definition;
+        int32_t textureID = 0;
+        int32_t xAdvance = 0;
+        uint8_t validDefinition = 0;
+        uint8_t rotated = 0;
+        if (!reader.read(utf32Char)
+            || !reader.read(definition.U) || !reader.read(definition.V)
+            || !reader.read(definition.width) || !reader.read(definition.height)
+            || !reader.read(definition.offsetX) || !reader.read(definition.offsetY)
+            || !reader.read(textureID) || !reader.read(xAdvance)
+            || !reader.read(validDefinition) || !reader.read(rotated)
+            || textureID < 0 || textureID >= pageCount)
+        {
+            return false;
+        }
+        definition.textureID = textureID;
+        definition.xAdvance = xAdvance;
+        definition.validDefinition = validDefinition != 0;
+        definition.rotated = rotated != 0;
+        letterDefinitions[static_cast<char32_t>(utf32Char)] = definition;
+    }
+
+    std::vector<std::vector<unsigned char>> pages(pageCount);
+    for (auto&& page : pages)
+    {
+        page.resize(pageDataSize);
+        if (!reader.read(page.data(), page.size()))
+        {
+            return false;
+        }
+    }
+
+    // the file is complete, upload its pages in place of the empty ones
+    reset();
+    for (int32_t i = 0; i < pageCount; ++i)
+    {
+        if (i > 0)
+        {
+            addPage();
+        }
+        memcpy(_currentPageData, pages[i].data(), pageDataSize);
+        _dirtyTop = 0;
+        _dirtyBottom = CacheTextureHeight;
+        flushDirtyRows();
+    }
+    _skyline = std::move(skyline);
+    _letterDefinitions = std::move(letterDefinitions);
+    ++_letterGeneration;
+    return true;
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -29,8 +29,11 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
@@ -61,6 +64,17 @@ struct FontLetterDefinition
 class CC_DLL FontAtlas : public Ref
 {
 public:
+    /** Where the glyphs of TTF fonts are rasterized, see setGlyphRasterizationMode(). */
+    enum class GlyphRasterizationMode
+    {
+        /** Glyphs are rasterized on the main thread when a label needs them. */
+        MAIN_THREAD,
+        /** Glyphs are rasterized on worker threads in parallel, and the label waits for them. */
+        WORKER_THREADS_WAIT,
+        /** Glyphs are rasterized on worker threads, labels leave them out until they are added. */
+        WORKER_THREADS_DEFERRED
+    };
+
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
@@ -80,6 +94,50 @@ public:
     
     bool prepareLetterDefinitions(const std::u32string& utf16String);
 
+    /** Sets where new glyphs are rasterized, GlyphRasterizationMode::MAIN_THREAD by default.
+     Worker threads render glyphs with faces of their own, the main thread packs them into the
+     atlas pages and uploads the changed rows once per batch.
+     */
+    static void setGlyphRasterizationMode(GlyphRasterizationMode mode);
+    static GlyphRasterizationMode getGlyphRasterizationMode();
+
+    /** Whether a letter was requested and is still being rasterized on a worker thread. */
+    bool isLetterPending(char32_t utf32Char) const { return _pendingLetters.find(utf32Char) != _pendingLetters.end(); }
+    bool hasPendingLetters() const { return !_pendingLetters.empty(); }
+
+    /** Increases every time rasterized letters are added, labels waiting for letters relayout when it changes. */
+    unsigned int getLetterGeneration() const { return _letterGeneration; }
+
+    /** Waits for the letters being rasterized on worker threads and adds them to the atlas. */
+    void waitForPendingLetters();
+
+    /** Rasterizes the letters of a text before any label shows them, on worker threads when they are
+     available, so that the first frames showing the text don't pay for it.
+     Labels needing one of these letters meanwhile wait for it, unless the rasterization mode is
+     GlyphRasterizationMode::WORKER_THREADS_DEFERRED.
+     The callback is called on the main thread once no letter is pending anymore.
+     */
+    void prewarmLetterDefinitions(const std::u32string& utf32Text, const std::function<void()>& callback = nullptr);
+
+    /** Keeps a copy of the pixels of the filled pages, which saveToFile() needs.
+     Has to be enabled before the first page is filled.
+     */
+    void setPageDataRetained(bool retained) { _pageDataRetained = retained; }
+    bool isPageDataRetained() const { return _pageDataRetained; }
+
+    /** Writes the pages and the letter definitions of a TTF atlas to a file.
+     Letters still being rasterized are left out.
+     @return false if the atlas isn't a TTF one, or if filled pages weren't retained.
+     */
+    bool saveToFile(const std::string& filePath) const;
+
+    /** Fills an empty TTF atlas with the pages and the letter definitions of a file written by saveToFile(),
+     without rasterizing any glyph.
+     @return false if the file is missing, was written for another font configuration or content scale factor,
+     or if the atlas already has letters.
+     */
+    bool loadFromFile(const std::string& filePath);
+
     const std::unordered_map<ssize_t, Texture2D*>& getTextures() const { return _atlasTextures; }
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -132,7 +190,31 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
     
-    void updateTextureContent(backend::PixelFormat format, int startY);
+    void updateTextureContent(backend::PixelFormat format, int startY, int endY);
+
+    struct RenderedGlyph;
+    struct WorkerRasterizers;
+
+    /** A segment of the top edge of the glyphs packed in the current page. */
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    void rasterizeGlyph(FontFreeType* rasterizer, char32_t utf32Char, unsigned int charCode, RenderedGlyph& glyph) const;
+    void addRenderedGlyph(const RenderedGlyph& glyph);
+    bool addRenderedGlyphs();
+    bool rasterizeOnWorkers(const std::vector<std::pair<char32_t, unsigned int>>& letters);
+    void rasterizeLetters(const std::vector<std::pair<char32_t, unsigned int>>& letters);
+    void scheduleGlyphCollection();
+    void callPrewarmCallbacks();
+    void collectRenderedGlyphs(float dt);
+    bool packGlyph(int width, int height, int& outX, int& outY);
+    void resetPacking();
+    void addPage();
+    void flushDirtyRows();
 
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
@@ -147,15 +229,24 @@ protected:
     unsigned char *_currentPageDataRGBA = nullptr;
     int _currentPageDataSize = 0;
     int _currentPageDataSizeRGBA = 0;
-    float _currentPageOrigX = 0;
-    float _currentPageOrigY = 0;
+    std::vector<SkylineNode> _skyline;
+    int _dirtyTop = 0;
+    int _dirtyBottom = 0;
     int _letterPadding = 0;
     int _letterEdgeExtend = 0;
 
     int _fontAscender = 0;
     EventListenerCustom* _rendererRecreatedListener = nullptr;
     bool _antialiasEnabled = true;
-    int _currLineHeight = 0;
+
+    WorkerRasterizers* _workers = nullptr;
+    std::unordered_set<char32_t> _pendingLetters;
+    unsigned int _letterGeneration = 0;
+    std::vector<std::function<void()>> _prewarmCallbacks;
+
+    // pixels of the pages before the current one, kept for saveToFile()
+    bool _pageDataRetained = false;
+    std::vector<std::vector<unsigned char>> _filledPages;
 
     friend class Label;
 };
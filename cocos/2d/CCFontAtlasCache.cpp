@@ -32,12 +32,36 @@
 #include "2d/CCFontCharMap.h"
 #include "2d/CCLabel.h"
 #include "platform/CCFileUtils.h"
+#include "base/ccUTF8.h"
 
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+float FontAtlasCache::_distanceFieldFontSize = 0.0f;
+std::unordered_map<std::string, FontAtlasCache::PersistentAtlas> FontAtlasCache::_persistentAtlases;
+bool FontAtlasCache::_atlasPersistenceEnabled = false;
 #define ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE 255
 
+namespace {
+    const char* PersistentAtlasFolder = "fontatlas/";
+
+    std::string getPersistentAtlasPath(const std::string& fontFilename, FontFreeType* font, float fontSize, int outlineSize, bool distanceField)
+    {
+        // hashing a font file takes a while with CJK fonts, do it once per file
+        static std::unordered_map<std::string, unsigned int> fontDataHashes;
+        auto it = fontDataHashes.find(fontFilename);
+        if (it == fontDataHashes.end())
+        {
+            it = fontDataHashes.emplace(fontFilename, font->getFontDataHash()).first;
+        }
+
+        char fileName[ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE];
+        snprintf(fileName, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, "%08x_%s%.2f_%d_%.2f.atlas", it->second,
+                 distanceField ? "df_" : "", fontSize, outlineSize, CC_CONTENT_SCALE_FACTOR());
+        return FileUtils::getInstance()->getWritablePath() + PersistentAtlasFolder + fileName;
+    }
+}
+
 void FontAtlasCache::purgeCachedData()
 {
     auto atlasMapCopy = _atlasMap;
@@ -55,14 +79,26 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 {
     auto realFontFilename = FileUtils::getInstance()->getNewFilename(config->fontFilePath);  // resolves real file path, to prevent storing multiple atlases for the same file.
     bool useDistanceField = config->distanceFieldEnabled;
-    if(config->outlineSize > 0)
-    {
-        useDistanceField = false;
-    }
+    float fontSize = config->fontSize;
+    int outlineSize = config->outlineSize;
 
     std::string key;
     char keyPrefix[ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE];
-    snprintf(keyPrefix, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, useDistanceField ? "df %.2f %d " : "%.2f %d ", config->fontSize, config->outlineSize);
+    if (useDistanceField && _distanceFieldFontSize > 0)
+    {
+        // shared atlas: size and outline are applied by the label when drawing
+        fontSize = _distanceFieldFontSize;
+        outlineSize = 0;
+        snprintf(keyPrefix, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, "sdf %.2f ", fontSize);
+    }
+    else
+    {
+        if (outlineSize > 0)
+        {
+            useDistanceField = false;
+        }
+        snprintf(keyPrefix, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, useDistanceField ? "df %.2f %d " : "%.2f %d ", fontSize, outlineSize);
+    }
     std::string atlasName(keyPrefix);
     atlasName += realFontFilename;
 
@@ -70,13 +106,23 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 
     if ( it == _atlasMap.end() )
     {
-        auto font = FontFreeType::create(realFontFilename, config->fontSize, config->glyphs,
-            config->customGlyphs, useDistanceField, (float)config->outlineSize);
+        auto font = FontFreeType::create(realFontFilename, fontSize, config->glyphs,
+            config->customGlyphs, useDistanceField, (float)outlineSize);
         if (font)
         {
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
+                if (_atlasPersistenceEnabled)
+                {
+                    auto filePath = getPersistentAtlasPath(realFontFilename, font, fontSize, outlineSize, useDistanceField);
+                    tempAtlas->setPageDataRetained(true);
+                    if (FileUtils::getInstance()->isFileExist(filePath) && !tempAtlas->loadFromFile(filePath))
+                    {
+                        CCLOG("cocos2d: FontAtlasCache: ignoring outdated atlas file %s", filePath.c_str());
+                    }
+                    _persistentAtlases[atlasName] = {filePath, tempAtlas->getLetterGeneration()};
+                }
                 _atlasMap[atlasName] = tempAtlas;
                 return _atlasMap[atlasName];
             }
@@ -88,6 +134,55 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
     return nullptr;
 }
 
+FontAtlas* FontAtlasCache::prewarmFontAtlasTTF(const _ttfConfig* config, const std::string& text, const std::function<void(FontAtlas*)>& callback)
+{
+    auto atlas = getFontAtlasTTF(config);
+    std::u32string utf32Text;
+    if (atlas == nullptr || !StringUtils::UTF8ToUTF32(text, utf32Text))
+    {
+        if (callback)
+            callback(atlas);
+        return atlas;
+    }
+
+    if (callback)
+        atlas->prewarmLetterDefinitions(utf32Text, [atlas, callback]() { callback(atlas); });
+    else
+        atlas->prewarmLetterDefinitions(utf32Text);
+    return atlas;
+}
+
+void FontAtlasCache::saveFontAtlases()
+{
+    if (!_atlasPersistenceEnabled)
+        return;
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string folder = fileUtils->getWritablePath() + PersistentAtlasFolder;
+    if (!fileUtils->isDirectoryExist(folder) && !fileUtils->createDirectory(folder))
+    {
+        CCLOG("cocos2d: FontAtlasCache: can't create %s", folder.c_str());
+        return;
+    }
+
+    for (auto it = _persistentAtlases.begin(); it != _persistentAtlases.end(); )
+    {
+        auto atlasIt = _atlasMap.find(it->first);
+        if (atlasIt == _atlasMap.end())
+        {
+            it = _persistentAtlases.erase(it);
+            continue;
+        }
+
+        auto atlas = atlasIt->second;
+        if (atlas->getLetterGeneration() != it->second.savedLetterGeneration && atlas->saveToFile(it->second.filePath))
+        {
+            it->second.savedLetterGeneration = atlas->getLetterGeneration();
+        }
+        ++it;
+    }
+}
+
 FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName)
 {
     return getFontAtlasFNT(fontFileName, Rect::ZERO, false);
@@ -286,6 +381,11 @@ void FontAtlasCache::reloadFontAtlasFNT(const std::string& fontFileName, const V
     reloadFontAtlasFNT(fontFileName, Rect(imageOffset.x, imageOffset.y, 0, 0), false);
 }
 
+void FontAtlasCache::setDistanceFieldFontSize(float fontSize)
+{
+    _distanceFieldFontSize = fontSize > 0 ? fontSize : 0.0f;
+}
+
 void FontAtlasCache::unloadFontAtlasTTF(const std::string& fontFileName)
 {
     auto item = _atlasMap.begin();
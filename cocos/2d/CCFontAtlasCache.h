@@ -29,6 +29,8 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <functional>
+#include <string>
 #include <unordered_map>
 #include "base/ccTypes.h"
 
@@ -43,6 +45,26 @@ class CC_DLL FontAtlasCache
 public:
     static FontAtlas* getFontAtlasTTF(const _ttfConfig* config);
 
+    /** Rasterizes the letters of a text into the atlas of a TTF config before labels show them,
+     see FontAtlas::prewarmLetterDefinitions(). The atlas stays in the cache like the ones used by labels.
+     @param callback Called on the main thread once the letters are in the atlas, or with nullptr if the font can't be loaded.
+     */
+    static FontAtlas* prewarmFontAtlasTTF(const _ttfConfig* config, const std::string& text, const std::function<void(FontAtlas*)>& callback = nullptr);
+
+    /** When enabled, TTF atlases are filled from the files written by saveFontAtlases() as they are created,
+     so letters shown by a previous run aren't rasterized again.
+     The files are kept in the "fontatlas" folder of the writable path, named after a hash of the font file,
+     the font size, the outline size, the distance field setting and the content scale factor.
+     Atlases created before enabling it aren't saved. Disabled by default.
+     */
+    static void setAtlasPersistenceEnabled(bool enabled) { _atlasPersistenceEnabled = enabled; }
+    static bool isAtlasPersistenceEnabled() { return _atlasPersistenceEnabled; }
+
+    /** Writes the TTF atlases which got letters since they were loaded or last saved, when persistence is enabled.
+     Call it when the application goes to the background or quits.
+     */
+    static void saveFontAtlases();
+
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName);
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName, const std::string& subTextureKey);
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName, const Rect& imageRect, bool imageRotated);
@@ -73,8 +95,27 @@ public:
     */
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
+    /** Sets the reference size that distance field TTF atlases are generated at.
+     When greater than 0, every distance field TTFConfig of a typeface shares a single atlas
+     rendered at this size, and labels scale the glyphs to their own font size. Outlines are
+     then drawn by the shader instead of baking a separate stroked atlas per outline size.
+     The default is 0, which keeps one atlas per font size.
+     */
+    static void setDistanceFieldFontSize(float fontSize);
+    static float getDistanceFieldFontSize() { return _distanceFieldFontSize; }
+
 private:
+    struct PersistentAtlas
+    {
+        std::string filePath;
+        unsigned int savedLetterGeneration;
+    };
+
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static float _distanceFieldFontSize;
+    // keyed by atlas name
+    static std::unordered_map<std::string, PersistentAtlas> _persistentAtlases;
+    static bool _atlasPersistenceEnabled;
 };
 
 NS_CC_END
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash.h"
 
 NS_CC_BEGIN
 
@@ -102,6 +103,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
 : _fontRef(nullptr)
 , _stroker(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
+, _fontSize(0.0f)
 , _distanceFieldEnabled(distanceFieldEnabled)
 , _outlineSize(0.0f)
 , _lineHeight(0)
@@ -125,6 +127,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     FT_Face face;
     // save font name locally
     _fontName = fontName;
+    _fontSize = fontSize;
 
     auto it = s_cacheFontData.find(fontName);
     if (it != s_cacheFontData.end())
@@ -208,6 +211,28 @@ FontFreeType::~FontFreeType()
     }
 }
 
+unsigned int FontFreeType::getFontDataHash() const
+{
+    auto iter = s_cacheFontData.find(_fontName);
+    if (iter == s_cacheFontData.end() || iter->second.data.isNull())
+    {
+        return 0;
+    }
+    return XXH32(iter->second.data.getBytes(), static_cast<int>(iter->second.data.getSize()), 0);
+}
+
+FontFreeType* FontFreeType::cloneForRasterization() const
+{
+    // the outline size was scaled by the content scale factor already
+    auto font = new (std::nothrow) FontFreeType(_distanceFieldEnabled, _outlineSize / CC_CONTENT_SCALE_FACTOR());
+    if (font && !font->createFontObject(_fontName, _fontSize))
+    {
+        delete font;
+        font = nullptr;
+    }
+    return font;
+}
+
 FontAtlas * FontFreeType::createFontAtlas()
 {
     if (_fontAtlas == nullptr)
@@ -543,6 +568,11 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 }
 
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+{
+    renderCharAt(dest, posX, posY, bitmap, bitmapWidth, bitmapHeight, FontAtlas::CacheTextureWidth);
+}
+
+void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight, int destWidth)
 {
     int iX = posX;
     int iY = posY;
@@ -568,7 +598,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output 
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -588,9 +618,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -611,7 +641,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -53,7 +53,10 @@ public:
 
     float getOutlineSize() const { return _outlineSize; }
 
+    float getFontSize() const { return _fontSize; }
+
     void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight); 
+    void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight, int destWidth);
 
     FT_Encoding getEncoding() const { return _encoding; }
 
@@ -70,6 +73,14 @@ public:
 
     static void releaseFont(const std::string &fontName);
 
+    /** Creates another instance of this font with a face of its own, so glyphs can be rendered
+     * on another thread. Must be created and released on the main thread.
+     */
+    FontFreeType* cloneForRasterization() const;
+
+    /** Returns a hash of the content of the font file, 0 if it isn't loaded. */
+    unsigned int getFontDataHash() const;
+
 private:
     static const char* _glyphASCII;
     static const char* _glyphNEHE;
@@ -95,6 +106,7 @@ private:
     FT_Encoding _encoding;
 
     std::string _fontName;
+    float _fontSize;
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
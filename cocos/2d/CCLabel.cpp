@@ -26,10 +26,12 @@
 
 #include "2d/CCLabel.h"
 #include <algorithm>
+#include <limits>
 #include <stddef.h> // offsetof
 #include "base/ccTypes.h"
 #include "2d/CCFont.h"
 #include "2d/CCFontAtlasCache.h"
+#include "2d/CCLabelLayoutCache.h"
 #include "2d/CCFontAtlas.h"
 #include "2d/CCSprite.h"
 #include "2d/CCSpriteBatchNode.h"
@@ -46,6 +48,7 @@
 #include "base/CCEventCustom.h"
 #include "base/ccUtils.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontFreeType.h"
 #include "renderer/ccShaders.h"
 #include "renderer/backend/ProgramState.h"
 
@@ -485,6 +488,7 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
             }
             _batchNodes.clear();
             _batchCommands.clear();
+            _relayoutFromIndex = 0;
 
             if (_fontAtlas)
             {
@@ -542,6 +546,8 @@ void Label::reset()
     _batchNodes.clear();
     _batchCommands.clear();
     _lettersInfo.clear();
+    _linesStart.clear();
+    _relayoutFromIndex = 0;
     if (_fontAtlas)
     {
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
@@ -551,6 +557,8 @@ void Label::reset()
     _currentLabelType = LabelType::STRING_TEXTURE;
     _currLabelEffect = LabelEffect::NORMAL;
     _contentDirty = false;
+    _lettersPending = false;
+    _fontAtlasLetterGeneration = 0;
     _numberOfLines = 0;
     _lengthOfString = 0;
     _utf32Text.clear();
@@ -714,6 +722,11 @@ void Label::updateShaderProgram()
                 }
                 break;
             case cocos2d::LabelEffect::OUTLINE:
+                if (_useDistanceField)
+                {
+                    programType = backend::ProgramType::LABEL_DISTANCEFIELD_OUTLINE;
+                }
+                else
                 {
                     programType = backend::ProgramType::LABLE_OUTLINE;
                 }
@@ -774,6 +787,7 @@ void Label::updateUniformLocations()
     _textColorLocation      = _programState->getUniformLocation(backend::Uniform::TEXT_COLOR);
     _effectColorLocation    = _programState->getUniformLocation(backend::Uniform::EFFECT_COLOR);
     _effectTypeLocation     = _programState->getUniformLocation(backend::Uniform::EFFECT_TYPE);
+    _outlineWidthLocation   = _programState->getUniformLocation("u_outlineWidth");
 }
 
 void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false */, bool useA8Shader /* = false */)
@@ -808,6 +822,7 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
         _contentDirty = true;
         _systemFontDirty = false;
     }
+    _relayoutFromIndex = 0;
     _useDistanceField = distanceFieldEnabled;
     _useA8Shader = useA8Shader;
 
@@ -935,6 +950,14 @@ void Label::setString(const std::string& text)
         std::u32string utf32String;
         if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
         {
+            // only the letters after the common prefix need to be laid out again
+            auto length = std::min(utf32String.length(), _utf32Text.length());
+            int firstChange = 0;
+            while (firstChange < static_cast<int>(length) && utf32String[firstChange] == _utf32Text[firstChange])
+            {
+                ++firstChange;
+            }
+            _relayoutFromIndex = std::min(_relayoutFromIndex, firstChange);
             _utf32Text  = utf32String;
         }
     }
@@ -1068,12 +1091,15 @@ bool Label::alignText()
     if (_fontAtlas == nullptr || _utf32Text.empty())
     {
         setContentSize(Size::ZERO);
+        _relayoutFromIndex = 0;
         return true;
     }
 
     bool ret = true;
     do {
         _fontAtlas->prepareLetterDefinitions(_utf32Text);
+        _lettersPending = _fontAtlas->hasPendingLetters();
+        _fontAtlasLetterGeneration = _fontAtlas->getLetterGeneration();
         auto& textures = _fontAtlas->getTextures();
         auto size = textures.size();
         if (size > static_cast<size_t>(_batchNodes.size()))
@@ -1093,6 +1119,7 @@ bool Label::alignText()
         }
         if (_batchNodes.empty())
         {
+            _relayoutFromIndex = 0;
             return true;
         }
         // optimize for one-texture-only scenario
@@ -1103,19 +1130,68 @@ bool Label::alignText()
 
         _reusedLetter->setBatchNode(_batchNodes.at(0));
         
+        // keep the lines above the first changed letter when nothing else affecting the layout changed
+        auto layoutInputs = getLayoutInputs();
+        bool layoutReusable = _relayoutFromIndex > 0 && _horizontalKernings && layoutInputs == _layoutInputs;
+        int startLine = 0;
+        if (_overflow != Overflow::SHRINK && layoutReusable)
+        {
+            startLine = getRelayoutStartLine();
+        }
+
+        // nothing to keep, another label may have laid out the same text already
+        bool cacheable = startLine == 0 && _overflow != Overflow::SHRINK && !_lettersPending;
+        if (cacheable && restoreCachedLayout(layoutInputs))
+        {
+            _layoutInputs = layoutInputs;
+            _relayoutFromIndex = std::numeric_limits<int>::max();
+            updateLabelLetters();
+            updateColor();
+            break;
+        }
+
+        // kernings only change from the first changed letter on
+        if (!layoutReusable)
+        {
+            computeHorizontalKernings(_utf32Text);
+        }
+        else if (_relayoutFromIndex < static_cast<int>(_utf32Text.length()))
+        {
+            computeHorizontalKernings(_utf32Text, _relayoutFromIndex);
+        }
+        std::vector<float> linesOffsetX(_linesOffsetX.begin(), _linesOffsetX.begin() + std::min(static_cast<size_t>(startLine), _linesOffsetX.size()));
+        float letterOffsetY = _letterOffsetY;
+        float tailoredTopY = _tailoredTopY;
+        float tailoredBottomY = _tailoredBottomY;
+        Size contentSize = _contentSize;
+
         _lengthOfString = 0;
         _textDesiredHeight = 0.f;
-        _linesWidth.clear();
+        _linesWidth.resize(startLine);
         if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
         {
-            multilineTextWrapByWord();
+            multilineTextWrapByWord(startLine);
         }
         else
         {
-            multilineTextWrapByChar();
+            multilineTextWrapByChar(startLine);
         }
         computeAlignmentOffset();
 
+        _layoutInputs = layoutInputs;
+        _relayoutFromIndex = std::numeric_limits<int>::max();
+
+        std::vector<int> keptQuads(_batchNodes.size(), 0);
+        int firstLetter = 0;
+        if (startLine > 0 && reuseLetterQuads(startLine, linesOffsetX, letterOffsetY, tailoredTopY, tailoredBottomY, contentSize, keptQuads))
+        {
+            firstLetter = _linesStart[startLine].letterIndex;
+        }
+        else
+        {
+            std::fill(keptQuads.begin(), keptQuads.end(), 0);
+        }
+
         if(_overflow == Overflow::SHRINK){
             float fontSize = this->getRenderingFontSize();
 
@@ -1124,17 +1200,26 @@ bool Label::alignText()
             }
         }
 
-        if(!updateQuads()){
+        if(!updateQuads(firstLetter, keptQuads)){
             ret = false;
+            _relayoutFromIndex = 0;
             if(_overflow == Overflow::SHRINK){
                 this->shrinkLabelToContentSize(CC_CALLBACK_0(Label::isHorizontalClamp, this));
             }
             break;
         }
     
+        if (cacheable)
+        {
+            addCachedLayout(layoutInputs);
+        }
+
         updateLabelLetters();
         
-        updateColor();
+        for (ssize_t index = 0; index < _batchNodes.size(); ++index)
+        {
+            updateQuadsColor(index, keptQuads[index]);
+        }
     }while (0);
 
     return ret;
@@ -1157,6 +1242,244 @@ bool Label::computeHorizontalKernings(const std::u32string& stringToRender)
         return true;
 }
 
+bool Label::computeHorizontalKernings(const std::u32string& stringToRender, int fromIndex)
+{
+    if (fromIndex <= 0 || !_horizontalKernings)
+    {
+        return computeHorizontalKernings(stringToRender);
+    }
+
+    // the kerning of a letter depends on the letter before it, so start one letter early
+    int letterCount = 0;
+    int* tailKernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF32(stringToRender.substr(fromIndex - 1), letterCount);
+    if (!tailKernings)
+    {
+        return computeHorizontalKernings(stringToRender);
+    }
+
+    auto length = stringToRender.length();
+    auto kernings = new (std::nothrow) int[length];
+    if (!kernings)
+    {
+        delete [] tailKernings;
+        return computeHorizontalKernings(stringToRender);
+    }
+    memcpy(kernings, _horizontalKernings, fromIndex * sizeof(int));
+    memcpy(kernings + fromIndex, tailKernings + 1, (length - fromIndex) * sizeof(int));
+    delete [] tailKernings;
+    delete [] _horizontalKernings;
+    _horizontalKernings = kernings;
+
+    return true;
+}
+
+bool Label::restoreCachedLayout(const LayoutInputs& inputs)
+{
+    auto layout = LabelLayoutCache::getLayout(_utf32Text, inputs);
+    if (!layout || layout->quads.size() > static_cast<size_t>(_batchNodes.size()))
+    {
+        return false;
+    }
+
+    getStringLength();
+    _lettersInfo = layout->letters;
+    _linesWidth = layout->linesWidth;
+    _linesOffsetX = layout->linesOffsetX;
+    _linesStart = layout->linesStart;
+    _numberOfLines = layout->numberOfLines;
+    _textDesiredHeight = layout->textDesiredHeight;
+    _letterOffsetY = layout->letterOffsetY;
+    _tailoredTopY = layout->tailoredTopY;
+    _tailoredBottomY = layout->tailoredBottomY;
+    _bmfontScale = layout->bmfontScale;
+    setContentSize(layout->contentSize);
+
+    delete [] _horizontalKernings;
+    _horizontalKernings = new (std::nothrow) int[layout->kernings.size()];
+    if (_horizontalKernings)
+    {
+        std::copy(layout->kernings.begin(), layout->kernings.end(), _horizontalKernings);
+    }
+
+    for (ssize_t index = 0; index < _batchNodes.size(); ++index)
+    {
+        auto textureAtlas = _batchNodes.at(index)->getTextureAtlas();
+        textureAtlas->removeAllQuads();
+        if (static_cast<size_t>(index) >= layout->quads.size() || layout->quads[index].empty())
+            continue;
+
+        auto& quads = layout->quads[index];
+        auto amount = static_cast<ssize_t>(quads.size());
+        if (static_cast<ssize_t>(textureAtlas->getCapacity()) < amount)
+        {
+            textureAtlas->resizeCapacity(amount);
+        }
+        textureAtlas->insertQuads(const_cast<V3F_C4B_T2F_Quad*>(quads.data()), 0, amount);
+    }
+
+    return true;
+}
+
+void Label::addCachedLayout(const LayoutInputs& inputs)
+{
+    if (LabelLayoutCache::getCapacity() == 0 || _utf32Text.length() > LabelLayoutCache::getMaxTextLength())
+    {
+        return;
+    }
+
+    LabelLayoutCache::Layout layout;
+    layout.letters.assign(_lettersInfo.begin(), _lettersInfo.begin() + _lengthOfString);
+    if (_horizontalKernings)
+    {
+        layout.kernings.assign(_horizontalKernings, _horizontalKernings + _lengthOfString);
+    }
+    layout.linesWidth = _linesWidth;
+    layout.linesOffsetX = _linesOffsetX;
+    layout.linesStart = _linesStart;
+    layout.numberOfLines = _numberOfLines;
+    layout.textDesiredHeight = _textDesiredHeight;
+    layout.letterOffsetY = _letterOffsetY;
+    layout.tailoredTopY = _tailoredTopY;
+    layout.tailoredBottomY = _tailoredBottomY;
+    layout.bmfontScale = _bmfontScale;
+    layout.contentSize = _contentSize;
+    for (auto&& batchNode : _batchNodes)
+    {
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto quads = textureAtlas->getQuads();
+        layout.quads.emplace_back(quads, quads + textureAtlas->getTotalQuads());
+    }
+
+    LabelLayoutCache::addLayout(_utf32Text, inputs, std::move(layout));
+}
+
+bool Label::LayoutInputs::operator==(const LayoutInputs& other) const
+{
+    return fontAtlas == other.fontAtlas
+        && fontSize == other.fontSize
+        && lineHeight == other.lineHeight
+        && lineSpacing == other.lineSpacing
+        && additionalKerning == other.additionalKerning
+        && maxLineWidth == other.maxLineWidth
+        && labelWidth == other.labelWidth
+        && labelHeight == other.labelHeight
+        && contentScaleFactor == other.contentScaleFactor
+        && hAlignment == other.hAlignment
+        && vAlignment == other.vAlignment
+        && overflow == other.overflow
+        && enableWrap == other.enableWrap
+        && lineBreakWithoutSpaces == other.lineBreakWithoutSpaces;
+}
+
+Label::LayoutInputs Label::getLayoutInputs() const
+{
+    LayoutInputs inputs;
+    inputs.fontAtlas = _fontAtlas;
+    inputs.fontSize = getRenderingFontSize();
+    inputs.lineHeight = _lineHeight;
+    inputs.lineSpacing = _lineSpacing;
+    inputs.additionalKerning = _additionalKerning;
+    inputs.maxLineWidth = _maxLineWidth;
+    inputs.labelWidth = _labelWidth;
+    inputs.labelHeight = _labelHeight;
+    inputs.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    inputs.hAlignment = _hAlignment;
+    inputs.vAlignment = _vAlignment;
+    inputs.overflow = _overflow;
+    inputs.enableWrap = _enableWrap;
+    inputs.lineBreakWithoutSpaces = _lineBreakWithoutSpaces;
+    return inputs;
+}
+
+int Label::getRelayoutStartLine() const
+{
+    if (_linesStart.empty())
+    {
+        return 0;
+    }
+
+    // line holding the first changed letter
+    auto it = std::upper_bound(_linesStart.begin(), _linesStart.end(), _relayoutFromIndex,
+        [](int letterIndex, const LineStart& lineStart) { return letterIndex < lineStart.letterIndex; });
+    int line = static_cast<int>(it - _linesStart.begin()) - 1;
+
+    // a shorter first word may now fit at the end of the previous line, and the kerning
+    // of the letter before the change may differ, so wrap again from the line above
+    return std::max(line - 1, 0);
+}
+
+bool Label::reuseLetterQuads(int startLine, const std::vector<float>& linesOffsetX, float letterOffsetY,
+                             float tailoredTopY, float tailoredBottomY, const Size& contentSize, std::vector<int>& keptQuads)
+{
+    if (startLine >= static_cast<int>(_linesStart.size()) || static_cast<int>(linesOffsetX.size()) < startLine
+        || static_cast<int>(_linesOffsetX.size()) < startLine)
+    {
+        return false;
+    }
+
+    // clamping and tailoring depend on the label bounds, only unclamped axes may shift
+    float offsetY = _letterOffsetY - letterOffsetY;
+    if (offsetY != 0.f && _labelHeight > 0.f)
+        return false;
+    if (_labelHeight > 0.f && (tailoredTopY != _tailoredTopY || tailoredBottomY != _tailoredBottomY))
+        return false;
+    if (_labelWidth > 0.f && !contentSize.equals(_contentSize))
+        return false;
+
+    bool shifted = offsetY != 0.f;
+    for (int line = 0; line < startLine; ++line)
+    {
+        if (linesOffsetX[line] != _linesOffsetX[line])
+        {
+            if (_labelWidth > 0.f)
+                return false;
+            shifted = true;
+        }
+    }
+
+    int firstLetter = _linesStart[startLine].letterIndex;
+    size_t pagesFound = 0;
+    for (int ctr = firstLetter - 1; ctr >= 0; --ctr)
+    {
+        auto& letterInfo = _lettersInfo[ctr];
+        if (!letterInfo.valid || letterInfo.atlasIndex < 0)
+            continue;
+
+        auto textureID = _fontAtlas->_letterDefinitions[letterInfo.utf32Char].textureID;
+        if (textureID < 0 || static_cast<size_t>(textureID) >= keptQuads.size())
+            return false;
+
+        if (shifted)
+        {
+            float offsetX = _linesOffsetX[letterInfo.lineIndex] - linesOffsetX[letterInfo.lineIndex];
+            auto textureAtlas = _batchNodes.at(textureID)->getTextureAtlas();
+            if (letterInfo.atlasIndex >= static_cast<int>(textureAtlas->getTotalQuads()))
+                return false;
+
+            auto& quad = textureAtlas->getQuads()[letterInfo.atlasIndex];
+            quad.bl.vertices.x += offsetX;
+            quad.br.vertices.x += offsetX;
+            quad.tl.vertices.x += offsetX;
+            quad.tr.vertices.x += offsetX;
+            quad.bl.vertices.y += offsetY;
+            quad.br.vertices.y += offsetY;
+            quad.tl.vertices.y += offsetY;
+            quad.tr.vertices.y += offsetY;
+            textureAtlas->setDirty(true);
+        }
+
+        if (keptQuads[textureID] == 0)
+        {
+            keptQuads[textureID] = letterInfo.atlasIndex + 1;
+            // without shifting, the last quad of every page is all that is needed
+            if (++pagesFound == keptQuads.size() && !shifted)
+                break;
+        }
+    }
+
+    return true;
+}
+
 bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
 {
     auto wordWidth = this->_linesWidth[lineIndex];
@@ -1169,14 +1492,29 @@ bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
 }
 
 bool Label::updateQuads()
+{
+    return updateQuads(0, std::vector<int>());
+}
+
+bool Label::updateQuads(int firstLetter, const std::vector<int>& keptQuads)
 {
     bool ret = true;
-    for (auto&& batchNode : _batchNodes)
+    for (ssize_t index = 0; index < _batchNodes.size(); ++index)
     {
-        batchNode->getTextureAtlas()->removeAllQuads();
+        auto textureAtlas = _batchNodes.at(index)->getTextureAtlas();
+        auto kept = static_cast<size_t>(index) < keptQuads.size() ? keptQuads[index] : 0;
+        auto totalQuads = static_cast<int>(textureAtlas->getTotalQuads());
+        if (kept <= 0)
+        {
+            textureAtlas->removeAllQuads();
+        }
+        else if (totalQuads > kept)
+        {
+            textureAtlas->removeQuadsAtIndex(kept, totalQuads - kept);
+        }
     }
     
-    for (int ctr = 0; ctr < _lengthOfString; ++ctr)
+    for (int ctr = firstLetter; ctr < _lengthOfString; ++ctr)
     {
         if (_lettersInfo[ctr].valid)
         {
@@ -1256,7 +1594,19 @@ bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
 
     _fontConfig = ttfConfig;
 
-    if (_fontConfig.outlineSize > 0)
+    bool sharedDistanceField = ttfConfig.distanceFieldEnabled && FontAtlasCache::getDistanceFieldFontSize() > 0;
+    if (sharedDistanceField)
+    {
+        // the atlas may be unchanged while the font size is not
+        _contentDirty = true;
+    }
+
+    if (_fontConfig.outlineSize > 0 && sharedDistanceField)
+    {
+        _currLabelEffect = LabelEffect::OUTLINE;
+        updateShaderProgram();
+    }
+    else if (_fontConfig.outlineSize > 0)
     {
         _fontConfig.distanceFieldEnabled = false;
         _useDistanceField = false;
@@ -1635,13 +1985,7 @@ void Label::updateContent()
 
     if (_fontAtlas)
     {
-        std::u32string utf32String;
-        if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
-        {
-            _utf32Text = utf32String;
-        }
-
-        computeHorizontalKernings(_utf32Text);
+        // _utf32Text is kept in sync by setString(), kernings are computed by alignText()
         updateFinished = alignText();
     }
     else
@@ -1654,44 +1998,7 @@ void Label::updateContent()
         }
     }
 
-    if (_underlineNode)
-    {
-        _underlineNode->clear();
-
-        if (_numberOfLines)
-        {
-            // This is the logic for TTF fonts
-            const float charheight = (_textDesiredHeight / _numberOfLines);
-            _underlineNode->setLineWidth(charheight/6);
-
-            // atlas font
-            for (int i=0; i<_numberOfLines; ++i)
-            {
-                float offsety = 0;
-                if (_strikethroughEnabled)
-                    offsety += charheight / 2;
-                // FIXME: Might not work with different vertical alignments
-                float y = (_numberOfLines - i - 1) * charheight + offsety;
-
-                // Github issue #15214. Uses _displayedColor instead of _textColor for the underline.
-                // This is to have the same behavior of SystemFonts.
-                _underlineNode->drawLine(Vec2(_linesOffsetX[i],y), Vec2(_linesWidth[i] + _linesOffsetX[i],y), Color4F(_displayedColor));
-            }
-        }
-        else if (_textSprite)
-        {
-            // ...and is the logic for System fonts
-            float y = 0;
-            const auto spriteSize = _textSprite->getContentSize();
-            _underlineNode->setLineWidth(spriteSize.height/6);
-
-            if (_strikethroughEnabled)
-                // FIXME: system fonts don't report the height of the font correctly. only the size of the texture, which is POT
-                y += spriteSize.height / 2;
-            // FIXME: Might not work with different vertical alignments
-            _underlineNode->drawLine(Vec2(0.0f,y), Vec2(spriteSize.width,y), Color4F(_textSprite->getDisplayedColor()));
-        }
-    }
+    updateUnderline();
 
     if(updateFinished){
         _contentDirty = false;
@@ -1710,6 +2017,50 @@ void Label::updateContent()
 #endif
 }
 
+void Label::updateUnderline()
+{
+    if (!_underlineNode)
+    {
+        return;
+    }
+
+    _underlineNode->clear();
+
+    if (_numberOfLines)
+    {
+        // This is the logic for TTF fonts
+        const float charheight = (_textDesiredHeight / _numberOfLines);
+        _underlineNode->setLineWidth(charheight/6);
+
+        // atlas font
+        for (int i=0; i<_numberOfLines; ++i)
+        {
+            float offsety = 0;
+            if (_strikethroughEnabled)
+                offsety += charheight / 2;
+            // FIXME: Might not work with different vertical alignments
+            float y = (_numberOfLines - i - 1) * charheight + offsety;
+
+            // Github issue #15214. Uses _displayedColor instead of _textColor for the underline.
+            // This is to have the same behavior of SystemFonts.
+            _underlineNode->drawLine(Vec2(_linesOffsetX[i],y), Vec2(_linesWidth[i] + _linesOffsetX[i],y), Color4F(_displayedColor));
+        }
+    }
+    else if (_textSprite)
+    {
+        // ...and is the logic for System fonts
+        float y = 0;
+        const auto spriteSize = _textSprite->getContentSize();
+        _underlineNode->setLineWidth(spriteSize.height/6);
+
+        if (_strikethroughEnabled)
+            // FIXME: system fonts don't report the height of the font correctly. only the size of the texture, which is POT
+            y += spriteSize.height / 2;
+        // FIXME: Might not work with different vertical alignments
+        _underlineNode->drawLine(Vec2(0.0f,y), Vec2(spriteSize.width,y), Color4F(_textSprite->getDisplayedColor()));
+    }
+}
+
 void Label::setBMFontSize(float fontSize)
 {
     this->setBMFontSizeInternal(fontSize);
@@ -1753,6 +2104,14 @@ void Label::updateEffectUniforms(BatchCommand &batch, TextureAtlas* textureAtlas
                 int effectType = 0;
                 Vec4 effectColor(_effectColorF.r, _effectColorF.g, _effectColorF.b, _effectColorF.a);
                 
+                // outline thickness in distance field units, the atlas stores 16/255 per texel
+                float outlineWidth = 0.f;
+                if (_useDistanceField)
+                {
+                    outlineWidth = _fontConfig.outlineSize * CC_CONTENT_SCALE_FACTOR() / _bmfontScale * 16.f / 255.f;
+                    outlineWidth = std::min(outlineWidth, FontFreeType::DistanceMapSpread * 16.f / 255.f);
+                }
+
                 //draw shadow
                 if(_shadowEnabled)
                 {
@@ -1761,6 +2120,8 @@ void Label::updateEffectUniforms(BatchCommand &batch, TextureAtlas* textureAtlas
                     auto *programStateShadow = batch.shadowCommand.getPipelineDescriptor().programState;
                     programStateShadow->setUniform(_effectColorLocation, &shadowColor, sizeof(Vec4));
                     programStateShadow->setUniform(_effectTypeLocation, &effectType, sizeof(effectType));
+                    if (_useDistanceField)
+                        programStateShadow->setUniform(_outlineWidthLocation, &outlineWidth, sizeof(outlineWidth));
                     batch.shadowCommand.init(_globalZOrder);
                     renderer->addCommand(&batch.shadowCommand);
                 }
@@ -1772,6 +2133,8 @@ void Label::updateEffectUniforms(BatchCommand &batch, TextureAtlas* textureAtlas
                     auto *programStateOutline = batch.outLineCommand.getPipelineDescriptor().programState;
                     programStateOutline->setUniform(_effectColorLocation, &effectColor, sizeof(Vec4));
                     programStateOutline->setUniform(_effectTypeLocation, &effectType, sizeof(effectType));
+                    if (_useDistanceField)
+                        programStateOutline->setUniform(_outlineWidthLocation, &outlineWidth, sizeof(outlineWidth));
                     batch.outLineCommand.init(_globalZOrder);
                     renderer->addCommand(&batch.outLineCommand);
                 }
@@ -1953,6 +2316,13 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         return;
     }
     
+    // relayout once the letters rasterized in the background are in the atlas
+    if (_lettersPending && _fontAtlas && _fontAtlas->getLetterGeneration() != _fontAtlasLetterGeneration)
+    {
+        _contentDirty = true;
+        _relayoutFromIndex = 0;
+    }
+
     if (_systemFontDirty || _contentDirty)
     {
         updateContent();
@@ -2243,14 +2613,12 @@ void Label::updateDisplayedColor(const Color3B& parentColor)
         _shadowNode->updateDisplayedColor(_displayedColor);
     }
 
-    if (_underlineNode)
+    if (_underlineNode && !_contentDirty)
     {
         // FIXME: _underlineNode is not a sprite/label. It is a DrawNode
         // and updating its color doesn't work. it must be re-drawn,
-        // which makes it super expensive to change update it frequently
-        // Correct solution is to update the DrawNode directly since we know it is
-        // a line. Returning a pointer to the line is an option
-        _contentDirty = true;
+        // but the letters themselves keep their layout
+        updateUnderline();
     }
 
     for (auto&& it : _letters)
@@ -2299,11 +2667,14 @@ void Label::setTextColor(const Color4B &color)
 
 void Label::updateColor()
 {
-    if (_batchNodes.empty())
+    for (ssize_t index = 0; index < _batchNodes.size(); ++index)
     {
-        return;
+        updateQuadsColor(index, 0);
     }
+}
 
+void Label::updateQuadsColor(ssize_t batchIndex, int firstQuad)
+{
     Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
 
     // special opacity for premultiplied textures
@@ -2314,22 +2685,17 @@ void Label::updateColor()
         color4.b *= _displayedOpacity/255.0f;
     }
 
-    cocos2d::TextureAtlas* textureAtlas;
-    V3F_C4B_T2F_Quad *quads;
-    for (auto&& batchNode:_batchNodes)
-    {
-        textureAtlas = batchNode->getTextureAtlas();
-        quads = textureAtlas->getQuads();
-        auto count = textureAtlas->getTotalQuads();
+    auto textureAtlas = _batchNodes.at(batchIndex)->getTextureAtlas();
+    auto quads = textureAtlas->getQuads();
+    auto count = static_cast<int>(textureAtlas->getTotalQuads());
 
-        for (int index = 0; index < count; ++index)
-        {
-            quads[index].bl.colors = color4;
-            quads[index].br.colors = color4;
-            quads[index].tl.colors = color4;
-            quads[index].tr.colors = color4;
-            textureAtlas->updateQuad(&quads[index], index);
-        }
+    for (int index = firstQuad; index < count; ++index)
+    {
+        quads[index].bl.colors = color4;
+        quads[index].br.colors = color4;
+        quads[index].tl.colors = color4;
+        quads[index].tr.colors = color4;
+        textureAtlas->updateQuad(&quads[index], index);
     }
 }
 
@@ -2526,6 +2892,10 @@ void Label::updateLetterSpriteScale(Sprite* sprite)
     {
         sprite->setScale(_bmfontScale);
     }
+    else if (_currentLabelType == LabelType::TTF && _useDistanceField)
+    {
+        sprite->setScale(_bmfontScale);
+    }
     else
     {
         if (std::abs(_bmFontSize) < FLT_EPSILON)
@@ -700,6 +700,38 @@ protected:
         int lineIndex;
     };
 
+    /// wrapping state at the first letter of a line, lets the layout resume from that line
+    struct LineStart
+    {
+        int letterIndex;
+        float positionY;
+        float highestY;
+        float lowestY;
+        float whitespaceWidth;
+        bool changeSize;
+    };
+
+    /// inputs the cached line breaks were computed with, any change forces a full relayout
+    struct LayoutInputs
+    {
+        FontAtlas* fontAtlas = nullptr;
+        float fontSize = 0.f;
+        float lineHeight = 0.f;
+        float lineSpacing = 0.f;
+        float additionalKerning = 0.f;
+        float maxLineWidth = 0.f;
+        float labelWidth = 0.f;
+        float labelHeight = 0.f;
+        float contentScaleFactor = 0.f;
+        TextHAlignment hAlignment = TextHAlignment::LEFT;
+        TextVAlignment vAlignment = TextVAlignment::TOP;
+        Overflow overflow = Overflow::NONE;
+        bool enableWrap = true;
+        bool lineBreakWithoutSpaces = false;
+
+        bool operator==(const LayoutInputs& other) const;
+    };
+
     struct BatchCommand {
         BatchCommand();
         ~BatchCommand();
@@ -718,9 +750,9 @@ protected:
 
     void drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags);
 
-    bool multilineTextWrapByChar();
-    bool multilineTextWrapByWord();
-    bool multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& lambda);
+    bool multilineTextWrapByChar(int startLine = 0);
+    bool multilineTextWrapByWord(int startLine = 0);
+    bool multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& lambda, int startLine = 0);
     void shrinkLabelToContentSize(const std::function<bool(void)>& lambda);
     bool isHorizontalClamp();
     bool isVerticalClamp();
@@ -730,11 +762,19 @@ protected:
     virtual bool alignText();
     void computeAlignmentOffset();
     bool computeHorizontalKernings(const std::u32string& stringToRender);
+    bool computeHorizontalKernings(const std::u32string& stringToRender, int fromIndex);
+    LayoutInputs getLayoutInputs() const;
+    bool restoreCachedLayout(const LayoutInputs& inputs);
+    void addCachedLayout(const LayoutInputs& inputs);
+    int getRelayoutStartLine() const;
+    bool reuseLetterQuads(int startLine, const std::vector<float>& linesOffsetX, float letterOffsetY,
+                          float tailoredTopY, float tailoredBottomY, const Size& contentSize, std::vector<int>& keptQuads);
 
     void recordLetterInfo(const cocos2d::Vec2& point, char32_t utf32Char, int letterIndex, int lineIndex);
     void recordPlaceholderInfo(int letterIndex, char32_t utf16Char);
     
     bool updateQuads();
+    bool updateQuads(int firstLetter, const std::vector<int>& keptQuads);
 
     void createSpriteForSystemFont(const FontDefinition& fontDef);
     void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
@@ -755,6 +795,8 @@ protected:
     FontDefinition _getFontDefinition() const;
 
     virtual void updateColor() override;
+    void updateUnderline();
+    void updateQuadsColor(ssize_t batchIndex, int firstQuad);
     
     void updateUniformLocations();
     void setVertexLayout(PipelineDescriptor& vertexLayout);
@@ -766,6 +808,9 @@ protected:
 
     LabelType _currentLabelType;
     bool _contentDirty;
+    /// letters of the font atlas were still being rasterized at the last layout
+    bool _lettersPending;
+    unsigned int _fontAtlasLetterGeneration;
     std::u32string _utf32Text;
     std::string _utf8Text;
     int _numberOfLines;
@@ -813,6 +858,11 @@ protected:
     float _tailoredTopY;
     float _tailoredBottomY;
 
+    /// first letter whose layout is out of date since the last alignText(), 0 forces a full relayout
+    int _relayoutFromIndex;
+    LayoutInputs _layoutInputs;
+    std::vector<LineStart> _linesStart;
+
     LabelEffect _currLabelEffect;
     Color4F _effectColorF;
     Color4B _textColor;
@@ -872,8 +922,11 @@ protected:
     backend::UniformLocation _textColorLocation;
     backend::UniformLocation _effectColorLocation;
     backend::UniformLocation _effectTypeLocation;
+    backend::UniformLocation _outlineWidthLocation;
     
 private:
+    friend class LabelLayoutCache;
+
     CC_DISALLOW_COPY_AND_ASSIGN(Label);
 };
 
@@ -0,0 +1,164 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCLabelLayoutCache.h"
+#include <functional>
+
+NS_CC_BEGIN
+
+LabelLayoutCache::EntryList LabelLayoutCache::_layouts;
+std::unordered_multimap<size_t, LabelLayoutCache::EntryList::iterator> LabelLayoutCache::_index;
+size_t LabelLayoutCache::_capacity = 256;
+size_t LabelLayoutCache::_maxTextLength = 256;
+unsigned int LabelLayoutCache::_hitCount = 0;
+unsigned int LabelLayoutCache::_missCount = 0;
+
+namespace
+{
+    template <typename T>
+    void hashCombine(size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+}
+
+void LabelLayoutCache::setCapacity(size_t capacity)
+{
+    _capacity = capacity;
+    while (_layouts.size() > _capacity)
+    {
+        removeEntry(std::prev(_layouts.end()));
+    }
+}
+
+float LabelLayoutCache::getHitRate()
+{
+    auto lookups = _hitCount + _missCount;
+    return lookups > 0 ? static_cast<float>(_hitCount) / lookups : 0.f;
+}
+
+void LabelLayoutCache::resetStatistics()
+{
+    _hitCount = 0;
+    _missCount = 0;
+}
+
+void LabelLayoutCache::purgeCachedData()
+{
+    _index.clear();
+    _layouts.clear();
+}
+
+void LabelLayoutCache::removeLayoutsForAtlas(FontAtlas* atlas)
+{
+    for (auto it = _layouts.begin(); it != _layouts.end();)
+    {
+        auto entry = it++;
+        if (entry->inputs.fontAtlas == atlas)
+        {
+            removeEntry(entry);
+        }
+    }
+}
+
+size_t LabelLayoutCache::hashKey(const std::u32string& text, const Label::LayoutInputs& inputs)
+{
+    size_t seed = std::hash<std::u32string>()(text);
+    hashCombine(seed, inputs.fontAtlas);
+    hashCombine(seed, inputs.fontSize);
+    hashCombine(seed, inputs.maxLineWidth);
+    hashCombine(seed, inputs.labelWidth);
+    hashCombine(seed, inputs.labelHeight);
+    hashCombine(seed, static_cast<int>(inputs.hAlignment));
+    hashCombine(seed, static_cast<int>(inputs.vAlignment));
+    hashCombine(seed, static_cast<int>(inputs.overflow));
+    return seed;
+}
+
+void LabelLayoutCache::removeEntry(EntryList::iterator entry)
+{
+    auto range = _index.equal_range(hashKey(entry->text, entry->inputs));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == entry)
+        {
+            _index.erase(it);
+            break;
+        }
+    }
+    _layouts.erase(entry);
+}
+
+const LabelLayoutCache::Layout* LabelLayoutCache::getLayout(const std::u32string& text, const Label::LayoutInputs& inputs)
+{
+    if (_capacity == 0 || text.length() > _maxTextLength)
+    {
+        return nullptr;
+    }
+
+    auto range = _index.equal_range(hashKey(text, inputs));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto entry = it->second;
+        if (entry->text == text && entry->inputs == inputs)
+        {
+            ++_hitCount;
+            _layouts.splice(_layouts.begin(), _layouts, entry);
+            return &entry->layout;
+        }
+    }
+
+    ++_missCount;
+    return nullptr;
+}
+
+void LabelLayoutCache::addLayout(const std::u32string& text, const Label::LayoutInputs& inputs, Layout&& layout)
+{
+    if (_capacity == 0 || text.length() > _maxTextLength)
+    {
+        return;
+    }
+
+    auto hash = hashKey(text, inputs);
+    auto range = _index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second->text == text && it->second->inputs == inputs)
+        {
+            it->second->layout = std::move(layout);
+            _layouts.splice(_layouts.begin(), _layouts, it->second);
+            return;
+        }
+    }
+
+    _layouts.push_front({text, inputs, std::move(layout)});
+    _index.emplace(hash, _layouts.begin());
+
+    while (_layouts.size() > _capacity)
+    {
+        removeEntry(std::prev(_layouts.end()));
+    }
+}
+
+NS_CC_END
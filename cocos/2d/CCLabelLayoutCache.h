@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "2d/CCLabel.h"
+
+NS_CC_BEGIN
+
+class FontAtlas;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * @brief Shares the line breaks, letter positions and quads of laid out labels.
+ *
+ * Labels showing the same string with the same font atlas, dimensions, alignment and overflow
+ * copy the layout of the first one instead of wrapping, kerning and building quads again.
+ * The least recently used layouts are dropped once the cache is full, and the layouts of a
+ * font atlas are dropped when its letters are reset.
+ */
+class CC_DLL LabelLayoutCache
+{
+public:
+    /** Sets how many layouts are kept, 0 disables the cache. The default is 256. */
+    static void setCapacity(size_t capacity);
+    static size_t getCapacity() { return _capacity; }
+
+    /** Strings with more letters than this are not cached, they are usually unique. The default is 256. */
+    static void setMaxTextLength(size_t length) { _maxTextLength = length; }
+    static size_t getMaxTextLength() { return _maxTextLength; }
+
+    /** Number of layouts found in the cache since the last resetStatistics(). */
+    static unsigned int getHitCount() { return _hitCount; }
+    /** Number of layouts that had to be computed since the last resetStatistics(). */
+    static unsigned int getMissCount() { return _missCount; }
+    /** Hits divided by lookups, 0 when nothing was looked up. */
+    static float getHitRate();
+    static void resetStatistics();
+
+    /** Number of layouts currently cached. */
+    static size_t getCachedLayoutCount() { return _layouts.size(); }
+
+    /** Removes all cached layouts. */
+    static void purgeCachedData();
+
+    /** Removes the layouts made with the letters of the atlas. */
+    static void removeLayoutsForAtlas(FontAtlas* atlas);
+
+    /// @cond DO_NOT_SHOW
+    struct Layout
+    {
+        std::vector<Label::LetterInfo> letters;
+        std::vector<int> kernings;
+        std::vector<float> linesWidth;
+        std::vector<float> linesOffsetX;
+        std::vector<Label::LineStart> linesStart;
+        /// quads of every atlas page, in the order the label inserted them
+        std::vector<std::vector<V3F_C4B_T2F_Quad>> quads;
+        int numberOfLines = 0;
+        float textDesiredHeight = 0.f;
+        float letterOffsetY = 0.f;
+        float tailoredTopY = 0.f;
+        float tailoredBottomY = 0.f;
+        float bmfontScale = 1.f;
+        Size contentSize;
+    };
+
+    /** Returns the layout of the text, or nullptr. The pointer is valid until the cache changes. */
+    static const Layout* getLayout(const std::u32string& text, const Label::LayoutInputs& inputs);
+    static void addLayout(const std::u32string& text, const Label::LayoutInputs& inputs, Layout&& layout);
+    /// @endcond
+
+private:
+    struct Entry
+    {
+        std::u32string text;
+        Label::LayoutInputs inputs;
+        Layout layout;
+    };
+    typedef std::list<Entry> EntryList;
+
+    static size_t hashKey(const std::u32string& text, const Label::LayoutInputs& inputs);
+    static void removeEntry(EntryList::iterator entry);
+
+    /// most recently used first
+    static EntryList _layouts;
+    static std::unordered_multimap<size_t, EntryList::iterator> _index;
+    static size_t _capacity;
+    static size_t _maxTextLength;
+    static unsigned int _hitCount;
+    static unsigned int _missCount;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
@@ -30,6 +30,7 @@
 #include "base/CCDirector.h"
 #include "2d/CCFontAtlas.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontFreeType.h"
 
 NS_CC_BEGIN
 
@@ -142,12 +143,16 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if (_currentLabelType == LabelType::TTF && _useDistanceField) {
+        // a shared distance field atlas may be rendered at a different size than the label
+        auto fontFreeType = static_cast<const FontFreeType*>(font);
+        _bmfontScale = _fontConfig.fontSize / fontFreeType->getFontSize();
     }else{
         _bmfontScale = 1.0f;
     }
 }
 
-bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& nextTokenLen)
+bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int, int)>& nextTokenLen, int startLine)
 {
     int textLen = getStringLength();
     int lineIndex = 0;
@@ -164,11 +169,35 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
     FontLetterDefinition letterDef;
     Vec2 letterPosition;
     bool nextChangeSize = true;
+    int index = 0;
 
     this->updateBMFontScale();
 
-    for (int index = 0; index < textLen; )
+    // resume from a line recorded by a previous wrap, the lines above it are kept
+    if (startLine > 0 && startLine < static_cast<int>(_linesStart.size()))
     {
+        auto& lineStart = _linesStart[startLine];
+        lineIndex = startLine;
+        index = lineStart.letterIndex;
+        nextTokenY = lineStart.positionY;
+        highestY = lineStart.highestY;
+        lowestY = lineStart.lowestY;
+        nextWhitespaceWidth = lineStart.whitespaceWidth;
+        nextChangeSize = lineStart.changeSize;
+    }
+    else
+    {
+        startLine = 0;
+    }
+    _linesStart.resize(startLine);
+
+    while (index < textLen)
+    {
+        if (static_cast<int>(_linesStart.size()) == lineIndex)
+        {
+            _linesStart.push_back({index, nextTokenY, highestY, lowestY, nextWhitespaceWidth, nextChangeSize});
+        }
+
         char32_t character = _utf32Text[index];
         if (character == StringUtils::UnicodeCharacters::NewLine)
         {
@@ -210,7 +239,10 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             if (!getFontLetterDef(character, letterDef))
             {
                 recordPlaceholderInfo(letterIndex, character);
-                CCLOG("LabelTextFormatter error: can't find letter definition in font file for letter: 0x%x", character);
+                if (!_fontAtlas->isLetterPending(character))
+                {
+                    CCLOG("LabelTextFormatter error: can't find letter definition in font file for letter: 0x%x", character);
+                }
                 continue;
             }
 
@@ -238,7 +270,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             {
                 float newLetterWidth = 0.f;
                 if (_horizontalKernings && letterIndex < textLen - 1)
-                    newLetterWidth = _horizontalKernings[letterIndex + 1];
+                    newLetterWidth = _horizontalKernings[letterIndex + 1] * _bmfontScale;
                 newLetterWidth += letterDef.xAdvance * _bmfontScale + _additionalKerning;
 
                 nextLetterX += newLetterWidth;
@@ -276,6 +308,11 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
         index += tokenLen;
     }
 
+    if (static_cast<int>(_linesStart.size()) == lineIndex)
+    {
+        _linesStart.push_back({textLen, nextTokenY, highestY, lowestY, nextWhitespaceWidth, nextChangeSize});
+    }
+
     if (_linesWidth.empty())
     {
         _linesWidth.push_back(letterRight);
@@ -312,14 +349,14 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
     return true;
 }
 
-bool Label::multilineTextWrapByWord()
+bool Label::multilineTextWrapByWord(int startLine)
 {
-    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this));
+    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this), startLine);
 }
 
-bool Label::multilineTextWrapByChar()
+bool Label::multilineTextWrapByChar(int startLine)
 {
-    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstCharLen, this));
+    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstCharLen, this), startLine);
 }
 
 bool Label::isVerticalClamp()
@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "2d/CCMotionStreak.h"
+#include <stddef.h> // offsetof
 #include "math/CCVertex.h"
 #include "base/CCDirector.h"
 #include "base/ccUtils.h"
@@ -38,8 +39,8 @@ NS_CC_BEGIN
 
 MotionStreak::MotionStreak()
 {
-    _customCommand.setDrawType(CustomCommand::DrawType::ARRAY);
-    _customCommand.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE_STRIP);
+    _customCommand.setDrawType(CustomCommand::DrawType::ELEMENT);
+    _customCommand.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE);
 
     auto& pipelineDescriptor = _customCommand.getPipelineDescriptor();
     auto* program = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_COLOR);
@@ -58,14 +59,14 @@ MotionStreak::MotionStreak()
     iter = attributeInfo.find("a_texCoord");
     if(iter != attributeInfo.end())
     {
-        vertexLayout->setAttribute("a_texCoord", iter->second.location, backend::VertexFormat::FLOAT2, 2 * sizeof(float), false);
+        vertexLayout->setAttribute("a_texCoord", iter->second.location, backend::VertexFormat::FLOAT2, offsetof(V2F_C4B_T2F, texCoords), false);
     }
     iter = attributeInfo.find("a_color");
     if(iter != attributeInfo.end())
     {
-        vertexLayout->setAttribute("a_color", iter->second.location, backend::VertexFormat::UBYTE4, 4 * sizeof(float), true);
+        vertexLayout->setAttribute("a_color", iter->second.location, backend::VertexFormat::UBYTE4, offsetof(V2F_C4B_T2F, colors), true);
     }
-    vertexLayout->setLayout(4 * sizeof(float) + 4 * sizeof(uint8_t));
+    vertexLayout->setLayout(sizeof(V2F_C4B_T2F));
 }
 
 MotionStreak::~MotionStreak()
@@ -74,8 +75,6 @@ MotionStreak::~MotionStreak()
     CC_SAFE_FREE(_pointState);
     CC_SAFE_FREE(_pointVertexes);
     CC_SAFE_FREE(_vertices);
-    CC_SAFE_FREE(_colorPointer);
-    CC_SAFE_FREE(_texCoords);
 }
 
 MotionStreak* MotionStreak::create(float fade, float minSeg, float stroke, const Color3B& color, const std::string& path)
@@ -133,18 +132,17 @@ bool MotionStreak::initWithFade(float fade, float minSeg, float stroke, const Co
     _pointState = (float *)malloc(sizeof(float) * _maxPoints);
     _pointVertexes = (Vec2*)malloc(sizeof(Vec2) * _maxPoints);
 
-    const size_t VERTEX_SIZE = sizeof(Vec2) + sizeof(Tex2F) + sizeof(uint8_t) * 4;
-
     _vertexCount = _maxPoints * 2;
-    _vertices = (Vec2*)malloc(sizeof(Vec2) * _vertexCount);
-    _texCoords = (Tex2F*)malloc(sizeof(Tex2F) * _vertexCount);
-    _colorPointer =  (uint8_t*)malloc(sizeof(uint8_t) * 4 * _vertexCount);
-    _customCommand.createVertexBuffer(VERTEX_SIZE, _vertexCount, CustomCommand::BufferUsage::DYNAMIC);
+    _vertices = (V2F_C4B_T2F*)malloc(sizeof(V2F_C4B_T2F) * _vertexCount);
+    _customCommand.createVertexBuffer(sizeof(V2F_C4B_T2F), _vertexCount, CustomCommand::BufferUsage::DYNAMIC);
 
-    std::vector<uint8_t> zeros;
-    zeros.resize(VERTEX_SIZE * _vertexCount);
-    std::fill(zeros.begin(), zeros.end(), 0);
-    _customCommand.updateVertexBuffer(zeros.data(), zeros.size());
+    // the indices never change, draw() selects the live run of segments with setIndexDrawInfo()
+    // 16 bit indices, 32 bit ones aren't supported by every GLES2 device
+    CCASSERT(_maxPoints * 2 <= 65536, "fade too long for the frame rate, the streak needs more than 65536 vertices");
+    std::vector<unsigned short> indices(_maxPoints * 12);
+    ccVertexRingStripIndices(_maxPoints, indices.data());
+    _customCommand.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, indices.size(), CustomCommand::BufferUsage::STATIC);
+    _customCommand.updateIndexBuffer(indices.data(), indices.size() * sizeof(unsigned short));
 
     setTexture(texture);
     setColor(color);
@@ -217,9 +215,11 @@ void MotionStreak::tintWithColor(const Color3B& colors)
     setColor(colors);
 
     // Fast assignation
-    for(unsigned int i = 0; i<_nuPoints*2; i++) 
+    for(unsigned int i = 0; i<_nuPoints; i++) 
     {
-        *((Color3B*) (_colorPointer+i*4)) = colors;
+        const unsigned int slot = getPointSlot(i) * 2;
+        _vertices[slot].colors.set(colors.r, colors.g, colors.b, _vertices[slot].colors.a);
+        _vertices[slot+1].colors.set(colors.r, colors.g, colors.b, _vertices[slot+1].colors.a);
     }
 }
 
@@ -275,52 +275,20 @@ void MotionStreak::update(float delta)
 
     delta *= _fadeDelta;
 
-    unsigned int newIdx, newIdx2, i, i2;
-    unsigned int mov = 0;
+    unsigned int i, slot;
 
     // Update current points
     for (i = 0; i < _nuPoints; i++)
     {
-        _pointState[i] -= delta;
-
-        if (_pointState[i] <= 0)
-            mov++;
-        else
-        {
-            newIdx = i - mov;
+        _pointState[getPointSlot(i)] -= delta;
+    }
 
-            if (mov > 0)
-            {
-                // Move data
-                _pointState[newIdx] = _pointState[i];
-
-                // Move point
-                _pointVertexes[newIdx] = _pointVertexes[i];
-
-                // Move vertices
-                i2 = i * 2;
-                newIdx2 = newIdx * 2;
-                _vertices[newIdx2] = _vertices[i2];
-                _vertices[newIdx2+1] = _vertices[i2+1];
-
-                // Move color
-                i2 *= 4;
-                newIdx2 *= 4;
-                _colorPointer[newIdx2+0] = _colorPointer[i2+0];
-                _colorPointer[newIdx2+1] = _colorPointer[i2+1];
-                _colorPointer[newIdx2+2] = _colorPointer[i2+2];
-                _colorPointer[newIdx2+4] = _colorPointer[i2+4];
-                _colorPointer[newIdx2+5] = _colorPointer[i2+5];
-                _colorPointer[newIdx2+6] = _colorPointer[i2+6];
-            }else
-                newIdx2 = newIdx * 8;
-
-            const uint8_t op = (uint8_t)(_pointState[newIdx] * 255.0f);
-            _colorPointer[newIdx2+3] = op;
-            _colorPointer[newIdx2+7] = op;
-        }
+    // Every point fades at the same rate, so the expired ones are always the oldest
+    while (_nuPoints > 0 && _pointState[_headPoint] <= 0)
+    {
+        _headPoint = (_headPoint + 1) % _maxPoints;
+        _nuPoints--;
     }
-    _nuPoints -= mov;
 
     // Append new point
     bool appendNewPoint = true;
@@ -328,61 +296,86 @@ void MotionStreak::update(float delta)
         appendNewPoint = false;
     else if (_nuPoints > 0)
     {
-        bool a1 = _pointVertexes[_nuPoints-1].getDistanceSq(_positionR) < _minSeg;
-        bool a2 = (_nuPoints == 1) ? false : (_pointVertexes[_nuPoints-2].getDistanceSq(_positionR) < (_minSeg * 2.0f));
+        bool a1 = _pointVertexes[getPointSlot(_nuPoints-1)].getDistanceSq(_positionR) < _minSeg;
+        bool a2 = (_nuPoints == 1) ? false : (_pointVertexes[getPointSlot(_nuPoints-2)].getDistanceSq(_positionR) < (_minSeg * 2.0f));
         if (a1 || a2)
             appendNewPoint = false;
     }
 
     if (appendNewPoint)
     {
-        _pointVertexes[_nuPoints] = _positionR;
-        _pointState[_nuPoints] = 1.0f;
+        slot = getPointSlot(_nuPoints);
+        _pointVertexes[slot] = _positionR;
+        _pointState[slot] = 1.0f;
 
         // Color assignment
-        const unsigned int offset = _nuPoints * 8;
-        *((Color3B*)(_colorPointer + offset)) = _displayedColor;
-        *((Color3B*)(_colorPointer + offset+4)) = _displayedColor;
-
-        // Opacity
-        _colorPointer[offset+3] = 255;
-        _colorPointer[offset+7] = 255;
+        _vertices[slot*2].colors = Color4B(_displayedColor, 255);
+        _vertices[slot*2+1].colors = Color4B(_displayedColor, 255);
 
-        // Generate polygon
+        // Generate polygon, only the segment joining the previous point is built
         if (_nuPoints > 0 && _fastMode )
         {
+            const unsigned int prevSlot = getPointSlot(_nuPoints-1);
+            Vec2 points[2] = { _pointVertexes[prevSlot], _positionR };
+            Vec2 vertices[4] = { _vertices[prevSlot*2].vertices, _vertices[prevSlot*2+1].vertices };
+
             if(_nuPoints > 1)
             {
-                ccVertexLineToPolygon(_pointVertexes, _stroke, _vertices, _nuPoints, 1);
+                ccVertexLineToPolygon(points, _stroke, vertices, 1, 1);
             }
             else
             {
-                ccVertexLineToPolygon(_pointVertexes, _stroke, _vertices, 0, 2);
+                ccVertexLineToPolygon(points, _stroke, vertices, 0, 2);
+                _vertices[prevSlot*2].vertices = vertices[0];
+                _vertices[prevSlot*2+1].vertices = vertices[1];
             }
+            _vertices[slot*2].vertices = vertices[2];
+            _vertices[slot*2+1].vertices = vertices[3];
         }
 
         _nuPoints++;
     }
 
+    if (! _fastMode && _nuPoints > 1)
+    {
+        _linePoints.resize(_nuPoints);
+        _lineVertices.resize(_nuPoints * 2);
+        for (i = 0; i < _nuPoints; i++)
+        {
+            _linePoints[i] = _pointVertexes[getPointSlot(i)];
+        }
 
-    if (! _fastMode)
-        ccVertexLineToPolygon(_pointVertexes, _stroke, _vertices, 0, _nuPoints);
+        ccVertexLineToPolygon(_linePoints.data(), _stroke, _lineVertices.data(), 0, _nuPoints);
 
-    // Updated Tex Coords only if they are different than previous step
-    if (_nuPoints  && _previousNuPoints != _nuPoints) {
-        float texDelta = 1.0f / _nuPoints;
-        for (i = 0; i < _nuPoints; i++) {
-            _texCoords[i*2] = Tex2F(0, texDelta*i);
-            _texCoords[i*2+1] = Tex2F(1, texDelta*i);
+        for (i = 0; i < _nuPoints; i++)
+        {
+            slot = getPointSlot(i) * 2;
+            _vertices[slot].vertices = _lineVertices[i*2];
+            _vertices[slot+1].vertices = _lineVertices[i*2+1];
         }
+    }
 
-        _previousNuPoints = _nuPoints;
+    // Opacity and tex coords are relative to the oldest point, so they follow the ring head
+    if (_nuPoints)
+    {
+        float texDelta = 1.0f / _nuPoints;
+        for (i = 0; i < _nuPoints; i++)
+        {
+            const unsigned int pointSlot = getPointSlot(i);
+            const uint8_t op = (uint8_t)(_pointState[pointSlot] * 255.0f);
+            slot = pointSlot * 2;
+            _vertices[slot].colors.a = op;
+            _vertices[slot+1].colors.a = op;
+            _vertices[slot].texCoords = Tex2F(0, texDelta*i);
+            _vertices[slot+1].texCoords = Tex2F(1, texDelta*i);
+        }
     }
 }
 
 void MotionStreak::reset()
 {
     _nuPoints = 0;
+    _headPoint = 0;
 }
 
 void MotionStreak::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
@@ -390,10 +383,8 @@ void MotionStreak::draw(Renderer *renderer, const Mat4 &transform, uint32_t flag
     if(_nuPoints <= 1)
         return;
 
-    auto drawCount = _nuPoints * 2;
-        
     _customCommand.init(_globalZOrder, _blendFunc);
-    _customCommand.setVertexDrawInfo(0, drawCount);
+    _customCommand.setIndexDrawInfo(_headPoint * 6, (_nuPoints - 1) * 6);
     renderer->addCommand(&_customCommand);
 
     auto programState = _customCommand.getPipelineDescriptor().programState;
@@ -403,15 +394,13 @@ void MotionStreak::draw(Renderer *renderer, const Mat4 &transform, uint32_t flag
     Mat4 finalMat = projectionMat * transform;
     programState->setUniform(_mvpMatrixLocaiton, finalMat.m, sizeof(Mat4));
 
-    unsigned int offset = 0;
-    unsigned int vertexSize = sizeof(Vec2) + sizeof(Vec2) + sizeof(uint8_t) * 4;
-    for (unsigned int i = 0; i < drawCount; ++i)
-    {
-        offset = i * vertexSize;
-        _customCommand.updateVertexBuffer(&_vertices[i], offset, sizeof(_vertices[0]));
-        _customCommand.updateVertexBuffer(&_texCoords[i], offset + sizeof(_vertices[0]), sizeof(_texCoords[0]) );
-        _customCommand.updateVertexBuffer(&_colorPointer[i * 4], offset + sizeof(_vertices[0]) + sizeof(_texCoords[0]), 4 * sizeof(uint8_t));
-    }
+    // Upload the live slots only, in two runs when they wrap around the end of the ring
+    const unsigned int headVertex = _headPoint * 2;
+    const unsigned int liveVertices = _nuPoints * 2;
+    const unsigned int firstRun = std::min(liveVertices, _vertexCount - headVertex);
+    _customCommand.updateVertexBuffer(_vertices + headVertex, headVertex * sizeof(V2F_C4B_T2F), firstRun * sizeof(V2F_C4B_T2F));
+    if (firstRun < liveVertices)
+        _customCommand.updateVertexBuffer(_vertices, 0, (liveVertices - firstRun) * sizeof(V2F_C4B_T2F));
 }
 
 NS_CC_END
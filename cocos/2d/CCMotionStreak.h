@@ -170,18 +170,25 @@ protected:
     float _fadeDelta = 0.f;
     float _minSeg = 0.f;
 
+    /** ring slot of the i-th live point, counting from the oldest one */
+    unsigned int getPointSlot(unsigned int index) const { return (_headPoint + index) % _maxPoints; }
+
     unsigned int _maxPoints = 0;
     unsigned int _nuPoints = 0;
-    unsigned int _previousNuPoints = 0;
+    /** ring slot of the oldest point, points expire from here and are appended after the last one */
+    unsigned int _headPoint = 0;
 
-    /** Pointers */
+    /** Pointers, all of them indexed by ring slot */
     Vec2* _pointVertexes = nullptr;
     float* _pointState = nullptr;
 
-    Vec2* _vertices = nullptr;
-    uint8_t* _colorPointer = nullptr;
-    Tex2F* _texCoords = nullptr;
+    /** two vertices per ring slot, laid out as they are uploaded */
+    V2F_C4B_T2F* _vertices = nullptr;
     unsigned int _vertexCount = 0;
+
+    /** scratch used to rebuild the whole strip when fast mode is off */
+    std::vector<Vec2> _linePoints;
+    std::vector<Vec2> _lineVertices;
     
     CustomCommand _customCommand;
     
@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParticlePrototypeCache.h"
+#include "2d/CCParticleSystemQuad.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    ParticlePrototypeCache* s_sharedParticlePrototypeCache = nullptr;
+}
+
+ParticlePrototypeCache* ParticlePrototypeCache::getInstance()
+{
+    if (s_sharedParticlePrototypeCache == nullptr)
+    {
+        s_sharedParticlePrototypeCache = new (std::nothrow) ParticlePrototypeCache();
+    }
+    return s_sharedParticlePrototypeCache;
+}
+
+void ParticlePrototypeCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedParticlePrototypeCache);
+}
+
+ParticlePrototypeCache::ParticlePrototypeCache()
+{
+}
+
+ParticlePrototypeCache::~ParticlePrototypeCache()
+{
+    removeAllPrototypes();
+}
+
+ParticleSystemQuad* ParticlePrototypeCache::getParticleSystem(const std::string& plistFile)
+{
+    Pool* pool = getPool(plistFile);
+    if (pool == nullptr)
+        return nullptr;
+
+    ParticleSystemQuad* system = nullptr;
+    if (pool->idle.empty())
+    {
+        system = cloneInstance(pool);
+        if (system == nullptr)
+            return nullptr;
+    }
+    else
+    {
+        // keep the cache's reference, it is handed to the autorelease pool below
+        system = pool->idle.back();
+        system->retain();
+        pool->idle.popBack();
+    }
+
+    // undo whatever the previous user changed
+    system->copyConfigurationFrom(pool->prototype);
+    system->_particleCount = 0;
+    system->_emitCounter = 0;
+    system->_paused = false;
+    system->_isAutoRemoveOnFinish = true;
+    system->resetSystem();
+    system->setPosition(Vec2::ZERO);
+    system->setRotation(0);
+    system->setScale(1);
+    system->setVisible(true);
+
+    system->autorelease();
+    return system;
+}
+
+void ParticlePrototypeCache::reserve(const std::string& plistFile, int count)
+{
+    Pool* pool = getPool(plistFile);
+    if (pool == nullptr)
+        return;
+
+    pool->idle.reserve(count);
+    while (static_cast<int>(pool->idle.size()) < count)
+    {
+        ParticleSystemQuad* system = cloneInstance(pool);
+        if (system == nullptr)
+            return;
+        pool->idle.pushBack(system);
+        system->release();
+    }
+}
+
+void ParticlePrototypeCache::removeUnusedInstances()
+{
+    for (auto& iter : _pools)
+    {
+        iter.second.idle.clear();
+    }
+}
+
+void ParticlePrototypeCache::removeAllPrototypes()
+{
+    for (auto& iter : _pools)
+    {
+        iter.second.idle.clear();
+        iter.second.prototype->release();
+    }
+    _pools.clear();
+    _poolsByName.clear();
+}
+
+void ParticlePrototypeCache::recycle(ParticleSystem* system)
+{
+    if (s_sharedParticlePrototypeCache == nullptr)
+        return;
+
+    auto& pools = s_sharedParticlePrototypeCache->_pools;
+    auto iter = pools.find(system->getResourceFile());
+    if (iter != pools.end())
+    {
+        iter->second.idle.pushBack(static_cast<ParticleSystemQuad*>(system));
+    }
+}
+
+ParticlePrototypeCache::Pool* ParticlePrototypeCache::getPool(const std::string& plistFile)
+{
+    auto byName = _poolsByName.find(plistFile);
+    if (byName != _poolsByName.end())
+        return byName->second;
+
+    auto prototype = ParticleSystemQuad::create(plistFile);
+    if (prototype == nullptr)
+        return nullptr;
+
+    auto iter = _pools.find(prototype->getResourceFile());
+    if (iter == _pools.end())
+    {
+        prototype->retain();
+        iter = _pools.emplace(prototype->getResourceFile(), Pool{prototype, Vector<ParticleSystemQuad*>()}).first;
+    }
+    _poolsByName[plistFile] = &iter->second;
+    return &iter->second;
+}
+
+ParticleSystemQuad* ParticlePrototypeCache::cloneInstance(Pool* pool)
+{
+    auto system = ParticleSystemQuad::createWithTotalParticles(pool->prototype->getTotalParticles());
+    if (system == nullptr)
+        return nullptr;
+
+    system->retain();
+    system->copyConfigurationFrom(pool->prototype);
+    system->_pooled = true;
+    return system;
+}
+
+NS_CC_END
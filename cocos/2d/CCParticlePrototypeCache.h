@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "base/CCVector.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class ParticleSystem;
+class ParticleSystemQuad;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticlePrototypeCache
+ * @brief Hands out recycled ParticleSystemQuad instances of plist files.
+ *
+ * Each plist file is parsed once into a prototype system. getParticleSystem() returns an idle
+ * instance of that file, reset to the prototype's configuration, or clones a new one from the
+ * prototype when none is idle. Instances are auto-removed on finish and then go back to the pool,
+ * so spawning the same effect repeatedly does not parse, decode or allocate once the pool is warm.
+ * Instances removed from their parent by other means are released as usual.
+ */
+class CC_DLL ParticlePrototypeCache
+{
+public:
+    static ParticlePrototypeCache* getInstance();
+    static void destroyInstance();
+
+    /** Returns a reset, autoreleased system for the plist file, nullptr if the file can't be loaded. */
+    ParticleSystemQuad* getParticleSystem(const std::string& plistFile);
+
+    /** Parses the plist file if needed and clones instances until count of them are idle. */
+    void reserve(const std::string& plistFile, int count);
+
+    /** Releases the idle instances of all files, the prototypes stay cached. */
+    void removeUnusedInstances();
+
+    /** Releases all prototypes and idle instances, instances in use are no longer recycled. */
+    void removeAllPrototypes();
+
+private:
+    friend class ParticleSystem;
+    /** Called by auto-removed systems, puts pooled ones back into their pool. */
+    static void recycle(ParticleSystem* system);
+
+    struct Pool
+    {
+        ParticleSystemQuad* prototype;
+        Vector<ParticleSystemQuad*> idle;
+    };
+
+    ParticlePrototypeCache();
+    ~ParticlePrototypeCache();
+
+    Pool* getPool(const std::string& plistFile);
+    ParticleSystemQuad* cloneInstance(Pool* pool);
+
+    // pools by resolved path, which is the resource file of their instances
+    std::unordered_map<std::string, Pool> _pools;
+    // pools by the name they were requested with, saves resolving it again
+    std::unordered_map<std::string, Pool*> _poolsByName;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
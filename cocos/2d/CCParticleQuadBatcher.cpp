@@ -0,0 +1,186 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParticleQuadBatcher.h"
+#include <stddef.h> // offsetof
+#include "2d/CCCamera.h"
+#include "base/CCDirector.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/backend/ProgramState.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    ParticleQuadBatcher* s_sharedParticleQuadBatcher = nullptr;
+}
+
+ParticleQuadBatcher* ParticleQuadBatcher::getInstance()
+{
+    if (s_sharedParticleQuadBatcher == nullptr)
+    {
+        s_sharedParticleQuadBatcher = new (std::nothrow) ParticleQuadBatcher();
+    }
+    return s_sharedParticleQuadBatcher;
+}
+
+void ParticleQuadBatcher::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedParticleQuadBatcher);
+}
+
+ParticleQuadBatcher::ParticleQuadBatcher()
+{
+}
+
+ParticleQuadBatcher::~ParticleQuadBatcher()
+{
+    for (auto& entry : _materials)
+    {
+        releaseMaterial(entry.second);
+    }
+}
+
+void ParticleQuadBatcher::addQuads(Renderer* renderer, const V3F_C4B_T2F_Quad* quads, ssize_t count, Texture2D* texture, const BlendFunc& blendFunc, float globalZOrder, const Mat4& transform, uint32_t flags)
+{
+    CCASSERT(count <= MAX_QUADS_PER_BATCH, "ParticleQuadBatcher: too many quads for a single command, draw them with an own command");
+    if (count <= 0 || count > MAX_QUADS_PER_BATCH || texture == nullptr)
+        return;
+
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    if (frame != _frame)
+        beginFrame(frame);
+
+    MaterialKey key(texture->getBackendTexture(), blendFunc.src, blendFunc.dst, globalZOrder, Camera::getVisitingCamera(), renderer->getCurrentRenderQueueID());
+    auto& material = _materials[key];
+    if (material.frame != _frame)
+    {
+        material.frame = _frame;
+        material.usedBatches = 0;
+    }
+
+    Batch* batch = material.usedBatches > 0 ? material.batches[material.usedBatches - 1] : nullptr;
+    bool queueBatch = false;
+    if (batch == nullptr || batch->quads.size() + count > (size_t)MAX_QUADS_PER_BATCH)
+    {
+        if (material.usedBatches == material.batches.size())
+            material.batches.push_back(createBatch());
+        batch = material.batches[material.usedBatches++];
+        batch->quads.clear();
+        queueBatch = true;
+    }
+
+    size_t start = batch->quads.size();
+    batch->quads.insert(batch->quads.end(), quads, quads + count);
+    for (size_t i = start; i < batch->quads.size(); ++i)
+    {
+        auto& quad = batch->quads[i];
+        transform.transformPoint(&quad.bl.vertices);
+        transform.transformPoint(&quad.br.vertices);
+        transform.transformPoint(&quad.tl.vertices);
+        transform.transformPoint(&quad.tr.vertices);
+    }
+
+    // the command only keeps a pointer to the quads, re-init it as the vector may have moved;
+    // the renderer reads the quads when the queue is rendered, after every system appended
+    batch->command.init(globalZOrder, texture, blendFunc, batch->quads.data(), batch->quads.size(), Mat4::IDENTITY, flags);
+
+    if (queueBatch)
+    {
+        auto programState = batch->programState;
+        programState->setTexture(programState->getUniformLocation("u_texture"), 0, texture->getBackendTexture());
+
+        const auto& projectionMat = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+        programState->setUniform(programState->getUniformLocation("u_MVPMatrix"), projectionMat.m, sizeof(projectionMat.m));
+
+        renderer->addCommand(&batch->command);
+        ++_queuedBatches;
+    }
+    ++_appendedSystems;
+}
+
+void ParticleQuadBatcher::beginFrame(unsigned int frame)
+{
+    // drop the materials nobody drew with in the previous frame
+    for (auto iter = _materials.begin(); iter != _materials.end();)
+    {
+        if (iter->second.frame != _frame)
+        {
+            releaseMaterial(iter->second);
+            iter = _materials.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    _frame = frame;
+    _appendedSystems = 0;
+    _queuedBatches = 0;
+}
+
+ParticleQuadBatcher::Batch* ParticleQuadBatcher::createBatch()
+{
+    auto batch = new (std::nothrow) Batch();
+
+    auto* program = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_COLOR);
+    batch->programState = new (std::nothrow) backend::ProgramState(program);
+    batch->command.getPipelineDescriptor().programState = batch->programState;
+
+    auto vertexLayout = batch->programState->getVertexLayout();
+    const auto& attributeInfo = program->getActiveAttributes();
+    auto iter = attributeInfo.find("a_position");
+    if(iter != attributeInfo.end())
+    {
+        vertexLayout->setAttribute("a_position", iter->second.location, backend::VertexFormat::FLOAT3, 0, false);
+    }
+    iter = attributeInfo.find("a_texCoord");
+    if(iter != attributeInfo.end())
+    {
+        vertexLayout->setAttribute("a_texCoord", iter->second.location, backend::VertexFormat::FLOAT2, offsetof(V3F_C4B_T2F, texCoords), false);
+    }
+    iter = attributeInfo.find("a_color");
+    if(iter != attributeInfo.end())
+    {
+        vertexLayout->setAttribute("a_color", iter->second.location, backend::VertexFormat::UBYTE4, offsetof(V3F_C4B_T2F, colors), true);
+    }
+    vertexLayout->setLayout(sizeof(V3F_C4B_T2F));
+
+    return batch;
+}
+
+void ParticleQuadBatcher::releaseMaterial(Material& material)
+{
+    for (auto batch : material.batches)
+    {
+        CC_SAFE_RELEASE(batch->programState);
+        delete batch;
+    }
+    material.batches.clear();
+    material.usedBatches = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,107 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include "base/ccTypes.h"
+#include "renderer/CCQuadCommand.h"
+
+NS_CC_BEGIN
+
+class Camera;
+class Renderer;
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticleQuadBatcher
+ * @brief Merges the quads of ParticleSystemQuad nodes scattered across the scene graph into shared draws.
+ *
+ * Systems with auto batching enabled hand their quads over instead of queueing their own command.
+ * The quads are transformed to world space and appended to a per frame buffer of their material: the
+ * texture, blend function, global Z order, visiting camera and render queue. The buffer is drawn by a
+ * single QuadCommand, queued when the first system of the frame appended to it, so later systems are
+ * drawn at the position of the first one among the nodes of the same global Z order.
+ */
+class CC_DLL ParticleQuadBatcher
+{
+public:
+    /** QuadCommand indices are 16 bits and the shared index buffer is capped at 65536 entries,
+     systems with more live quads than this have to be drawn with their own command.
+     */
+    static const int MAX_QUADS_PER_BATCH = 65536 / 6;
+
+    static ParticleQuadBatcher* getInstance();
+    static void destroyInstance();
+
+    /** Appends quads, given in the space that transform maps to world space, to the batch of their material.
+     Only the first append to a batch in a frame queues a command to the renderer. The batches are drawn with
+     the default POSITION_TEXTURE_COLOR program and count must not exceed MAX_QUADS_PER_BATCH.
+     */
+    void addQuads(Renderer* renderer, const V3F_C4B_T2F_Quad* quads, ssize_t count, Texture2D* texture, const BlendFunc& blendFunc, float globalZOrder, const Mat4& transform, uint32_t flags);
+
+    /** Number of systems appended in the current frame and number of batch commands they were drawn with. */
+    int getAppendedSystemCount() const { return _appendedSystems; }
+    int getBatchCount() const { return _queuedBatches; }
+
+private:
+    struct Batch
+    {
+        QuadCommand command;
+        backend::ProgramState* programState = nullptr;
+        std::vector<V3F_C4B_T2F_Quad> quads;
+    };
+
+    struct Material
+    {
+        std::vector<Batch*> batches;
+        size_t usedBatches = 0;
+        unsigned int frame = 0;
+    };
+
+    typedef std::tuple<const void*, backend::BlendFactor, backend::BlendFactor, float, const Camera*, int> MaterialKey;
+
+    ParticleQuadBatcher();
+    ~ParticleQuadBatcher();
+
+    void beginFrame(unsigned int frame);
+    Batch* createBatch();
+    void releaseMaterial(Material& material);
+
+    std::map<MaterialKey, Material> _materials;
+    unsigned int _frame = 0;
+    int _appendedSystems = 0;
+    int _queuedBatches = 0;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
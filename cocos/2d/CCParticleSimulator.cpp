@@ -0,0 +1,231 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParticleSimulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "2d/CCParticleSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    ParticleSimulator* s_sharedParticleSimulator = nullptr;
+}
+
+/** Threads that run a job over a range of indices together with the calling thread. */
+class ParticleSimulator::Workers
+{
+public:
+    Workers()
+    {
+        unsigned int threadCount = std::thread::hardware_concurrency();
+        threadCount = std::min(7u, threadCount > 1 ? threadCount - 1 : 0);
+        for (unsigned int i = 0; i < threadCount; ++i)
+        {
+            _threads.emplace_back(&Workers::run, this);
+        }
+    }
+
+    ~Workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    int getThreadCount() const { return static_cast<int>(_threads.size()); }
+
+    void parallelFor(size_t count, const std::function<void(size_t)>& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &job;
+            _jobCount = count;
+            _nextIndex = 0;
+            _busyThreads = static_cast<int>(_threads.size());
+            ++_generation;
+        }
+        _condition.notify_all();
+
+        work();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _doneCondition.wait(lock, [this] { return _busyThreads == 0; });
+        _job = nullptr;
+    }
+
+private:
+    void work()
+    {
+        size_t index;
+        while ((index = _nextIndex.fetch_add(1)) < _jobCount)
+        {
+            (*_job)(index);
+        }
+    }
+
+    void run()
+    {
+        unsigned int generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this, generation] { return _stop || _generation != generation; });
+                if (_stop)
+                    return;
+                generation = _generation;
+            }
+
+            work();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_busyThreads;
+            }
+            _doneCondition.notify_one();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::condition_variable _doneCondition;
+    const std::function<void(size_t)>* _job = nullptr;
+    size_t _jobCount = 0;
+    std::atomic<size_t> _nextIndex{0};
+    int _busyThreads = 0;
+    unsigned int _generation = 0;
+    bool _stop = false;
+};
+
+ParticleSimulator* ParticleSimulator::getInstance()
+{
+    if (s_sharedParticleSimulator == nullptr)
+    {
+        s_sharedParticleSimulator = new (std::nothrow) ParticleSimulator();
+    }
+    return s_sharedParticleSimulator;
+}
+
+void ParticleSimulator::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedParticleSimulator);
+}
+
+ParticleSimulator::ParticleSimulator()
+: _workers(new Workers())
+, _afterUpdateListener(nullptr)
+, _enabled(false)
+, _flushing(false)
+{
+    _enabled = _workers->getThreadCount() > 0;
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+        flush();
+    });
+}
+
+ParticleSimulator::~ParticleSimulator()
+{
+    flush();
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterUpdateListener);
+    delete _workers;
+}
+
+void ParticleSimulator::setEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        flush();
+    }
+    _enabled = enabled && _workers->getThreadCount() > 0;
+}
+
+int ParticleSimulator::getThreadCount() const
+{
+    return _workers->getThreadCount();
+}
+
+void ParticleSimulator::addSystem(ParticleSystem* system)
+{
+    _systems.pushBack(system);
+}
+
+void ParticleSimulator::flush()
+{
+    if (_systems.empty() || _flushing)
+        return;
+
+    _flushing = true;
+    Vector<ParticleSystem*> systems(std::move(_systems));
+    _systems.clear();
+
+    // Computing a node transform writes to the node and its parents, even when it is cached,
+    // so the workers get the matrices computed here and never call the transform API themselves.
+    std::vector<std::pair<Mat4, Mat4>> transforms;
+    transforms.reserve(systems.size());
+    for (auto system : systems)
+    {
+        Mat4 nodeToWorld = system->getNodeToWorldTransform();
+        transforms.emplace_back(nodeToWorld, nodeToWorld.getInversed());
+    }
+
+    if (systems.size() > 1)
+    {
+        _workers->parallelFor(systems.size(), [&systems, &transforms](size_t index) {
+            systems.at(index)->simulate(transforms[index].first, transforms[index].second);
+        });
+    }
+    else
+    {
+        systems.at(0)->simulate(transforms[0].first, transforms[0].second);
+    }
+
+    // removing finished systems and uploading vertices stay on the main thread
+    for (auto system : systems)
+    {
+        system->finishSimulation();
+    }
+    _flushing = false;
+}
+
+NS_CC_END
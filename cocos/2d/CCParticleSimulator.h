@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCVector.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class ParticleSystem;
+class EventListenerCustom;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticleSimulator
+ * @brief Runs the per frame simulation of independent particle systems in parallel.
+ *
+ * ParticleSystem::update() only emits new particles; the simulation of the system's own
+ * particle data and the generation of its quads are queued here and run on a pool of worker
+ * threads once all scheduled updates of the frame are done, before the scene is visited.
+ * Systems drawn through a ParticleBatchNode, systems with script bindings and systems that
+ * disabled ParticleSystem::setParallelSimulationEnabled() keep updating serially.
+ */
+class CC_DLL ParticleSimulator
+{
+public:
+    static ParticleSimulator* getInstance();
+    static void destroyInstance();
+
+    /** Enables or disables parallel simulation, enabled by default on machines with more than one core. */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /** Number of worker threads, the main thread works along with them. */
+    int getThreadCount() const;
+
+    /** Queues the simulation of a system, it runs at the next flush(). */
+    void addSystem(ParticleSystem* system);
+
+    /** Runs the queued simulations and waits for them.
+     Called after the scheduler update, and by systems that are updated again before that. */
+    void flush();
+
+private:
+    ParticleSimulator();
+    ~ParticleSimulator();
+
+    class Workers;
+
+    Vector<ParticleSystem*> _systems;
+    Workers* _workers;
+    EventListenerCustom* _afterUpdateListener;
+    bool _enabled;
+    bool _flushing;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
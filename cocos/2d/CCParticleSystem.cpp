@@ -46,8 +46,13 @@ THE SOFTWARE.
 #include "2d/CCParticleSystem.h"
 
 #include <string>
+#include <algorithm>
+#include <float.h>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleSimulator.h"
+#include "2d/CCParticlePrototypeCache.h"
+#include "2d/CCParticleSystemSIMD.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
@@ -80,36 +85,6 @@ NS_CC_BEGIN
 //
 
 
-inline void normalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-    
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-    
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
-/**
- A more effect random number getter function, get from ejoy2d.
- */
-inline static float RANDOM_M11(unsigned int *seed) {
-    *seed = *seed * 134775813 + 1;
-    union {
-        uint32_t d;                                     
-        float f;
-    } u;
-    u.d = (((uint32_t)(*seed) & 0x7fff) << 8) | 0x40000000;
-    return u.f - 3.0f;
-}
-
 ParticleData::ParticleData()
 {
     memset(this, 0, sizeof(ParticleData));
@@ -226,6 +201,11 @@ ParticleSystem::ParticleSystem()
 , _positionType(PositionType::FREE)
 , _paused(false)
 , _sourcePositionCompatible(true) // In the furture this member's default value maybe false or be removed.
+, _parallelSimulationEnabled(true)
+, _simulationPending(false)
+, _simulationFinished(false)
+, _simulationDelta(0)
+, _pooled(false)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -613,35 +593,27 @@ void ParticleSystem::addParticles(int count)
 {
     if (_paused)
         return;
-    uint32_t RANDSEED = rand();
 
     int start = _particleCount;
     _particleCount += count;
+    initParticles(start, count);
+}
+
+void ParticleSystem::initParticles(int start, int count)
+{
+    ParticleSIMD::RandomM11 random(rand());
+    int end = start + count;
     
     //life
-    for (int i = start; i < _particleCount ; ++i)
-    {
-        float theLife = _life + _lifeVar * RANDOM_M11(&RANDSEED);
-        _particleData.timeToLive[i] = MAX(0, theLife);
-    }
+    ParticleSIMD::fillRandomClamped(_particleData.timeToLive + start, count, _life, _lifeVar, 0, FLT_MAX, random);
     
     //position
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posx[i] = _sourcePosition.x + _posVar.x * RANDOM_M11(&RANDSEED);
-    }
-    
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posy[i] = _sourcePosition.y + _posVar.y * RANDOM_M11(&RANDSEED);
-    }
+    ParticleSIMD::fillRandom(_particleData.posx + start, count, _sourcePosition.x, _posVar.x, random);
+    ParticleSIMD::fillRandom(_particleData.posy + start, count, _sourcePosition.y, _posVar.y, random);
     
     //color
 #define SET_COLOR(c, b, v)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
-}
+ParticleSIMD::fillRandomClamped(c + start, count, b, v, 0, 1, random)
     
     SET_COLOR(_particleData.colorR, _startColor.r, _startColorVar.r);
     SET_COLOR(_particleData.colorG, _startColor.g, _startColorVar.g);
@@ -654,10 +626,7 @@ c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
     SET_COLOR(_particleData.deltaColorA, _endColor.a, _endColorVar.a);
     
 #define SET_DELTA_COLOR(c, dc)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
-}
+ParticleSIMD::deltaOverLife(dc + start, c + start, _particleData.timeToLive + start, count)
     
     SET_DELTA_COLOR(_particleData.colorR, _particleData.deltaColorR);
     SET_DELTA_COLOR(_particleData.colorG, _particleData.deltaColorG);
@@ -665,39 +634,22 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     SET_DELTA_COLOR(_particleData.colorA, _particleData.deltaColorA);
     
     //size
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.size[i] = _startSize + _startSizeVar * RANDOM_M11(&RANDSEED);
-        _particleData.size[i] = MAX(0, _particleData.size[i]);
-    }
+    ParticleSIMD::fillRandomClamped(_particleData.size + start, count, _startSize, _startSizeVar, 0, FLT_MAX, random);
     
     if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
     {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            float endSize = _endSize + _endSizeVar * RANDOM_M11(&RANDSEED);
-            endSize = MAX(0, endSize);
-            _particleData.deltaSize[i] = (endSize - _particleData.size[i]) / _particleData.timeToLive[i];
-        }
+        ParticleSIMD::fillRandomClamped(_particleData.deltaSize + start, count, _endSize, _endSizeVar, 0, FLT_MAX, random);
+        ParticleSIMD::deltaOverLife(_particleData.deltaSize + start, _particleData.size + start, _particleData.timeToLive + start, count);
     }
     else
     {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.deltaSize[i] = 0.0f;
-        }
+        std::fill_n(_particleData.deltaSize + start, count, 0.0f);
     }
     
     // rotation
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.rotation[i] = _startSpin + _startSpinVar * RANDOM_M11(&RANDSEED);
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        float endA = _endSpin + _endSpinVar * RANDOM_M11(&RANDSEED);
-        _particleData.deltaRotation[i] = (endA - _particleData.rotation[i]) / _particleData.timeToLive[i];
-    }
+    ParticleSIMD::fillRandom(_particleData.rotation + start, count, _startSpin, _startSpinVar, random);
+    ParticleSIMD::fillRandom(_particleData.deltaRotation + start, count, _endSpin, _endSpinVar, random);
+    ParticleSIMD::deltaOverLife(_particleData.deltaRotation + start, _particleData.rotation + start, _particleData.timeToLive + start, count);
     
     // position
     Vec2 pos;
@@ -709,57 +661,34 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         pos = _position;
     }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.startPosX[i] = pos.x;
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.startPosY[i] = pos.y;
-    }
+    std::fill_n(_particleData.startPosX + start, count, pos.x);
+    std::fill_n(_particleData.startPosY + start, count, pos.y);
     
     // Mode Gravity: A
     if (_emitterMode == Mode::GRAVITY)
     {
         
         // radial accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleSIMD::fillRandom(_particleData.modeA.radialAccel + start, count, modeA.radialAccel, modeA.radialAccelVar, random);
         
         // tangential accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleSIMD::fillRandom(_particleData.modeA.tangentialAccel + start, count, modeA.tangentialAccel, modeA.tangentialAccelVar, random);
+        
+        // direction: angle in dirX and speed in dirY, then converted to a vector
+        ParticleSIMD::fillRandom(_particleData.modeA.dirX + start, count,
+                                 CC_DEGREES_TO_RADIANS(_angle), CC_DEGREES_TO_RADIANS(_angleVar), random);
+        ParticleSIMD::fillRandom(_particleData.modeA.dirY + start, count, modeA.speed, modeA.speedVar, random);
+        ParticleSIMD::polarToCartesian(_particleData.modeA.dirX + start, _particleData.modeA.dirY + start, count);
         
         // rotation is dir
         if( modeA.rotationIsDir )
         {
-            for (int i = start; i < _particleCount; ++i)
+            for (int i = start; i < end; ++i)
             {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
+                Vec2 dir(_particleData.modeA.dirX[i], _particleData.modeA.dirY[i]);
                 _particleData.rotation[i] = -CC_RADIANS_TO_DEGREES(dir.getAngle());
             }
         }
-        else
-        {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
-            }
-        }
         
     }
     
@@ -768,35 +697,22 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         //Need to check by Jacky
         // Set the default diameter of the particle from the source position
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleSIMD::fillRandom(_particleData.modeB.radius + start, count, modeB.startRadius, modeB.startRadiusVar, random);
 
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED));
-        }
+        ParticleSIMD::fillRandom(_particleData.modeB.angle + start, count,
+                                 CC_DEGREES_TO_RADIANS(_angle), CC_DEGREES_TO_RADIANS(_angleVar), random);
         
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * RANDOM_M11(&RANDSEED));
-        }
+        ParticleSIMD::fillRandom(_particleData.modeB.degreesPerSecond + start, count,
+                                 CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond), CC_DEGREES_TO_RADIANS(modeB.rotatePerSecondVar), random);
         
         if(modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
         {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                _particleData.modeB.deltaRadius[i] = 0.0f;
-            }
+            std::fill_n(_particleData.modeB.deltaRadius + start, count, 0.0f);
         }
         else
         {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float endRadius = modeB.endRadius + modeB.endRadiusVar * RANDOM_M11(&RANDSEED);
-                _particleData.modeB.deltaRadius[i] = (endRadius - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
-            }
+            ParticleSIMD::fillRandom(_particleData.modeB.deltaRadius + start, count, modeB.endRadius, modeB.endRadiusVar, random);
+            ParticleSIMD::deltaOverLife(_particleData.modeB.deltaRadius + start, _particleData.modeB.radius + start, _particleData.timeToLive + start, count);
         }
     }
 }
@@ -866,168 +782,214 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    auto simulator = ParticleSimulator::getInstance();
+    if (_simulationPending)
+    {
+        // updated again before the queued step ran, e.g. when fast forwarding a system
+        simulator->flush();
+    }
+
     if (_isActive && _emissionRate)
     {
-        float rate = 1.0f / _emissionRate;
-        int totalParticles = static_cast<int>(_totalParticles * __totalParticleCountFactor);
-        
-        //issue #1201, prevent bursts of particles, due to too high emitCounter
-        if (_particleCount < totalParticles)
-        {
-            _emitCounter += dt;
-            if (_emitCounter < 0.f)
-                _emitCounter = 0.f;
-        }
-        
-        int emitCount = MIN(totalParticles - _particleCount, _emitCounter / rate);
-        addParticles(emitCount);
-        _emitCounter -= rate * emitCount;
-        
-        _elapsed += dt;
-        if (_elapsed < 0.f)
-            _elapsed = 0.f;
-        if (_duration != DURATION_INFINITY && _duration < _elapsed)
-        {
-            this->stopSystem();
-        }
+        addParticles(updateEmission(dt));
+    }
+
+    _simulationDelta = dt;
+    if (canSimulateInParallel())
+    {
+        _simulationPending = true;
+        simulator->addSystem(this);
     }
+    else
+    {
+        Mat4 nodeToWorld = getNodeToWorldTransform();
+        simulate(nodeToWorld, nodeToWorld.getInversed());
+        finishSimulation();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::copyConfigurationFrom(ParticleSystem* prototype)
+{
+    CCASSERT(_totalParticles == prototype->_totalParticles, "prototype must have the same total particle count");
+
+    _plistFile = prototype->_plistFile;
+    _configName = prototype->_configName;
+    _duration = prototype->_duration;
+    _sourcePosition = prototype->_sourcePosition;
+    _posVar = prototype->_posVar;
+    _life = prototype->_life;
+    _lifeVar = prototype->_lifeVar;
+    _angle = prototype->_angle;
+    _angleVar = prototype->_angleVar;
+    _emitterMode = prototype->_emitterMode;
+    modeA = prototype->modeA;
+    modeB = prototype->modeB;
+    _startSize = prototype->_startSize;
+    _startSizeVar = prototype->_startSizeVar;
+    _endSize = prototype->_endSize;
+    _endSizeVar = prototype->_endSizeVar;
+    _startColor = prototype->_startColor;
+    _startColorVar = prototype->_startColorVar;
+    _endColor = prototype->_endColor;
+    _endColorVar = prototype->_endColorVar;
+    _startSpin = prototype->_startSpin;
+    _startSpinVar = prototype->_startSpinVar;
+    _endSpin = prototype->_endSpin;
+    _endSpinVar = prototype->_endSpinVar;
+    _emissionRate = prototype->_emissionRate;
+    _positionType = prototype->_positionType;
+    _yCoordFlipped = prototype->_yCoordFlipped;
+    _sourcePositionCompatible = prototype->_sourcePositionCompatible;
+    _parallelSimulationEnabled = prototype->_parallelSimulationEnabled;
+
+    // the texture may reset the blend function, so it goes first
+    if (prototype->_texture && _texture != prototype->_texture)
+    {
+        setTexture(prototype->_texture);
+    }
+    _isBlendAdditive = prototype->_isBlendAdditive;
+    _blendFunc = prototype->_blendFunc;
+    _opacityModifyRGB = prototype->_opacityModifyRGB;
+}
+
+int ParticleSystem::updateEmission(float dt)
+{
+    if (!_isActive || !_emissionRate)
+        return 0;
+
+    float rate = 1.0f / _emissionRate;
+    int totalParticles = static_cast<int>(_totalParticles * __totalParticleCountFactor);
     
+    //issue #1201, prevent bursts of particles, due to too high emitCounter
+    if (_particleCount < totalParticles)
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
-        
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            if (_particleData.timeToLive[i] <= 0.0f)
-            {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        }
-        
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
-        }
-        else
+        _emitCounter += dt;
+        if (_emitCounter < 0.f)
+            _emitCounter = 0.f;
+    }
+    
+    int emitCount = MIN(totalParticles - _particleCount, _emitCounter / rate);
+    _emitCounter -= rate * emitCount;
+    
+    _elapsed += dt;
+    if (_elapsed < 0.f)
+        _elapsed = 0.f;
+    if (_duration != DURATION_INFINITY && _duration < _elapsed)
+    {
+        this->stopSystem();
+    }
+    return emitCount;
+}
+
+bool ParticleSystem::canSimulateInParallel() const
+{
+    // the batch node shares one texture atlas between its systems
+    if (!_parallelSimulationEnabled || _batchNode || !ParticleSimulator::getInstance()->isEnabled())
+        return false;
+#if CC_ENABLE_SCRIPT_BINDING
+    if (_scriptType != kScriptTypeNone)
+        return false;
+#endif
+    return true;
+}
+
+void ParticleSystem::simulate(const Mat4& nodeToWorld, const Mat4& worldToNode)
+{
+    float dt = _simulationDelta;
+    _simulationNodeToWorld = nodeToWorld;
+    _simulationWorldToNode = worldToNode;
+
+    for (int i = 0; i < _particleCount; ++i)
+    {
+        _particleData.timeToLive[i] -= dt;
+    }
+    
+    for (int i = 0; i < _particleCount; ++i)
+    {
+        if (_particleData.timeToLive[i] <= 0.0f)
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
+            int j = _particleCount - 1;
+            while (j > 0 && _particleData.timeToLive[j] <= 0)
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
+                _particleCount--;
+                j--;
             }
-            
-            for (int i = 0; i < _particleCount; ++i)
+            _particleData.copyParticle(i, _particleCount - 1);
+            if (_batchNode)
             {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+                //disable the switched particle
+                int currentIndex = _particleData.atlasIndex[i];
+                _batchNode->disableParticle(_atlasIndex + currentIndex);
+                //switch indexes
+                _particleData.atlasIndex[_particleCount - 1] = currentIndex;
             }
-            for (int i = 0; i < _particleCount; ++i)
+            --_particleCount;
+            if( _particleCount == 0 && _isAutoRemoveOnFinish )
             {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+                // removed by finishSimulation() on the main thread
+                _simulationFinished = true;
+                return;
             }
         }
-        
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
+    }
+    
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        ParticleSIMD::updateGravity(_particleData.posx, _particleData.posy,
+                                    _particleData.modeA.dirX, _particleData.modeA.dirY,
+                                    _particleData.modeA.radialAccel, _particleData.modeA.tangentialAccel,
+                                    _particleCount, modeA.gravity, dt, _yCoordFlipped);
+    }
+    else
+    {
+        ParticleSIMD::updateRadius(_particleData.posx, _particleData.posy,
+                                   _particleData.modeB.angle, _particleData.modeB.radius,
+                                   _particleData.modeB.degreesPerSecond, _particleData.modeB.deltaRadius,
+                                   _particleCount, dt, _yCoordFlipped);
+    }
+    
+    //Why use so many passes separately instead of putting them together?
+    //When the processor needs to read from or write to a location in memory,
+    //it first checks whether a copy of that data is in the cache.
+    //And every property's memory of the particle system is continuous,
+    //for the purpose of improving cache hit rate, we should process only one property in one pass AFAP.
+    //It was proved to be effective especially for low-end machine. 
+    //color r,g,b,a
+    ParticleSIMD::integrate(_particleData.colorR, _particleData.deltaColorR, _particleCount, dt);
+    ParticleSIMD::integrate(_particleData.colorG, _particleData.deltaColorG, _particleCount, dt);
+    ParticleSIMD::integrate(_particleData.colorB, _particleData.deltaColorB, _particleCount, dt);
+    ParticleSIMD::integrate(_particleData.colorA, _particleData.deltaColorA, _particleCount, dt);
+    //size
+    ParticleSIMD::integrateClampZero(_particleData.size, _particleData.deltaSize, _particleCount, dt);
+    //angle
+    ParticleSIMD::integrate(_particleData.rotation, _particleData.deltaRotation, _particleCount, dt);
+    
+    updateParticleQuads();
+    _transformSystemDirty = false;
+}
+
+void ParticleSystem::finishSimulation()
+{
+    _simulationPending = false;
+
+    if (_simulationFinished)
+    {
+        _simulationFinished = false;
+        // the system may be removed from inside its own update(), keep it alive until the end of the frame
+        this->retain();
+        this->autorelease();
+        this->unscheduleUpdate();
+        if (_parent)
         {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
+            _parent->removeChild(this, true);
         }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
+        if (_pooled)
         {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
+            ParticlePrototypeCache::recycle(this);
         }
-        
-        updateParticleQuads();
-        _transformSystemDirty = false;
+        return;
     }
 
     // only update gl buffer when visible
@@ -1035,8 +997,6 @@ void ParticleSystem::update(float dt)
     {
         postStep();
     }
-
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 }
 
 void ParticleSystem::updateWithNoTime()
@@ -255,7 +255,7 @@ public:
     void stopSystem();
     /** Kill all living particles.
      */
-    void resetSystem();
+    virtual void resetSystem();
     /** Whether or not the system is full.
      *
      * @return True if the system is full.
@@ -769,6 +769,12 @@ public:
     
     void setSourcePositionCompatible(bool sourcePositionCompatible) { _sourcePositionCompatible = sourcePositionCompatible; }
     bool isSourcePositionCompatible() const { return _sourcePositionCompatible; }
+
+    /** Sets whether the simulation of this system may run on a worker thread, see ParticleSimulator.
+     Subclasses whose updateParticleQuads() touches shared state should disable it.
+     */
+    void setParallelSimulationEnabled(bool enabled) { _parallelSimulationEnabled = enabled; }
+    bool isParallelSimulationEnabled() const { return _parallelSimulationEnabled; }
     
 CC_CONSTRUCTOR_ACCESS:
     /**
@@ -816,6 +822,23 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     virtual void updateBlendFunc();
+
+    friend class ParticleSimulator;
+    friend class ParticlePrototypeCache;
+    bool canSimulateInParallel() const;
+    /** Ages, moves and removes particles and updates the quads, runs on a worker thread when queued.
+     The transforms are computed by the caller on the main thread, workers must not touch the node transforms
+     since computing them writes to the node and its parents.
+     */
+    void simulate(const Mat4& nodeToWorld, const Mat4& worldToNode);
+    /** Main thread part of the step: removal on finish and the vertex upload. */
+    void finishSimulation();
+    /** Copies the emitter configuration, texture and blending of a system with the same total particle count. */
+    void copyConfigurationFrom(ParticleSystem* prototype);
+    /** Advances the emission clock by dt and returns how many particles to emit, stops the system when its duration is over. */
+    int updateEmission(float dt);
+    /** Initializes the particle data in [start, start + count) as newly emitted particles. */
+    void initParticles(int start, int count);
     
 private:
     friend class EngineDataManager;
@@ -904,6 +927,9 @@ protected:
 
     //true if scaled or rotated
     bool _transformSystemDirty;
+    // node to world and world to node transforms of the step being simulated, see simulate()
+    Mat4 _simulationNodeToWorld;
+    Mat4 _simulationWorldToNode;
     // Number of allocated particles
     int _allocatedParticles;
 
@@ -985,6 +1011,13 @@ protected:
     /** is sourcePosition compatible */
     bool _sourcePositionCompatible;
 
+    bool _parallelSimulationEnabled;
+    bool _simulationPending;
+    bool _simulationFinished;
+    float _simulationDelta;
+    /** handed out by ParticlePrototypeCache, goes back there when auto-removed */
+    bool _pooled;
+
     static Vector<ParticleSystem*> __allInstances;
     
 private:
@@ -32,6 +32,9 @@ THE SOFTWARE.
 #include "base/ccTypes.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleSystemSIMD.h"
+#include "2d/CCParticleSimulator.h"
+#include "2d/CCParticleQuadBatcher.h"
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCDirector.h"
@@ -45,6 +48,11 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+namespace {
+    // the most stateless particles a command with 16 bit indices can draw
+    const int STATELESS_PARTICLES_PER_COMMAND = 65535 / 4;
+}
+
 ParticleSystemQuad::ParticleSystemQuad()
 {
     auto& pipelieDescriptor = _quadCommand.getPipelineDescriptor();
@@ -81,6 +89,7 @@ ParticleSystemQuad::~ParticleSystemQuad()
         CC_SAFE_FREE(_quads);
         CC_SAFE_FREE(_indices);
     }
+    releaseStatelessBuffers();
 }
 
 // implementation ParticleSystemQuad
@@ -212,6 +221,10 @@ void ParticleSystemQuad::initTexCoordsWithRect(const Rect& pointRect)
         quads[i].tr.texCoords.u = right;
         quads[i].tr.texCoords.v = top;
     }
+    if (_statelessMode)
+    {
+        initStatelessCorners();
+    }
 }
 
 void ParticleSystemQuad::updateTexCoords()
@@ -264,186 +277,91 @@ void ParticleSystemQuad::initIndices()
     }
 }
 
-inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPosition,float size,float rotation)
-{
-    // vertices
-    float size_2 = size/2;
-    float x1 = -size_2;
-    float y1 = -size_2;
-    
-    float x2 = size_2;
-    float y2 = size_2;
-    float x = newPosition.x;
-    float y = newPosition.y;
-    
-    float r = (float)-CC_DEGREES_TO_RADIANS(rotation);
-    float cr = cosf(r);
-    float sr = sinf(r);
-    float ax = x1 * cr - y1 * sr + x;
-    float ay = x1 * sr + y1 * cr + y;
-    float bx = x2 * cr - y1 * sr + x;
-    float by = x2 * sr + y1 * cr + y;
-    float cx = x2 * cr - y2 * sr + x;
-    float cy = x2 * sr + y2 * cr + y;
-    float dx = x1 * cr - y2 * sr + x;
-    float dy = x1 * sr + y2 * cr + y;
-    
-    // bottom-left
-    quad->bl.vertices.x = ax;
-    quad->bl.vertices.y = ay;
-    
-    // bottom-right vertex:
-    quad->br.vertices.x = bx;
-    quad->br.vertices.y = by;
-    
-    // top-left vertex:
-    quad->tl.vertices.x = dx;
-    quad->tl.vertices.y = dy;
-    
-    // top-right vertex:
-    quad->tr.vertices.x = cx;
-    quad->tr.vertices.y = cy;
-}
-
-void ParticleSystemQuad::updateParticleQuads()
+ParticleSIMD::QuadTransform ParticleSystemQuad::getQuadTransform(const Mat4& nodeToWorld, const Mat4& worldToNode) const
 {
-    if (_particleCount <= 0) {
-        return;
-    }
- 
     Vec2 currentPosition;
     if (_positionType == PositionType::FREE)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        currentPosition.set(nodeToWorld.m[12], nodeToWorld.m[13]);
     }
     else if (_positionType == PositionType::RELATIVE)
     {
         currentPosition = _position;
     }
-    
-    V3F_C4B_T2F_Quad *startQuad;
-    Vec2 pos = Vec2::ZERO;
-    if (_batchNode)
-    {
-        V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
-        startQuad = &(batchQuads[_atlasIndex]);
-        pos = _position;
-    }
-    else
-    {
-        startQuad = &(_quads[0]);
-    }
-    
+
+    Vec2 pos = _batchNode ? _position : Vec2::ZERO;
+
+    // every mode maps a particle to its quad center with the same affine form,
+    // so a single kernel builds the quads
+    ParticleSIMD::QuadTransform transform = {0.0f, 0.0f, 0.0f, 0.0f, pos.x, pos.y};
     if( _positionType == PositionType::FREE )
     {
+        // center = pos + p - (worldToNode(current) - worldToNode(start))
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
-        worldToNodeTM.transformPoint(&p1);
-        Vec3 p2;
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            p2.set(*startX, *startY, 0);
-            worldToNodeTM.transformPoint(&p2);
-            newPos.set(*x,*y);
-            p2 = p1 - p2;
-            newPos.x -= p2.x - pos.x;
-            newPos.y -= p2.y - pos.y;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        worldToNode.transformPoint(&p1);
+        transform.a = worldToNode.m[0];
+        transform.b = worldToNode.m[1];
+        transform.c = worldToNode.m[4];
+        transform.d = worldToNode.m[5];
+        transform.tx += worldToNode.m[12] - p1.x;
+        transform.ty += worldToNode.m[13] - p1.y;
     }
     else if( _positionType == PositionType::RELATIVE )
     {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            newPos.set(*x, *y);
-            newPos.x = *x - (currentPosition.x - *startX);
-            newPos.y = *y - (currentPosition.y - *startY);
-            newPos += pos;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        // center = pos + p - (current - start)
+        transform.a = 1.0f;
+        transform.d = 1.0f;
+        transform.tx -= currentPosition.x;
+        transform.ty -= currentPosition.y;
     }
-    else
-    {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            newPos.set(*x + pos.x, *y + pos.y);
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+    return transform;
+}
+
+void ParticleSystemQuad::updateParticleQuads()
+{
+    if (_particleCount <= 0) {
+        return;
     }
-    
-    //set color
-    if(_opacityModifyRGB)
+ 
+    V3F_C4B_T2F_Quad *startQuad;
+    if (_batchNode)
     {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-        
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
-        {
-            uint8_t colorR = *r * *a * 255;
-            uint8_t colorG = *g * *a * 255;
-            uint8_t colorB = *b * *a * 255;
-            uint8_t colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
-        }
+        V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
+        startQuad = &(batchQuads[_atlasIndex]);
     }
     else
     {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-        
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
-        {
-            uint8_t colorR = *r * 255;
-            uint8_t colorG = *g * 255;
-            uint8_t colorB = *b * 255;
-            uint8_t colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
-        }
+        startQuad = &(_quads[0]);
     }
+    
+    ParticleSIMD::QuadTransform transform = getQuadTransform(_simulationNodeToWorld, _simulationWorldToNode);
+    ParticleSIMD::updateQuadPositions(startQuad, _particleData.posx, _particleData.posy,
+                                      _particleData.startPosX, _particleData.startPosY,
+                                      _particleData.size, _particleData.rotation, _particleCount, transform);
+    
+    //set color
+    ParticleSIMD::updateQuadColors(startQuad, _particleData.colorR, _particleData.colorG,
+                                   _particleData.colorB, _particleData.colorA, _particleCount, _opacityModifyRGB);
 }
 
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (_statelessMode)
+    {
+        drawStateless(renderer, transform);
+        return;
+    }
+
     //quad command
     if(_particleCount > 0)
     {
+        if (canAutoBatch())
+        {
+            ParticleQuadBatcher::getInstance()->addQuads(renderer, _quads, _particleCount, _texture, _blendFunc, _globalZOrder, transform, flags);
+            return;
+        }
+
         auto programState = _quadCommand.getPipelineDescriptor().programState;
         programState->setTexture(_textureLocation, 0, _texture->getBackendTexture());
         
@@ -457,6 +375,13 @@ void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_
 
 void ParticleSystemQuad::setTotalParticles(int tp)
 {
+    // the ring buffer is sized by the total particle count
+    bool stateless = _statelessMode;
+    if (stateless)
+    {
+        setStatelessMode(false);
+    }
+
     // If we are setting the total number of particles to a number higher
     // than what is allocated, we need to allocate new arrays
     if( tp > _allocatedParticles )
@@ -524,6 +449,11 @@ void ParticleSystemQuad::setTotalParticles(int tp)
     setEmissionRate(_totalParticles / _life);
     
     resetSystem();
+
+    if (stateless)
+    {
+        setStatelessMode(true);
+    }
 }
 
 void ParticleSystemQuad::listenRendererRecreated(EventCustom* /*event*/)
@@ -571,6 +501,12 @@ void ParticleSystemQuad::setBatchNode(ParticleBatchNode * batchNode)
 {
     if( _batchNode != batchNode ) 
     {
+        if (batchNode)
+        {
+            // the batch node draws from its own atlas
+            setStatelessMode(false);
+        }
+
         ParticleBatchNode* oldBatch = _batchNode;
 
         ParticleSystem::setBatchNode(batchNode);
@@ -608,6 +544,368 @@ ParticleSystemQuad * ParticleSystemQuad::create() {
     return nullptr;
 }
 
+bool ParticleSystemQuad::isStatelessCompatible() const
+{
+    if (_batchNode)
+        return false;
+    if (_emitterMode == Mode::RADIUS)
+        return true;
+    // radial and tangential acceleration depend on the position, which has no closed form
+    return modeA.radialAccel == 0 && modeA.radialAccelVar == 0
+        && modeA.tangentialAccel == 0 && modeA.tangentialAccelVar == 0;
+}
+
+bool ParticleSystemQuad::setStatelessMode(bool enabled)
+{
+    if (enabled == _statelessMode)
+        return true;
+    if (enabled && !isStatelessCompatible())
+        return false;
+
+    if (_simulationPending)
+    {
+        ParticleSimulator::getInstance()->flush();
+    }
+
+    // the particles of one mode can't be carried over to the other
+    ParticleSystem::resetSystem();
+    _particleCount = 0;
+    _statelessMode = enabled;
+    if (enabled)
+    {
+        setupStatelessBuffers();
+        if (!_statelessVertices)
+        {
+            _statelessMode = false;
+            return false;
+        }
+    }
+    else
+    {
+        releaseStatelessBuffers();
+    }
+    return true;
+}
+
+void ParticleSystemQuad::setupStatelessBuffers()
+{
+    releaseStatelessBuffers();
+
+    const int vertexCount = _totalParticles * 4;
+    _statelessVertices = new (std::nothrow) StatelessVertex[vertexCount];
+    if (!_statelessVertices)
+    {
+        CCLOG("cocos2d: Particle system: not enough memory");
+        return;
+    }
+    _statelessTime = 0;
+    _statelessHead = 0;
+    _statelessTail = 0;
+
+    auto* program = backend::Program::getBuiltinProgram(backend::ProgramType::PARTICLE_STATELESS);
+    _statelessProgramState = new (std::nothrow) backend::ProgramState(program);
+
+    auto vertexLayout = _statelessProgramState->getVertexLayout();
+    const auto& attributeInfo = program->getActiveAttributes();
+    auto setAttribute = [&](const char* name, std::size_t offset) {
+        auto iter = attributeInfo.find(name);
+        if (iter != attributeInfo.end())
+        {
+            vertexLayout->setAttribute(name, iter->second.location, backend::VertexFormat::FLOAT4, offset, false);
+        }
+    };
+    setAttribute("a_corner", offsetof(StatelessVertex, corner));
+    setAttribute("a_emission", offsetof(StatelessVertex, emission));
+    setAttribute("a_motion", offsetof(StatelessVertex, motion));
+    setAttribute("a_color", offsetof(StatelessVertex, color));
+    setAttribute("a_deltaColor", offsetof(StatelessVertex, deltaColor));
+    setAttribute("a_sizeRotation", offsetof(StatelessVertex, sizeRotation));
+    vertexLayout->setLayout(sizeof(StatelessVertex));
+
+    // 16 bit indices, 32 bit ones aren't supported by every GLES2 device.
+    // Stateless systems are meant to exceed 16K particles, so the ring is split over several commands.
+    const int particlesPerCommand = std::min(_totalParticles, STATELESS_PARTICLES_PER_COMMAND);
+    std::vector<unsigned short> indices(particlesPerCommand * 6);
+    for (int i = 0; i < particlesPerCommand; ++i)
+    {
+        const unsigned int i6 = i*6;
+        const unsigned int i4 = i*4;
+        indices[i6+0] = (unsigned short) i4+0;
+        indices[i6+1] = (unsigned short) i4+1;
+        indices[i6+2] = (unsigned short) i4+2;
+        indices[i6+5] = (unsigned short) i4+1;
+        indices[i6+4] = (unsigned short) i4+2;
+        indices[i6+3] = (unsigned short) i4+3;
+    }
+
+    _statelessCommands.clear();
+    _statelessCommands.resize((_totalParticles + STATELESS_PARTICLES_PER_COMMAND - 1) / STATELESS_PARTICLES_PER_COMMAND);
+    for (size_t i = 0; i < _statelessCommands.size(); ++i)
+    {
+        const int count = std::min(STATELESS_PARTICLES_PER_COMMAND, _totalParticles - (int)i * STATELESS_PARTICLES_PER_COMMAND);
+        auto& command = _statelessCommands[i];
+        command.getPipelineDescriptor().programState = _statelessProgramState;
+        command.setDrawType(CustomCommand::DrawType::ELEMENT);
+        command.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE);
+        command.createVertexBuffer(sizeof(StatelessVertex), count * 4, CustomCommand::BufferUsage::DYNAMIC);
+        command.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, count * 6, CustomCommand::BufferUsage::STATIC);
+        command.updateIndexBuffer(indices.data(), count * 6 * sizeof(unsigned short));
+    }
+
+    initStatelessCorners();
+}
+
+void ParticleSystemQuad::releaseStatelessBuffers()
+{
+    CC_SAFE_DELETE_ARRAY(_statelessVertices);
+    CC_SAFE_RELEASE_NULL(_statelessProgramState);
+    for (auto& command : _statelessCommands)
+    {
+        command.getPipelineDescriptor().programState = nullptr;
+    }
+}
+
+void ParticleSystemQuad::updateStatelessVertices(int start, int count)
+{
+    // [start, start + count) doesn't wrap around the ring, but may span several commands
+    while (count > 0)
+    {
+        const int index = start / STATELESS_PARTICLES_PER_COMMAND;
+        const int first = start - index * STATELESS_PARTICLES_PER_COMMAND;
+        const int n = std::min(count, STATELESS_PARTICLES_PER_COMMAND - first);
+        _statelessCommands[index].updateVertexBuffer(_statelessVertices + start * 4, first * 4 * sizeof(StatelessVertex),
+                                                     n * 4 * sizeof(StatelessVertex));
+        start += n;
+        count -= n;
+    }
+}
+
+void ParticleSystemQuad::initStatelessCorners()
+{
+    // same vertex order as V3F_C4B_T2F_Quad: tl, bl, tr, br
+    static const float signs[4][2] = {{-1, 1}, {-1, -1}, {1, 1}, {1, -1}};
+    for (int i = 0; i < _totalParticles; ++i)
+    {
+        const V3F_C4B_T2F* corners[4] = {&_quads[i].tl, &_quads[i].bl, &_quads[i].tr, &_quads[i].br};
+        for (int j = 0; j < 4; ++j)
+        {
+            _statelessVertices[i * 4 + j].corner.set(signs[j][0], signs[j][1], corners[j]->texCoords.u, corners[j]->texCoords.v);
+        }
+    }
+    updateStatelessVertices(0, _totalParticles);
+}
+
+void ParticleSystemQuad::emitStatelessParticles(int count)
+{
+    while (count > 0)
+    {
+        int start = _statelessHead;
+        int n = std::min(count, _totalParticles - start);
+        initParticles(start, n);
+
+        for (int i = start; i < start + n; ++i)
+        {
+            StatelessVertex record;
+            record.emission.set(_statelessTime, _particleData.timeToLive[i], _particleData.startPosX[i], _particleData.startPosY[i]);
+            if (_emitterMode == Mode::RADIUS)
+            {
+                record.motion.set(_particleData.modeB.angle[i], _particleData.modeB.degreesPerSecond[i],
+                                  _particleData.modeB.radius[i], _particleData.modeB.deltaRadius[i]);
+            }
+            else
+            {
+                record.motion.set(_particleData.posx[i], _particleData.posy[i],
+                                  _particleData.modeA.dirX[i], _particleData.modeA.dirY[i]);
+            }
+            record.color.set(_particleData.colorR[i], _particleData.colorG[i], _particleData.colorB[i], _particleData.colorA[i]);
+            record.deltaColor.set(_particleData.deltaColorR[i], _particleData.deltaColorG[i],
+                                  _particleData.deltaColorB[i], _particleData.deltaColorA[i]);
+            record.sizeRotation.set(_particleData.size[i], _particleData.deltaSize[i],
+                                    _particleData.rotation[i], _particleData.deltaRotation[i]);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                StatelessVertex& vertex = _statelessVertices[i * 4 + j];
+                record.corner = vertex.corner;
+                vertex = record;
+            }
+        }
+
+        // only the new records are uploaded
+        updateStatelessVertices(start, n);
+        _statelessHead = (start + n) % _totalParticles;
+        _particleCount += n;
+        count -= n;
+    }
+}
+
+void ParticleSystemQuad::update(float dt)
+{
+    if (!_statelessMode)
+    {
+        ParticleSystem::update(dt);
+        return;
+    }
+
+    // emitted at the start of the step, like the CPU path which emits before simulating
+    int emitCount = updateEmission(dt);
+    if (emitCount > 0 && !_paused)
+    {
+        emitStatelessParticles(emitCount);
+    }
+    _statelessTime += dt;
+
+    // retire the dead particles at the front of the ring; particles that die earlier than an older
+    // one stay counted until it dies too, the shader hides them
+    bool hadParticles = _particleCount > 0;
+    while (_particleCount > 0)
+    {
+        const Vec4& emission = _statelessVertices[_statelessTail * 4].emission;
+        if (emission.x + emission.y > _statelessTime)
+            break;
+        _statelessTail = (_statelessTail + 1) % _totalParticles;
+        --_particleCount;
+    }
+
+    if (hadParticles && _particleCount == 0 && _isAutoRemoveOnFinish)
+    {
+        _simulationFinished = true;
+        finishSimulation();
+    }
+}
+
+void ParticleSystemQuad::resetSystem()
+{
+    ParticleSystem::resetSystem();
+    if (_statelessMode && _particleCount > 0)
+    {
+        // kill the records in the ring, the clock keeps running so old records stay dead
+        for (int i = 0, slot = _statelessTail; i < _particleCount; ++i, slot = (slot + 1) % _totalParticles)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                _statelessVertices[slot * 4 + j].emission.y = 0;
+            }
+        }
+        updateStatelessVertices(0, _totalParticles);
+        _statelessTail = _statelessHead;
+        _particleCount = 0;
+    }
+}
+
+ParticleSystemQuad::StatelessUniforms ParticleSystemQuad::getStatelessUniforms() const
+{
+    Mat4 nodeToWorld = getNodeToWorldTransform();
+    ParticleSIMD::QuadTransform transform = getQuadTransform(nodeToWorld, nodeToWorld.getInversed());
+    StatelessUniforms uniforms;
+    uniforms.time = _statelessTime;
+    uniforms.gravity = modeA.gravity;
+    uniforms.startTransform.set(transform.a, transform.b, transform.c, transform.d);
+    uniforms.offset.set(transform.tx, transform.ty);
+    uniforms.yCoordFlipped = static_cast<float>(_yCoordFlipped);
+    uniforms.radiusMode = _emitterMode == Mode::RADIUS;
+    uniforms.premultipliedAlpha = _opacityModifyRGB;
+    return uniforms;
+}
+
+bool ParticleSystemQuad::evaluateStatelessVertex(const StatelessVertex& vertex, const StatelessUniforms& uniforms, Vec2* position, Color4F* color)
+{
+    // mirrors particleStateless.vert
+    float t = uniforms.time - vertex.emission.x;
+    if (t < 0 || t >= vertex.emission.y)
+        return false;
+
+    Vec2 pos;
+    if (uniforms.radiusMode)
+    {
+        float angle = vertex.motion.x + vertex.motion.y * t;
+        float radius = vertex.motion.z + vertex.motion.w * t;
+        pos.set(-cosf(angle) * radius, -sinf(angle) * uniforms.yCoordFlipped * radius);
+    }
+    else
+    {
+        pos.x = vertex.motion.x + (vertex.motion.z * t + 0.5f * uniforms.gravity.x * t * t) * uniforms.yCoordFlipped;
+        pos.y = vertex.motion.y + (vertex.motion.w * t + 0.5f * uniforms.gravity.y * t * t) * uniforms.yCoordFlipped;
+    }
+
+    const Vec4& m = uniforms.startTransform;
+    Vec2 center(pos.x + uniforms.offset.x + m.x * vertex.emission.z + m.z * vertex.emission.w,
+                pos.y + uniforms.offset.y + m.y * vertex.emission.z + m.w * vertex.emission.w);
+    float halfSize = std::max(vertex.sizeRotation.x + vertex.sizeRotation.y * t, 0.0f) * 0.5f;
+    float r = -CC_DEGREES_TO_RADIANS(vertex.sizeRotation.z + vertex.sizeRotation.w * t);
+    float hc = halfSize * cosf(r);
+    float hs = halfSize * sinf(r);
+    position->set(center.x + vertex.corner.x * hc - vertex.corner.y * hs,
+                  center.y + vertex.corner.x * hs + vertex.corner.y * hc);
+
+    Vec4 c = vertex.color + vertex.deltaColor * t;
+    if (uniforms.premultipliedAlpha)
+    {
+        c.x *= c.w;
+        c.y *= c.w;
+        c.z *= c.w;
+    }
+    color->r = clampf(c.x, 0, 1);
+    color->g = clampf(c.y, 0, 1);
+    color->b = clampf(c.z, 0, 1);
+    color->a = clampf(c.w, 0, 1);
+    return true;
+}
+
+bool ParticleSystemQuad::canAutoBatch()
+{
+    if (!_autoBatch || _particleCount > ParticleQuadBatcher::MAX_QUADS_PER_BATCH)
+        return false;
+
+    // the batches are drawn with the default program, a custom one would be dropped
+    auto programState = _quadCommand.getPipelineDescriptor().programState;
+    return programState == _programState
+        && programState->getProgram()->getProgramType() == backend::ProgramType::POSITION_TEXTURE_COLOR;
+}
+
+void ParticleSystemQuad::drawStateless(Renderer *renderer, const Mat4 &transform)
+{
+    if (_particleCount <= 0)
+        return;
+
+    auto programState = _statelessProgramState;
+    programState->setTexture(programState->getUniformLocation("u_texture"), 0, _texture->getBackendTexture());
+
+    const auto& projectionMat = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Mat4 mvpMatrix = projectionMat * transform;
+    programState->setUniform(programState->getUniformLocation("u_MVPMatrix"), mvpMatrix.m, sizeof(mvpMatrix.m));
+
+    StatelessUniforms uniforms = getStatelessUniforms();
+    Vec4 flags(uniforms.yCoordFlipped, uniforms.radiusMode ? 1.0f : 0.0f, uniforms.premultipliedAlpha ? 1.0f : 0.0f, 0.0f);
+    programState->setUniform(programState->getUniformLocation("u_time"), &uniforms.time, sizeof(uniforms.time));
+    programState->setUniform(programState->getUniformLocation("u_gravity"), &uniforms.gravity, sizeof(uniforms.gravity));
+    programState->setUniform(programState->getUniformLocation("u_startTransform"), &uniforms.startTransform, sizeof(uniforms.startTransform));
+    programState->setUniform(programState->getUniformLocation("u_offset"), &uniforms.offset, sizeof(uniforms.offset));
+    programState->setUniform(programState->getUniformLocation("u_flags"), &flags, sizeof(flags));
+
+    // once the ring wrapped the live range may be split, the shader hides the dead slots in between
+    int first = 0;
+    int last = _totalParticles;
+    if (_statelessTail < _statelessHead)
+    {
+        first = _statelessTail;
+        last = _statelessHead;
+    }
+    for (size_t i = 0; i < _statelessCommands.size(); ++i)
+    {
+        const int commandFirst = (int)i * STATELESS_PARTICLES_PER_COMMAND;
+        const int begin = std::max(first, commandFirst);
+        const int end = std::min(last, commandFirst + STATELESS_PARTICLES_PER_COMMAND);
+        if (begin >= end)
+            continue;
+
+        auto& command = _statelessCommands[i];
+        command.setIndexDrawInfo((begin - commandFirst) * 6, (end - begin) * 6);
+        command.init(_globalZOrder, _blendFunc);
+        renderer->addCommand(&command);
+    }
+}
+
 std::string ParticleSystemQuad::getDescription() const
 {
     return StringUtils::format("<ParticleSystemQuad | Tag = %d, Total Particles = %d>", _tag, _totalParticles);
@@ -30,11 +30,13 @@ THE SOFTWARE.
 
 #include "2d/CCParticleSystem.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCCustomCommand.h"
 
 NS_CC_BEGIN
 
 class SpriteFrame;
 class EventCustom;
+namespace ParticleSIMD { struct QuadTransform; }
 
 /**
  * @addtogroup _2d
@@ -52,6 +54,8 @@ Special features and Limitations:
 - The particles can be rotated.
 - It supports subrects.
 - It supports batched rendering since 1.1.
+- In stateless mode the particles are evaluated in the vertex shader, see setStatelessMode().
+- Systems scattered across the scene graph can share draw calls, see setAutoBatchEnabled().
 @since v0.8
 @js NA
 */
@@ -138,6 +142,66 @@ public:
     virtual void setTotalParticles(int tp) override;
 
     virtual std::string getDescription() const override;
+
+    /** Per vertex record of a particle in stateless mode, written once when the particle is emitted. */
+    struct StatelessVertex
+    {
+        Vec4 corner;        // corner sign x, y and texture coordinates
+        Vec4 emission;      // emission time, life, start position x, y
+        Vec4 motion;        // gravity: position x, y, velocity x, y. radius: angle, angular speed, radius, radius speed
+        Vec4 color;
+        Vec4 deltaColor;
+        Vec4 sizeRotation;  // size, size speed, rotation, rotation speed
+    };
+
+    /** Per frame uniforms of the stateless vertex shader. */
+    struct StatelessUniforms
+    {
+        float time;
+        Vec2 gravity;
+        Vec4 startTransform;    // a, b, c, d of the affine map from start positions to node space
+        Vec2 offset;            // its translation
+        float yCoordFlipped;
+        bool radiusMode;
+        bool premultipliedAlpha;
+    };
+
+    /** Evaluates the particles in the vertex shader instead of simulating them on the CPU.
+     Each particle's position, color, size and rotation are closed form functions of its emission record,
+     so the CPU only writes the records of newly emitted particles into a ring buffer and nothing is
+     uploaded per frame for existing particles. In gravity mode the motion is integrated exactly rather
+     than per frame, which differs from the CPU path by half a frame of gravity.
+     @return False when the system can't run stateless, see isStatelessCompatible().
+     */
+    bool setStatelessMode(bool enabled);
+    bool isStatelessMode() const { return _statelessMode; }
+
+    /** Whether the configuration has a closed form: radius mode, or gravity mode without radial and
+     tangential acceleration, and not drawn through a ParticleBatchNode. Checked when the mode is enabled.
+     */
+    bool isStatelessCompatible() const;
+
+    /** The records of the ring buffer, getTotalParticles() * 4 vertices, nullptr when not in stateless mode. */
+    const StatelessVertex* getStatelessVertices() const { return _statelessVertices; }
+    /** The uniforms the next draw would use. */
+    StatelessUniforms getStatelessUniforms() const;
+
+    /** CPU reference of the stateless vertex shader, for checking the GPU results without a renderer.
+     @return False when the particle isn't alive at uniforms.time, position and color are left untouched then.
+     */
+    static bool evaluateStatelessVertex(const StatelessVertex& vertex, const StatelessUniforms& uniforms, Vec2* position, Color4F* color);
+
+    /** Hands the quads to the ParticleQuadBatcher instead of queueing an own command, so systems with the
+     same texture, blend function and global Z order are drawn together wherever they are in the scene graph.
+     They are drawn at the position of the first of them in the frame, nodes of the same global Z order
+     drawn in between may end up below later systems. Ignored in stateless mode, in a ParticleBatchNode, with a
+     custom program state and in frames with more than ParticleQuadBatcher::MAX_QUADS_PER_BATCH live particles.
+     */
+    void setAutoBatchEnabled(bool enabled) { _autoBatch = enabled; }
+    bool isAutoBatchEnabled() const { return _autoBatch; }
+
+    virtual void update(float dt) override;
+    virtual void resetSystem() override;
     
 CC_CONSTRUCTOR_ACCESS:
     /**
@@ -169,13 +233,33 @@ protected:
 
     bool allocMemory();
 
+    /** Maps particle start positions to node space for the current position type and the given transforms. */
+    ParticleSIMD::QuadTransform getQuadTransform(const Mat4& nodeToWorld, const Mat4& worldToNode) const;
+
+    void setupStatelessBuffers();
+    void releaseStatelessBuffers();
+    void updateStatelessVertices(int start, int count);
+    void initStatelessCorners();
+    void emitStatelessParticles(int count);
+    bool canAutoBatch();
+    void drawStateless(Renderer *renderer, const Mat4 &transform);
+
     V3F_C4B_T2F_Quad    *_quads = nullptr;        // quads to be rendered
     unsigned short      *_indices = nullptr;      // indices
 
     QuadCommand _quadCommand;           // quad command
     
     backend::UniformLocation _mvpMatrixLocaiton;
-    backend::UniformLocation _textureLocation;    
+    backend::UniformLocation _textureLocation;
+
+    bool _autoBatch = false;
+    bool _statelessMode = false;
+    float _statelessTime = 0;
+    int _statelessHead = 0;                         // next slot written
+    int _statelessTail = 0;                         // oldest slot that may be alive
+    StatelessVertex* _statelessVertices = nullptr;
+    std::vector<CustomCommand> _statelessCommands;    // 16 bit indices limit a command to 16383 particles, larger rings use several
+    backend::ProgramState* _statelessProgramState = nullptr;    
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystemQuad);
 };
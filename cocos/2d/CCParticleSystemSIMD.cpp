@@ -0,0 +1,551 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParticleSystemSIMD.h"
+
+#include <math.h>
+#include <float.h>
+#include "base/ccMacros.h"
+
+// USE_PARTICLE_SSE     : SSE2 kernels
+// USE_PARTICLE_NEON    : NEON kernels, USE_PARTICLE_NEON64 adds the AArch64 only instructions
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define USE_PARTICLE_SSE
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+    #define USE_PARTICLE_NEON
+    #if defined(__arm64__) || defined(__aarch64__)
+        #define USE_PARTICLE_NEON64
+    #endif
+    #include <arm_neon.h>
+#endif
+
+#if defined(USE_PARTICLE_SSE) || defined(USE_PARTICLE_NEON)
+    #define USE_PARTICLE_SIMD
+#endif
+
+NS_CC_BEGIN
+
+namespace ParticleSIMD
+{
+
+namespace
+{
+    inline uint32_t xorshift(uint32_t x)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return x;
+    }
+
+    // The top 23 bits of the state become the mantissa of a float in [2, 4).
+    inline float toM11(uint32_t x)
+    {
+        union {
+            uint32_t d;
+            float f;
+        } u;
+        u.d = (x >> 9) | 0x40000000;
+        return u.f - 3.0f;
+    }
+
+    const float HALF_PI_INV = 0.636619772367581343f;
+    // pi/2 split in three parts for an exact range reduction
+    const float HALF_PI_1 = 1.5703125f;
+    const float HALF_PI_2 = 4.837512969970703125e-4f;
+    const float HALF_PI_3 = 7.54978995489188216e-8f;
+
+#ifdef USE_PARTICLE_SSE
+    typedef __m128 vfloat;
+    typedef __m128 vmask;
+    typedef __m128i vint;
+
+    inline vfloat vload(const float* p) { return _mm_loadu_ps(p); }
+    inline void vstore(float* p, vfloat v) { _mm_storeu_ps(p, v); }
+    inline vfloat vset(float f) { return _mm_set1_ps(f); }
+    inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+    inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+    inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+    inline vfloat vdiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+    inline vfloat vmin(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+    inline vfloat vmax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+    inline vfloat vrsqrt(vfloat a) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a)); }
+    inline vmask vgreater(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+    inline vfloat vselect(vmask m, vfloat a, vfloat b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    inline vint vround(vfloat a) { return _mm_cvtps_epi32(a); }
+    inline vint vtruncate(vfloat a) { return _mm_cvttps_epi32(a); }
+    inline vfloat vtofloat(vint a) { return _mm_cvtepi32_ps(a); }
+    inline vmask vbitset(vint a, int bit) { return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, _mm_set1_epi32(bit)), _mm_set1_epi32(bit))); }
+    inline void vstoreint(int32_t* p, vint v) { _mm_storeu_si128((__m128i*)p, v); }
+
+    inline vint vloadstate(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    inline void vstorestate(uint32_t* p, vint v) { _mm_storeu_si128((__m128i*)p, v); }
+    inline vint vxorshift(vint x)
+    {
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    }
+    inline vfloat vtoM11(vint x)
+    {
+        vint bits = _mm_or_si128(_mm_srli_epi32(x, 9), _mm_set1_epi32(0x40000000));
+        return _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(3.0f));
+    }
+#endif // USE_PARTICLE_SSE
+
+#ifdef USE_PARTICLE_NEON
+    typedef float32x4_t vfloat;
+    typedef uint32x4_t vmask;
+    typedef int32x4_t vint;
+
+    inline vfloat vload(const float* p) { return vld1q_f32(p); }
+    inline void vstore(float* p, vfloat v) { vst1q_f32(p, v); }
+    inline vfloat vset(float f) { return vdupq_n_f32(f); }
+    inline vfloat vadd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+    inline vfloat vsub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+    inline vfloat vmul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+    inline vfloat vmin(vfloat a, vfloat b) { return vminq_f32(a, b); }
+    inline vfloat vmax(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+#ifdef USE_PARTICLE_NEON64
+    inline vfloat vdiv(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+    inline vfloat vrsqrt(vfloat a) { return vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(a)); }
+    inline vint vround(vfloat a) { return vcvtnq_s32_f32(a); }
+#else
+    // ARMv7 has no vector divide or square root, refine the estimates with two Newton-Raphson steps.
+    inline vfloat vdiv(vfloat a, vfloat b)
+    {
+        vfloat r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+    inline vfloat vrsqrt(vfloat a)
+    {
+        vfloat r = vrsqrteq_f32(a);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        return r;
+    }
+    inline vint vround(vfloat a)
+    {
+        vfloat half = vbslq_f32(vcltq_f32(a, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+        return vcvtq_s32_f32(vaddq_f32(a, half));
+    }
+#endif
+    inline vmask vgreater(vfloat a, vfloat b) { return vcgtq_f32(a, b); }
+    inline vfloat vselect(vmask m, vfloat a, vfloat b) { return vbslq_f32(m, a, b); }
+    inline vint vtruncate(vfloat a) { return vcvtq_s32_f32(a); }
+    inline vfloat vtofloat(vint a) { return vcvtq_f32_s32(a); }
+    inline vmask vbitset(vint a, int bit) { return vtstq_s32(a, vdupq_n_s32(bit)); }
+    inline void vstoreint(int32_t* p, vint v) { vst1q_s32(p, v); }
+
+    inline uint32x4_t vloadstate(const uint32_t* p) { return vld1q_u32(p); }
+    inline void vstorestate(uint32_t* p, uint32x4_t v) { vst1q_u32(p, v); }
+    inline uint32x4_t vxorshift(uint32x4_t x)
+    {
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        return veorq_u32(x, vshlq_n_u32(x, 5));
+    }
+    inline vfloat vtoM11(uint32x4_t x)
+    {
+        uint32x4_t bits = vorrq_u32(vshrq_n_u32(x, 9), vdupq_n_u32(0x40000000));
+        return vsubq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(3.0f));
+    }
+#endif // USE_PARTICLE_NEON
+
+#ifdef USE_PARTICLE_SIMD
+    inline vfloat vneg(vfloat a) { return vsub(vset(0.0f), a); }
+
+    // Cephes style sine and cosine, accurate to a couple of ulps for the angle range particles reach.
+    inline void vsincos(vfloat x, vfloat* outSin, vfloat* outCos)
+    {
+        vint quadrant = vround(vmul(x, vset(HALF_PI_INV)));
+        vfloat q = vtofloat(quadrant);
+        x = vsub(x, vmul(q, vset(HALF_PI_1)));
+        x = vsub(x, vmul(q, vset(HALF_PI_2)));
+        x = vsub(x, vmul(q, vset(HALF_PI_3)));
+
+        vfloat x2 = vmul(x, x);
+        vfloat s = vadd(vmul(vset(-1.9515295891e-4f), x2), vset(8.3321608736e-3f));
+        s = vadd(vmul(s, x2), vset(-1.6666654611e-1f));
+        s = vadd(vmul(vmul(s, x2), x), x);
+        vfloat c = vadd(vmul(vset(2.443315711809948e-5f), x2), vset(-1.388731625493765e-3f));
+        c = vadd(vmul(c, x2), vset(4.166664568298827e-2f));
+        c = vadd(vsub(vmul(vmul(c, x2), x2), vmul(x2, vset(0.5f))), vset(1.0f));
+
+        vmask swap = vbitset(quadrant, 1);
+        vfloat sinValue = vselect(swap, c, s);
+        vfloat cosValue = vselect(swap, s, c);
+        *outSin = vselect(vbitset(quadrant, 2), vneg(sinValue), sinValue);
+        *outCos = vselect(vbitset(vtruncate(vadd(q, vset(1.0f))), 2), vneg(cosValue), cosValue);
+    }
+#endif // USE_PARTICLE_SIMD
+
+    inline uint8_t toColorByte(float value)
+    {
+        return (uint8_t)clampf(value * 255, 0, 255);
+    }
+}
+
+RandomM11::RandomM11(uint32_t seed)
+: lane(0)
+{
+    // xorshift must never be seeded with zero
+    seed = seed * 2654435761u + 1;
+    for (int i = 0; i < 4; ++i)
+    {
+        seed = xorshift(seed ? seed : 0x9e3779b9);
+        state[i] = seed;
+    }
+}
+
+float RandomM11::next()
+{
+    unsigned int i = lane++ & 3;
+    state[i] = xorshift(state[i]);
+    return toM11(state[i]);
+}
+
+void fillRandom(float* out, int count, float base, float variance, RandomM11& rng)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    auto state = vloadstate(rng.state);
+    vfloat vbase = vset(base);
+    vfloat vvariance = vset(variance);
+    for (; i + 4 <= count; i += 4)
+    {
+        state = vxorshift(state);
+        vstore(out + i, vadd(vbase, vmul(vvariance, vtoM11(state))));
+    }
+    vstorestate(rng.state, state);
+#endif
+    for (; i < count; ++i)
+    {
+        out[i] = base + variance * rng.next();
+    }
+}
+
+void fillRandomClamped(float* out, int count, float base, float variance, float minValue, float maxValue, RandomM11& rng)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    auto state = vloadstate(rng.state);
+    vfloat vbase = vset(base);
+    vfloat vvariance = vset(variance);
+    vfloat vminValue = vset(minValue);
+    vfloat vmaxValue = vset(maxValue);
+    for (; i + 4 <= count; i += 4)
+    {
+        state = vxorshift(state);
+        vfloat value = vadd(vbase, vmul(vvariance, vtoM11(state)));
+        vstore(out + i, vmin(vmax(value, vminValue), vmaxValue));
+    }
+    vstorestate(rng.state, state);
+#endif
+    for (; i < count; ++i)
+    {
+        out[i] = clampf(base + variance * rng.next(), minValue, maxValue);
+    }
+}
+
+void deltaOverLife(float* delta, const float* start, const float* timeToLive, int count)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    for (; i + 4 <= count; i += 4)
+    {
+        vstore(delta + i, vdiv(vsub(vload(delta + i), vload(start + i)), vload(timeToLive + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        delta[i] = (delta[i] - start[i]) / timeToLive[i];
+    }
+}
+
+void polarToCartesian(float* x, float* y, int count)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    for (; i + 4 <= count; i += 4)
+    {
+        vfloat s, c;
+        vsincos(vload(x + i), &s, &c);
+        vfloat length = vload(y + i);
+        vstore(x + i, vmul(c, length));
+        vstore(y + i, vmul(s, length));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float length = y[i];
+        y[i] = sinf(x[i]) * length;
+        x[i] = cosf(x[i]) * length;
+    }
+}
+
+void integrate(float* value, const float* delta, int count, float dt)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    vfloat vdt = vset(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        vstore(value + i, vadd(vload(value + i), vmul(vload(delta + i), vdt)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        value[i] += delta[i] * dt;
+    }
+}
+
+void integrateClampZero(float* value, const float* delta, int count, float dt)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    vfloat vdt = vset(dt);
+    vfloat zero = vset(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        vstore(value + i, vmax(vadd(vload(value + i), vmul(vload(delta + i), vdt)), zero));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        value[i] = MAX(0, value[i] + delta[i] * dt);
+    }
+}
+
+void updateGravity(float* posx, float* posy, float* dirX, float* dirY,
+                   const float* radialAccel, const float* tangentialAccel, int count,
+                   const Vec2& gravity, float dt, float yCoordFlipped)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    vfloat vdt = vset(dt);
+    vfloat vgravityX = vset(gravity.x);
+    vfloat vgravityY = vset(gravity.y);
+    vfloat vmove = vset(dt * yCoordFlipped);
+    vfloat tolerance = vset(FLT_MIN);
+    vfloat zero = vset(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        vfloat x = vload(posx + i);
+        vfloat y = vload(posy + i);
+        vfloat lengthSq = vadd(vmul(x, x), vmul(y, y));
+        // particles sitting on the emitter get no radial direction
+        vmask valid = vgreater(lengthSq, tolerance);
+        vfloat inv = vselect(valid, vrsqrt(vselect(valid, lengthSq, vset(1.0f))), zero);
+        vfloat nx = vmul(x, inv);
+        vfloat ny = vmul(y, inv);
+
+        vfloat radial = vload(radialAccel + i);
+        vfloat tangential = vload(tangentialAccel + i);
+        vfloat accelX = vadd(vsub(vmul(nx, radial), vmul(ny, tangential)), vgravityX);
+        vfloat accelY = vadd(vadd(vmul(ny, radial), vmul(nx, tangential)), vgravityY);
+
+        vfloat dx = vadd(vload(dirX + i), vmul(accelX, vdt));
+        vfloat dy = vadd(vload(dirY + i), vmul(accelY, vdt));
+        vstore(dirX + i, dx);
+        vstore(dirY + i, dy);
+        vstore(posx + i, vadd(x, vmul(dx, vmove)));
+        vstore(posy + i, vadd(y, vmul(dy, vmove)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float x = posx[i];
+        float y = posy[i];
+        float nx = 0.0f, ny = 0.0f;
+        float lengthSq = x * x + y * y;
+        if (lengthSq > FLT_MIN)
+        {
+            float inv = 1.0f / sqrtf(lengthSq);
+            nx = x * inv;
+            ny = y * inv;
+        }
+
+        // (gravity + radial + tangential) * dt
+        dirX[i] += (nx * radialAccel[i] - ny * tangentialAccel[i] + gravity.x) * dt;
+        dirY[i] += (ny * radialAccel[i] + nx * tangentialAccel[i] + gravity.y) * dt;
+
+        posx[i] = x + dirX[i] * dt * yCoordFlipped;
+        posy[i] = y + dirY[i] * dt * yCoordFlipped;
+    }
+}
+
+void updateRadius(float* posx, float* posy, float* angle, float* radius,
+                  const float* degreesPerSecond, const float* deltaRadius, int count,
+                  float dt, float yCoordFlipped)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    vfloat vdt = vset(dt);
+    vfloat vflip = vset(-yCoordFlipped);
+    vfloat minusOne = vset(-1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        vfloat a = vadd(vload(angle + i), vmul(vload(degreesPerSecond + i), vdt));
+        vfloat r = vadd(vload(radius + i), vmul(vload(deltaRadius + i), vdt));
+        vstore(angle + i, a);
+        vstore(radius + i, r);
+
+        vfloat s, c;
+        vsincos(a, &s, &c);
+        vstore(posx + i, vmul(vmul(c, r), minusOne));
+        vstore(posy + i, vmul(vmul(s, r), vflip));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        angle[i] += degreesPerSecond[i] * dt;
+        radius[i] += deltaRadius[i] * dt;
+        posx[i] = - cosf(angle[i]) * radius[i];
+        posy[i] = - sinf(angle[i]) * radius[i] * yCoordFlipped;
+    }
+}
+
+void updateQuadPositions(V3F_C4B_T2F_Quad* quads, const float* x, const float* y,
+                         const float* startX, const float* startY,
+                         const float* size, const float* rotation, int count,
+                         const QuadTransform& transform)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    vfloat ta = vset(transform.a);
+    vfloat tb = vset(transform.b);
+    vfloat tc = vset(transform.c);
+    vfloat td = vset(transform.d);
+    vfloat ttx = vset(transform.tx);
+    vfloat tty = vset(transform.ty);
+    vfloat toRadians = vset(-(float)M_PI / 180.0f);
+    vfloat half = vset(0.5f);
+    for (; i + 4 <= count; i += 4)
+    {
+        vfloat sx = vload(startX + i);
+        vfloat sy = vload(startY + i);
+        vfloat cx = vadd(vadd(vload(x + i), ttx), vadd(vmul(ta, sx), vmul(tc, sy)));
+        vfloat cy = vadd(vadd(vload(y + i), tty), vadd(vmul(tb, sx), vmul(td, sy)));
+
+        vfloat sr, cr;
+        vsincos(vmul(vload(rotation + i), toRadians), &sr, &cr);
+        vfloat halfSize = vmul(vload(size + i), half);
+        vfloat hc = vmul(halfSize, cr);
+        vfloat hs = vmul(halfSize, sr);
+
+        // corners for four quads, transposed back to AoS below
+        float corners[8][4];
+        vstore(corners[0], vadd(vsub(cx, hc), hs)); // bl
+        vstore(corners[1], vsub(vsub(cy, hs), hc));
+        vstore(corners[2], vadd(vadd(cx, hc), hs)); // br
+        vstore(corners[3], vsub(vadd(cy, hs), hc));
+        vstore(corners[4], vsub(vadd(cx, hc), hs)); // tr
+        vstore(corners[5], vadd(vadd(cy, hs), hc));
+        vstore(corners[6], vsub(vsub(cx, hc), hs)); // tl
+        vstore(corners[7], vadd(vsub(cy, hs), hc));
+
+        for (int j = 0; j < 4; ++j)
+        {
+            V3F_C4B_T2F_Quad* quad = quads + i + j;
+            quad->bl.vertices.x = corners[0][j];
+            quad->bl.vertices.y = corners[1][j];
+            quad->br.vertices.x = corners[2][j];
+            quad->br.vertices.y = corners[3][j];
+            quad->tr.vertices.x = corners[4][j];
+            quad->tr.vertices.y = corners[5][j];
+            quad->tl.vertices.x = corners[6][j];
+            quad->tl.vertices.y = corners[7][j];
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float cx = x[i] + transform.a * startX[i] + transform.c * startY[i] + transform.tx;
+        float cy = y[i] + transform.b * startX[i] + transform.d * startY[i] + transform.ty;
+
+        float r = (float)-CC_DEGREES_TO_RADIANS(rotation[i]);
+        float halfSize = size[i] / 2;
+        float hc = halfSize * cosf(r);
+        float hs = halfSize * sinf(r);
+
+        V3F_C4B_T2F_Quad* quad = quads + i;
+        quad->bl.vertices.x = cx - hc + hs;
+        quad->bl.vertices.y = cy - hs - hc;
+        quad->br.vertices.x = cx + hc + hs;
+        quad->br.vertices.y = cy + hs - hc;
+        quad->tr.vertices.x = cx + hc - hs;
+        quad->tr.vertices.y = cy + hs + hc;
+        quad->tl.vertices.x = cx - hc - hs;
+        quad->tl.vertices.y = cy - hs + hc;
+    }
+}
+
+void updateQuadColors(V3F_C4B_T2F_Quad* quads, const float* r, const float* g,
+                      const float* b, const float* a, int count, bool premultiplyAlpha)
+{
+    int i = 0;
+#ifdef USE_PARTICLE_SIMD
+    vfloat zero = vset(0.0f);
+    vfloat scale = vset(255.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        vfloat va = vmin(vmax(vmul(vload(a + i), scale), zero), scale);
+        vfloat rgbScale = premultiplyAlpha ? vmul(vload(a + i), scale) : scale;
+
+        int32_t channels[4][4];
+        vstoreint(channels[0], vtruncate(vmin(vmax(vmul(vload(r + i), rgbScale), zero), scale)));
+        vstoreint(channels[1], vtruncate(vmin(vmax(vmul(vload(g + i), rgbScale), zero), scale)));
+        vstoreint(channels[2], vtruncate(vmin(vmax(vmul(vload(b + i), rgbScale), zero), scale)));
+        vstoreint(channels[3], vtruncate(va));
+
+        for (int j = 0; j < 4; ++j)
+        {
+            Color4B color((uint8_t)channels[0][j], (uint8_t)channels[1][j], (uint8_t)channels[2][j], (uint8_t)channels[3][j]);
+            V3F_C4B_T2F_Quad* quad = quads + i + j;
+            quad->bl.colors = color;
+            quad->br.colors = color;
+            quad->tl.colors = color;
+            quad->tr.colors = color;
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float alpha = premultiplyAlpha ? a[i] : 1.0f;
+        Color4B color(toColorByte(r[i] * alpha), toColorByte(g[i] * alpha), toColorByte(b[i] * alpha), toColorByte(a[i]));
+        V3F_C4B_T2F_Quad* quad = quads + i;
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
+    }
+}
+
+} // namespace ParticleSIMD
+
+NS_CC_END
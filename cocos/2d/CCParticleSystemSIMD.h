@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+/// @cond DO_NOT_SHOW
+
+#include <stdint.h>
+#include "platform/CCPlatformMacros.h"
+#include "base/ccTypes.h"
+
+NS_CC_BEGIN
+
+/**
+ * Update kernels shared by ParticleSystem and ParticleSystemQuad.
+ * They work on the SoA arrays of ParticleData four particles at a time with SSE2 or NEON,
+ * and fall back to plain loops for the remainder and on other targets.
+ */
+namespace ParticleSIMD
+{
+    /** Four xorshift generators producing floats in [-1, 1), one lane per particle. */
+    struct CC_DLL RandomM11
+    {
+        explicit RandomM11(uint32_t seed);
+
+        float next();
+
+        uint32_t state[4];
+        unsigned int lane;
+    };
+
+    /** out[i] = base + variance * random */
+    CC_DLL void fillRandom(float* out, int count, float base, float variance, RandomM11& rng);
+    /** out[i] = clamp(base + variance * random, minValue, maxValue) */
+    CC_DLL void fillRandomClamped(float* out, int count, float base, float variance, float minValue, float maxValue, RandomM11& rng);
+    /** delta[i] = (delta[i] - start[i]) / timeToLive[i], turning an end value stored in delta into a per second delta. */
+    CC_DLL void deltaOverLife(float* delta, const float* start, const float* timeToLive, int count);
+    /** Turns angles in radians (x) and lengths (y) into cartesian vectors in place. */
+    CC_DLL void polarToCartesian(float* x, float* y, int count);
+
+    /** value[i] += delta[i] * dt */
+    CC_DLL void integrate(float* value, const float* delta, int count, float dt);
+    /** value[i] = max(0, value[i] + delta[i] * dt) */
+    CC_DLL void integrateClampZero(float* value, const float* delta, int count, float dt);
+
+    /** Gravity mode: radial and tangential acceleration, gravity and position integration in one pass. */
+    CC_DLL void updateGravity(float* posx, float* posy, float* dirX, float* dirY,
+                              const float* radialAccel, const float* tangentialAccel, int count,
+                              const Vec2& gravity, float dt, float yCoordFlipped);
+    /** Radius mode: angle and radius integration followed by the polar to cartesian conversion. */
+    CC_DLL void updateRadius(float* posx, float* posy, float* angle, float* radius,
+                             const float* degreesPerSecond, const float* deltaRadius, int count,
+                             float dt, float yCoordFlipped);
+
+    /**
+     * Affine mapping from a particle to its quad center:
+     * center = (x + a * startX + c * startY + tx, y + b * startX + d * startY + ty).
+     */
+    struct QuadTransform
+    {
+        float a, b, c, d, tx, ty;
+    };
+
+    /** Writes the rotated and scaled corners of count quads. */
+    CC_DLL void updateQuadPositions(V3F_C4B_T2F_Quad* quads, const float* x, const float* y,
+                                    const float* startX, const float* startY,
+                                    const float* size, const float* rotation, int count,
+                                    const QuadTransform& transform);
+    /** Writes the vertex colors of count quads, optionally premultiplied by alpha. */
+    CC_DLL void updateQuadColors(V3F_C4B_T2F_Quad* quads, const float* r, const float* g,
+                                 const float* b, const float* a, int count, bool premultiplyAlpha);
+}
+
+NS_CC_END
+
+/// @endcond
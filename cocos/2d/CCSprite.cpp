@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteFrameCache.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureStreamer.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
@@ -1095,6 +1096,39 @@ void Sprite::updateTransform()
 }
 
 // draw
+void Sprite::requestTextureDensity(const Mat4& transform)
+{
+    auto camera = Camera::getVisitingCamera();
+    if (camera == nullptr || _rect.size.width <= 0 || _rect.size.height <= 0)
+        return;
+
+    // measure the sprite's edges on screen, the streamer picks the mipmap level from the texels per pixel
+    Vec3 origin(0, 0, 0);
+    Vec3 right(_contentSize.width, 0, 0);
+    Vec3 top(0, _contentSize.height, 0);
+    transform.transformPoint(&origin);
+    transform.transformPoint(&right);
+    transform.transformPoint(&top);
+
+    Vec2 screenOrigin = camera->projectGL(origin);
+    float screenWidth = camera->projectGL(right).distance(screenOrigin);
+    float screenHeight = camera->projectGL(top).distance(screenOrigin);
+
+    auto glView = Director::getInstance()->getOpenGLView();
+    if (glView)
+    {
+        screenWidth *= glView->getScaleX() * glView->getRetinaFactor();
+        screenHeight *= glView->getScaleY() * glView->getRetinaFactor();
+    }
+
+    Size rectInPixels = CC_SIZE_POINTS_TO_PIXELS(_rect.size);
+    if (_rectRotated)
+        std::swap(rectInPixels.width, rectInPixels.height);
+
+    float density = std::min(rectInPixels.width / std::max(screenWidth, 1.0f), rectInPixels.height / std::max(screenHeight, 1.0f));
+    TextureStreamer::getInstance()->requestTexelDensity(_texture, density);
+}
+
 void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if (_texture == nullptr || _texture->getBackendTexture() == nullptr)
@@ -1118,6 +1152,9 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if(_insideBounds)
 #endif
     {
+        if (_texture->isStreamed())
+            requestTextureDensity(transform);
+
         _trianglesCommand.init(_globalZOrder,
                                _texture,
                                _blendFunc,
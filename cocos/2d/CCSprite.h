@@ -642,6 +642,7 @@ protected:
     void populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad);
     void setMVPMatrixUniform();
     void setProgramState(backend::ProgramType type);
+    void requestTextureDensity(const Mat4& transform);
     //
     // Data used when the sprite is rendered using a SpriteSheet
     //
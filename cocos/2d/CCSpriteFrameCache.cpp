@@ -51,6 +51,169 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+namespace
+{
+    /*
+    Binary sprite sheet layout, all values little endian:
+
+    BinarySheetHeader | BinarySheetFrame[frameCount] | BinarySheetAlias[aliasCount] | int32[polygonDataCount] | string table
+
+    Strings are referenced by their byte offset in the string table and are '\0' terminated.
+    The polygon data of a frame is vertexCount vertex coordinates, vertexCount uv coordinates and indexCount triangle indices.
+    */
+    const char BINARY_SHEET_MAGIC[4] = { 'C', 'C', 'S', 'F' };
+    const uint16_t BINARY_SHEET_VERSION = 1;
+    const uint32_t BINARY_SHEET_NO_STRING = 0xffffffff;
+    const char BINARY_SHEET_EXTENSION[] = ".ccsf";
+
+    struct BinarySheetHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t polygonDataCount;
+        uint32_t stringTableSize;
+        uint32_t textureFileName;
+        uint32_t pixelFormat;
+        float textureWidth;
+        float textureHeight;
+    };
+
+    struct BinarySheetFrame
+    {
+        uint32_t name;
+        float rect[4];
+        float offset[2];
+        float sourceSize[2];
+        float anchor[2];
+        uint8_t rotated;
+        uint8_t hasAnchor;
+        uint16_t reserved;
+        uint32_t polygonData;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+    };
+
+    struct BinarySheetAlias
+    {
+        uint32_t name;
+        uint32_t frame;
+    };
+
+    // points into the loaded file, nothing is copied
+    struct BinarySheetView
+    {
+        const BinarySheetHeader* header = nullptr;
+        const BinarySheetFrame* frames = nullptr;
+        const BinarySheetAlias* aliases = nullptr;
+        const int32_t* polygonData = nullptr;
+        const char* strings = nullptr;
+
+        bool init(const Data& data)
+        {
+            const unsigned char* bytes = data.getBytes();
+            size_t size = static_cast<size_t>(data.getSize());
+            if (bytes == nullptr || size < sizeof(BinarySheetHeader))
+                return false;
+
+            header = reinterpret_cast<const BinarySheetHeader*>(bytes);
+            if (memcmp(header->magic, BINARY_SHEET_MAGIC, sizeof(BINARY_SHEET_MAGIC)) != 0 || header->version != BINARY_SHEET_VERSION)
+                return false;
+
+            size_t framesOffset = sizeof(BinarySheetHeader);
+            size_t aliasesOffset = framesOffset + sizeof(BinarySheetFrame) * header->frameCount;
+            size_t polygonOffset = aliasesOffset + sizeof(BinarySheetAlias) * header->aliasCount;
+            size_t stringsOffset = polygonOffset + sizeof(int32_t) * header->polygonDataCount;
+            if (stringsOffset + header->stringTableSize != size || header->stringTableSize == 0)
+                return false;
+
+            frames = reinterpret_cast<const BinarySheetFrame*>(bytes + framesOffset);
+            aliases = reinterpret_cast<const BinarySheetAlias*>(bytes + aliasesOffset);
+            polygonData = reinterpret_cast<const int32_t*>(bytes + polygonOffset);
+            strings = reinterpret_cast<const char*>(bytes + stringsOffset);
+
+            // every string lookup stops at the last '\0' at worst
+            if (strings[header->stringTableSize - 1] != '\0')
+                return false;
+
+            for (uint32_t i = 0; i < header->frameCount; ++i)
+            {
+                const BinarySheetFrame& frame = frames[i];
+                if (frame.name >= header->stringTableSize
+                    || (uint64_t)frame.polygonData + (uint64_t)frame.vertexCount * 2 + frame.indexCount > header->polygonDataCount)
+                    return false;
+            }
+            for (uint32_t i = 0; i < header->aliasCount; ++i)
+            {
+                if (aliases[i].name >= header->stringTableSize || aliases[i].frame >= header->frameCount)
+                    return false;
+            }
+            return true;
+        }
+
+        const char* string(uint32_t offset) const
+        {
+            return (offset < header->stringTableSize) ? strings + offset : "";
+        }
+    };
+
+    // the texture named in the sheet, relative to the sheet, or the sheet name with a .png suffix
+    std::string getSheetTexturePath(const std::string& textureFileName, const std::string& sheet)
+    {
+        if (!textureFileName.empty())
+        {
+            return FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName, sheet);
+        }
+
+        std::string texturePath = sheet;
+        size_t startPos = texturePath.find_last_of('.');
+        if (startPos != string::npos)
+        {
+            texturePath = texturePath.erase(startPos);
+        }
+        texturePath = texturePath.append(".png");
+
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+        return texturePath;
+    }
+
+    Texture2D* addSheetTexture(const std::string& texturePath, const std::string& pixelFormatName)
+    {
+        static std::unordered_map<std::string, backend::PixelFormat> pixelFormats = {
+            {"RGBA8888", backend::PixelFormat::RGBA8888},
+            {"RGBA4444", backend::PixelFormat::RGBA4444},
+            {"RGB5A1", backend::PixelFormat::RGB5A1},
+            {"RGBA5551", backend::PixelFormat::RGB5A1},
+            {"RGB565", backend::PixelFormat::RGB565},
+            {"A8", backend::PixelFormat::A8},
+            {"ALPHA", backend::PixelFormat::A8},
+            {"I8", backend::PixelFormat::I8},
+            {"AI88", backend::PixelFormat::AI88},
+            {"ALPHA_INTENSITY", backend::PixelFormat::AI88},
+            //{"BGRA8888", backend::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+            {"RGB888", backend::PixelFormat::RGB888}
+        };
+
+        Texture2D *texture = nullptr;
+        auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+        if (pixelFormatIt != pixelFormats.end())
+        {
+            const backend::PixelFormat pixelFormat = (*pixelFormatIt).second;
+            const backend::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+            Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+            texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+            Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+        }
+        else
+        {
+            texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        }
+        return texture;
+    }
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -287,36 +450,8 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, backend::PixelFormat> pixelFormats = {
-        {"RGBA8888", backend::PixelFormat::RGBA8888},
-        {"RGBA4444", backend::PixelFormat::RGBA4444},
-        {"RGB5A1", backend::PixelFormat::RGB5A1},
-        {"RGBA5551", backend::PixelFormat::RGB5A1},
-        {"RGB565", backend::PixelFormat::RGB565},
-        {"A8", backend::PixelFormat::A8},
-        {"ALPHA", backend::PixelFormat::A8},
-        {"I8", backend::PixelFormat::I8},
-        {"AI88", backend::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", backend::PixelFormat::AI88},
-        //{"BGRA8888", backend::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", backend::PixelFormat::RGB888}
-    };
+    Texture2D *texture = addSheetTexture(texturePath, pixelFormatName);
 
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
-    {
-        const backend::PixelFormat pixelFormat = (*pixelFormatIt).second;
-        const backend::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
-    }
-    else
-    {
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-    }
-    
     if (texture)
     {
         addSpriteFramesWithDictionary(dict, texture, plist);
@@ -329,6 +464,12 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
+    if (isBinarySpriteSheet(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, texture);
+        return;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
@@ -345,6 +486,27 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
 {
     CCASSERT(textureFileName.size()>0, "texture name should not be null");
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteSheet(plist))
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        BinarySheetView sheet;
+        if (!sheet.init(data))
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s is not a valid binary sprite sheet", plist.c_str());
+            return;
+        }
+        Texture2D* texture = addSheetTexture(textureFileName, sheet.string(sheet.header->pixelFormat));
+        if (texture)
+        {
+            addSpriteFramesWithBinaryData(data, texture, plist, false);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     addSpriteFramesWithDictionary(dict, textureFileName, plist);
 }
@@ -361,6 +523,12 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
+    if (isBinarySpriteSheet(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
     string texturePath("");
@@ -397,6 +565,320 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
     addSpriteFramesWithDictionary(dict, texturePath, plist);
 }
 
+bool SpriteFrameCache::isBinarySpriteSheet(const std::string& file)
+{
+    const size_t extensionLength = sizeof(BINARY_SHEET_EXTENSION) - 1;
+    return file.length() > extensionLength
+        && file.compare(file.length() - extensionLength, extensionLength, BINARY_SHEET_EXTENSION) == 0;
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& file)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(file);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    BinarySheetView sheet;
+    if (!sheet.init(data))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s is not a valid binary sprite sheet", file.c_str());
+        return;
+    }
+
+    std::string texturePath = getSheetTexturePath(sheet.string(sheet.header->textureFileName), file);
+    Texture2D* texture = addSheetTexture(texturePath, sheet.string(sheet.header->pixelFormat));
+    if (texture)
+    {
+        addSpriteFramesWithBinaryData(data, texture, file, false);
+    }
+    else
+    {
+        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+    }
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& file, Texture2D *texture)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(file);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (!addSpriteFramesWithBinaryData(data, texture, file, false))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s is not a valid binary sprite sheet", file.c_str());
+    }
+}
+
+bool SpriteFrameCache::addSpriteFramesWithBinaryData(const Data& data, Texture2D *texture, const std::string &file, bool reload)
+{
+    BinarySheetView sheet;
+    if (!sheet.init(data))
+    {
+        return false;
+    }
+
+    const BinarySheetHeader& header = *sheet.header;
+    Size textureSize(header.textureWidth, header.textureHeight);
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+
+    _spriteFramesCache.reserveFrames(header.frameCount);
+
+    for (uint32_t i = 0; i < header.frameCount; ++i)
+    {
+        const BinarySheetFrame& record = sheet.frames[i];
+        std::string spriteFrameName = sheet.string(record.name);
+        if (reload)
+        {
+            _spriteFramesCache.eraseFrame(spriteFrameName);
+        }
+        else if (_spriteFramesCache.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        Size sourceSize(record.sourceSize[0], record.sourceSize[1]);
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(record.rect[0], record.rect[1], record.rect[2], record.rect[3]),
+                                                                  record.rotated != 0,
+                                                                  Vec2(record.offset[0], record.offset[1]),
+                                                                  sourceSize);
+
+        if (record.vertexCount > 0)
+        {
+            const int32_t* polygon = sheet.polygonData + record.polygonData;
+            std::vector<int> vertices(polygon, polygon + record.vertexCount);
+            std::vector<int> verticesUV(polygon + record.vertexCount, polygon + record.vertexCount * 2);
+            std::vector<int> indices(polygon + record.vertexCount * 2, polygon + record.vertexCount * 2 + record.indexCount);
+
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, verticesUV, indices, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (record.hasAnchor)
+        {
+            spriteFrame->setAnchorPoint(Vec2(record.anchor[0], record.anchor[1]));
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(spriteFrameName) && !reload)
+        {
+            if (image == nullptr) {
+                image = new (std::nothrow) Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+
+        _spriteFramesCache.insertFrame(file, spriteFrameName, spriteFrame);
+    }
+
+    for (uint32_t i = 0; i < header.aliasCount; ++i)
+    {
+        const BinarySheetAlias& alias = sheet.aliases[i];
+        std::string oneAlias = sheet.string(alias.name);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+        _spriteFramesAliases[oneAlias] = Value(sheet.string(sheet.frames[alias.frame].name));
+    }
+
+    if (!reload)
+    {
+        _spriteFramesCache.markPlistFull(file, true);
+    }
+    CC_SAFE_DELETE(image);
+    return true;
+}
+
+bool SpriteFrameCache::convertPlistToBinary(const std::string& plist, const std::string& outputFile)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    ValueMap dictionary = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    if (dictionary["frames"].getType() != cocos2d::Value::Type::MAP)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s has no frames", plist.c_str());
+        return false;
+    }
+
+    std::vector<BinarySheetFrame> frames;
+    std::vector<BinarySheetAlias> aliases;
+    std::vector<int32_t> polygonData;
+    std::string strings;
+    auto addString = [&strings](const std::string& str) -> uint32_t {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(str);
+        strings.push_back('\0');
+        return offset;
+    };
+
+    BinarySheetHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_SHEET_MAGIC, sizeof(BINARY_SHEET_MAGIC));
+    header.version = BINARY_SHEET_VERSION;
+    header.textureFileName = BINARY_SHEET_NO_STRING;
+    header.pixelFormat = BINARY_SHEET_NO_STRING;
+
+    int format = 0;
+    auto metaItr = dictionary.find("metadata");
+    if (metaItr != dictionary.end())
+    {
+        ValueMap& metadataDict = metaItr->second.asValueMap();
+        format = metadataDict["format"].asInt();
+        if (metadataDict.find("size") != metadataDict.end())
+        {
+            Size textureSize = SizeFromString(metadataDict["size"].asString());
+            header.textureWidth = textureSize.width;
+            header.textureHeight = textureSize.height;
+        }
+        if (metadataDict.find("textureFileName") != metadataDict.end())
+        {
+            header.textureFileName = addString(metadataDict["textureFileName"].asString());
+        }
+        if (metadataDict.find("pixelFormat") != metadataDict.end())
+        {
+            header.pixelFormat = addString(metadataDict["pixelFormat"].asString());
+        }
+    }
+
+    if (format < 0 || format > 3)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: unsupported plist format %d in %s", format, plist.c_str());
+        return false;
+    }
+
+    ValueMap& framesDict = dictionary["frames"].asValueMap();
+    frames.reserve(framesDict.size());
+    for (auto& iter : framesDict)
+    {
+        ValueMap& frameDict = iter.second.asValueMap();
+        BinarySheetFrame record;
+        memset(&record, 0, sizeof(record));
+        record.name = addString(iter.first);
+
+        Rect rect;
+        Vec2 offset;
+        Size sourceSize;
+        bool rotated = false;
+        if (format == 0)
+        {
+            rect = Rect(frameDict["x"].asFloat(), frameDict["y"].asFloat(), frameDict["width"].asFloat(), frameDict["height"].asFloat());
+            offset = Vec2(frameDict["offsetX"].asFloat(), frameDict["offsetY"].asFloat());
+            sourceSize = Size((float)std::abs(frameDict["originalWidth"].asInt()), (float)std::abs(frameDict["originalHeight"].asInt()));
+        }
+        else if (format == 1 || format == 2)
+        {
+            rect = RectFromString(frameDict["frame"].asString());
+            rotated = (format == 2) && frameDict["rotated"].asBool();
+            offset = PointFromString(frameDict["offset"].asString());
+            sourceSize = SizeFromString(frameDict["sourceSize"].asString());
+        }
+        else
+        {
+            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
+            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
+            rect = Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
+            rotated = frameDict["textureRotated"].asBool();
+            offset = PointFromString(frameDict["spriteOffset"].asString());
+            sourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+
+            if (frameDict.find("aliases") != frameDict.end())
+            {
+                for (const auto& value : frameDict["aliases"].asValueVector())
+                {
+                    BinarySheetAlias alias;
+                    alias.name = addString(value.asString());
+                    alias.frame = static_cast<uint32_t>(frames.size());
+                    aliases.push_back(alias);
+                }
+            }
+
+            if (frameDict.find("vertices") != frameDict.end())
+            {
+                using cocos2d::utils::parseIntegerList;
+                std::vector<int> vertices = parseIntegerList(frameDict["vertices"].asString());
+                std::vector<int> verticesUV = parseIntegerList(frameDict["verticesUV"].asString());
+                std::vector<int> indices = parseIntegerList(frameDict["triangles"].asString());
+                if (vertices.size() != verticesUV.size())
+                {
+                    CCLOG("cocos2d: SpriteFrameCache: vertices and verticesUV of %s don't match", iter.first.c_str());
+                    return false;
+                }
+
+                record.polygonData = static_cast<uint32_t>(polygonData.size());
+                record.vertexCount = static_cast<uint32_t>(vertices.size());
+                record.indexCount = static_cast<uint32_t>(indices.size());
+                polygonData.insert(polygonData.end(), vertices.begin(), vertices.end());
+                polygonData.insert(polygonData.end(), verticesUV.begin(), verticesUV.end());
+                polygonData.insert(polygonData.end(), indices.begin(), indices.end());
+            }
+
+            if (frameDict.find("anchor") != frameDict.end())
+            {
+                Vec2 anchor = PointFromString(frameDict["anchor"].asString());
+                record.hasAnchor = 1;
+                record.anchor[0] = anchor.x;
+                record.anchor[1] = anchor.y;
+            }
+        }
+
+        record.rect[0] = rect.origin.x;
+        record.rect[1] = rect.origin.y;
+        record.rect[2] = rect.size.width;
+        record.rect[3] = rect.size.height;
+        record.offset[0] = offset.x;
+        record.offset[1] = offset.y;
+        record.sourceSize[0] = sourceSize.width;
+        record.sourceSize[1] = sourceSize.height;
+        record.rotated = rotated ? 1 : 0;
+        frames.push_back(record);
+    }
+
+    // keep the string table non empty, the loader relies on its last '\0'
+    if (strings.empty())
+    {
+        strings.push_back('\0');
+    }
+
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.aliasCount = static_cast<uint32_t>(aliases.size());
+    header.polygonDataCount = static_cast<uint32_t>(polygonData.size());
+    header.stringTableSize = static_cast<uint32_t>(strings.size());
+
+    size_t framesSize = sizeof(BinarySheetFrame) * frames.size();
+    size_t aliasesSize = sizeof(BinarySheetAlias) * aliases.size();
+    size_t polygonSize = sizeof(int32_t) * polygonData.size();
+    size_t totalSize = sizeof(header) + framesSize + aliasesSize + polygonSize + strings.size();
+
+    unsigned char* bytes = static_cast<unsigned char*>(malloc(totalSize));
+    if (bytes == nullptr)
+    {
+        return false;
+    }
+    Data data;
+    data.fastSet(bytes, totalSize);
+
+    unsigned char* out = bytes;
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    if (framesSize > 0)
+    {
+        memcpy(out, frames.data(), framesSize);
+        out += framesSize;
+    }
+    if (aliasesSize > 0)
+    {
+        memcpy(out, aliases.data(), aliasesSize);
+        out += aliasesSize;
+    }
+    if (polygonSize > 0)
+    {
+        memcpy(out, polygonData.data(), polygonSize);
+        out += polygonSize;
+    }
+    memcpy(out, strings.data(), strings.size());
+
+    return FileUtils::getInstance()->writeDataToFile(data, outputFile);
+}
+
 bool SpriteFrameCache::isSpriteFramesWithFileLoaded(const std::string& plist) const
 {
     return _spriteFramesCache.isPlistUsed(plist) && _spriteFramesCache.isPlistFull(plist);
@@ -460,6 +942,30 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteSheet(plist))
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        BinarySheetView sheet;
+        if (!sheet.init(data))
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: %s is not a valid binary sprite sheet.", plist.c_str());
+            return;
+        }
+
+        std::vector<std::string> keysToRemove;
+        for (uint32_t i = 0; i < sheet.header->frameCount; ++i)
+        {
+            std::string name = sheet.string(sheet.frames[i].name);
+            if (_spriteFramesCache.at(name))
+            {
+                keysToRemove.push_back(name);
+            }
+        }
+        _spriteFramesCache.eraseFrames(keysToRemove);
+        _spriteFramesCache.erasePlistIndex(plist);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
     {
@@ -666,6 +1172,32 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteSheet(plist))
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        BinarySheetView sheet;
+        if (!sheet.init(data))
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s is not a valid binary sprite sheet", plist.c_str());
+            return false;
+        }
+
+        std::string texturePath = getSheetTexturePath(sheet.string(sheet.header->textureFileName), plist);
+        Texture2D *texture = nullptr;
+        if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
+            texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
+
+        if (texture)
+        {
+            addSpriteFramesWithBinaryData(data, texture, plist, true);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+        return true;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
     string texturePath("");
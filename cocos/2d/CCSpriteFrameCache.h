@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "base/CCData.h"
 
 NS_CC_BEGIN
 
@@ -79,6 +80,10 @@ class PolygonInfo;
      - `size`:            size of the texture (optional)
      - `textureFileName`: name of the texture's image file
  
+ Sprite sheets can also be loaded from a compact binary file (extension `.ccsf`) that holds
+ the same frames as a flat array plus a string table, so loading needs no XML parsing.
+ Use convertPlistToBinary() to create one from an existing .plist file.
+
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
@@ -120,6 +125,7 @@ protected:
 
         inline SpriteFrame *at(const std::string &frame);
         inline Map<std::string, SpriteFrame*>& getSpriteFrames();
+        void reserveFrames(ssize_t count) { _spriteFrames.reserve(_spriteFrames.size() + count); }
 
         void markPlistFull(const std::string &plist, bool full) { _isPlistFull[plist] = full; }
         bool isPlistFull(const std::string &plist) const
@@ -197,6 +203,42 @@ public:
      */
     void addSpriteFramesWithFileContent(const std::string& plist_content, Texture2D *texture);
 
+    /** Adds multiple Sprite Frames from a binary sprite sheet file created by convertPlistToBinary().
+     * The texture is the one recorded in the file, or the file name with a .png suffix.
+     * addSpriteFramesWithFile() forwards files with the `.ccsf` extension here.
+     * @js NA
+     * @lua NA
+     *
+     * @param file Binary sprite sheet file name.
+     */
+    void addSpriteFramesWithBinaryFile(const std::string& file);
+
+    /** Adds multiple Sprite Frames from a binary sprite sheet file. The texture will be associated with the created sprite frames.
+     * @js NA
+     * @lua NA
+     *
+     * @param file Binary sprite sheet file name.
+     * @param texture Texture pointer.
+     */
+    void addSpriteFramesWithBinaryFile(const std::string& file, Texture2D *texture);
+
+    /** Converts a plist sprite sheet into the binary sprite sheet format.
+     * The texture file name in the output is kept relative, so the binary file can replace the plist next to the texture.
+     * @js NA
+     * @lua NA
+     *
+     * @param plist Plist file name.
+     * @param outputFile Full path of the binary file to write, usually with the `.ccsf` extension.
+     * @return True if the file was written.
+     */
+    static bool convertPlistToBinary(const std::string& plist, const std::string& outputFile);
+
+    /** Whether a file name has the binary sprite sheet extension `.ccsf`.
+     * @js NA
+     * @lua NA
+     */
+    static bool isBinarySpriteSheet(const std::string& file);
+
     /** Adds an sprite frame with a given name.
      If the name already exists, then the contents of the old name will be replaced with the new one.
      *
@@ -301,6 +343,10 @@ protected:
 
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture, const std::string &plist);
 
+    /*Adds multiple Sprite Frames from binary sprite sheet data, replacing existing frames if reload is true.
+     */
+    bool addSpriteFramesWithBinaryData(const Data& data, Texture2D *texture, const std::string &file, bool reload);
+
     ValueMap _spriteFramesAliases;
     PlistFramesCache _spriteFramesCache;
 };
@@ -0,0 +1,720 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTextBatchNode.h"
+#include <algorithm>
+#include <stddef.h> // offsetof
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
+#include "2d/CCFontFreeType.h"
+#include "base/ccUTF8.h"
+#include "base/CCDirector.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/backend/ProgramState.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // spare quads given to a text so it can grow by a few letters in place
+    const int QUAD_RANGE_GRANULARITY = 4;
+    // freed quads tolerated in a page before it is compacted
+    const int MIN_FREE_QUADS_TO_COMPACT = 64;
+    // 32 bit indices aren't supported by every GLES2 device, a command draws at most 65536 vertices
+    const size_t QUADS_PER_COMMAND = 65536 / 4;
+}
+
+TextBatchNode::PageCommand::PageCommand()
+{
+    command.setDrawType(CustomCommand::DrawType::ELEMENT);
+    command.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE);
+}
+
+TextBatchNode::Page::~Page()
+{
+    CC_SAFE_RELEASE_NULL(programState);
+}
+
+TextBatchNode* TextBatchNode::createWithTTF(const TTFConfig& ttfConfig)
+{
+    auto fontAtlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
+    return fontAtlas ? createWithFontAtlas(fontAtlas) : nullptr;
+}
+
+TextBatchNode* TextBatchNode::createWithBMFont(const std::string& bmfontFilePath)
+{
+    auto fontAtlas = FontAtlasCache::getFontAtlasFNT(bmfontFilePath);
+    return fontAtlas ? createWithFontAtlas(fontAtlas) : nullptr;
+}
+
+TextBatchNode* TextBatchNode::createWithFontAtlas(FontAtlas* fontAtlas)
+{
+    auto ret = new (std::nothrow) TextBatchNode();
+    if (ret && ret->initWithFontAtlas(fontAtlas))
+    {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+TextBatchNode::TextBatchNode()
+: _fontAtlas(nullptr)
+, _programState(nullptr)
+, _blendFunc(BlendFunc::ALPHA_PREMULTIPLIED)
+, _premultipliedAlpha(false)
+, _textCount(0)
+, _colorsDirty(false)
+, _textAnchorPoint(Vec2::ANCHOR_MIDDLE)
+, _fontAtlasLetterGeneration(0)
+{
+}
+
+TextBatchNode::~TextBatchNode()
+{
+    for (auto page : _pages)
+    {
+        delete page;
+    }
+    _pages.clear();
+    CC_SAFE_RELEASE_NULL(_programState);
+
+    if (_fontAtlas)
+    {
+        FontAtlasCache::releaseFontAtlas(_fontAtlas);
+        _fontAtlas = nullptr;
+    }
+}
+
+bool TextBatchNode::initWithFontAtlas(FontAtlas* fontAtlas)
+{
+    if (!fontAtlas || !Node::init())
+    {
+        return false;
+    }
+
+    _fontAtlas = fontAtlas;
+    _fontAtlas->retain();
+    _fontAtlasLetterGeneration = _fontAtlas->getLetterGeneration();
+
+    auto programType = backend::ProgramType::POSITION_TEXTURE_COLOR;
+    auto fontFreeType = dynamic_cast<const FontFreeType*>(_fontAtlas->getFont());
+    if (fontFreeType)
+    {
+        if (fontFreeType->isDistanceFieldEnabled())
+            programType = backend::ProgramType::LABEL_DISTANCE_NORMAL;
+        else if (fontFreeType->getOutlineSize() > 0)
+            programType = backend::ProgramType::LABLE_OUTLINE;
+        else
+            programType = backend::ProgramType::LABEL_NORMAL;
+    }
+
+    auto program = backend::Program::getBuiltinProgram(programType);
+    _programState = new (std::nothrow) backend::ProgramState(program);
+    _mvpMatrixLocation = _programState->getUniformLocation(backend::Uniform::MVP_MATRIX);
+    _textureLocation = _programState->getUniformLocation(backend::Uniform::TEXTURE);
+    _textColorLocation = _programState->getUniformLocation(backend::Uniform::TEXT_COLOR);
+    _effectTypeLocation = _programState->getUniformLocation(backend::Uniform::EFFECT_TYPE);
+
+    auto vertexLayout = _programState->getVertexLayout();
+    vertexLayout->setAttribute(backend::ATTRIBUTE_NAME_POSITION,
+                               _programState->getAttributeLocation(backend::Attribute::POSITION),
+                               backend::VertexFormat::FLOAT3,
+                               0,
+                               false);
+    vertexLayout->setAttribute(backend::ATTRIBUTE_NAME_TEXCOORD,
+                               _programState->getAttributeLocation(backend::Attribute::TEXCOORD),
+                               backend::VertexFormat::FLOAT2,
+                               offsetof(V3F_C4B_T2F, texCoords),
+                               false);
+    vertexLayout->setAttribute(backend::ATTRIBUTE_NAME_COLOR,
+                               _programState->getAttributeLocation(backend::Attribute::COLOR),
+                               backend::VertexFormat::UBYTE4,
+                               offsetof(V3F_C4B_T2F, colors),
+                               true);
+    vertexLayout->setLayout(sizeof(V3F_C4B_T2F));
+
+    auto texture = _fontAtlas->getTexture(0);
+    _premultipliedAlpha = texture && texture->hasPremultipliedAlpha();
+    _blendFunc = _premultipliedAlpha ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+
+    ensurePages();
+    return true;
+}
+
+int TextBatchNode::addText(const std::string& text, const Vec2& position, const Color4B& color, float scale)
+{
+    int textId;
+    if (!_freeEntries.empty())
+    {
+        textId = _freeEntries.back();
+        _freeEntries.pop_back();
+    }
+    else
+    {
+        textId = static_cast<int>(_entries.size());
+        _entries.emplace_back();
+    }
+
+    auto& entry = _entries[textId];
+    entry.text.clear();
+    StringUtils::UTF8ToUTF32(text, entry.text);
+    entry.position = position;
+    entry.color = color;
+    entry.scale = scale;
+    entry.used = true;
+    entry.visible = true;
+    ++_textCount;
+
+    markEntryDirty(textId, true);
+    return textId;
+}
+
+TextBatchNode::TextEntry* TextBatchNode::getEntry(int textId)
+{
+    if (textId < 0 || textId >= static_cast<int>(_entries.size()) || !_entries[textId].used)
+    {
+        CCLOG("TextBatchNode: invalid text id %d", textId);
+        return nullptr;
+    }
+    return &_entries[textId];
+}
+
+void TextBatchNode::markEntryDirty(int textId, bool layout)
+{
+    auto& entry = _entries[textId];
+    if (!entry.layoutDirty && !entry.colorDirty)
+    {
+        _dirtyEntries.push_back(textId);
+    }
+
+    if (layout)
+        entry.layoutDirty = true;
+    else
+        entry.colorDirty = true;
+}
+
+void TextBatchNode::setText(int textId, const std::string& text)
+{
+    auto entry = getEntry(textId);
+    if (!entry)
+        return;
+
+    std::u32string utf32Text;
+    if (StringUtils::UTF8ToUTF32(text, utf32Text) && utf32Text != entry->text)
+    {
+        entry->text = std::move(utf32Text);
+        markEntryDirty(textId, true);
+    }
+}
+
+void TextBatchNode::setTextPosition(int textId, const Vec2& position)
+{
+    auto entry = getEntry(textId);
+    if (entry && entry->position != position)
+    {
+        entry->position = position;
+        markEntryDirty(textId, true);
+    }
+}
+
+void TextBatchNode::setTextColor(int textId, const Color4B& color)
+{
+    auto entry = getEntry(textId);
+    if (entry && entry->color != color)
+    {
+        entry->color = color;
+        markEntryDirty(textId, false);
+    }
+}
+
+void TextBatchNode::setTextScale(int textId, float scale)
+{
+    auto entry = getEntry(textId);
+    if (entry && entry->scale != scale)
+    {
+        entry->scale = scale;
+        markEntryDirty(textId, true);
+    }
+}
+
+void TextBatchNode::setTextVisible(int textId, bool visible)
+{
+    auto entry = getEntry(textId);
+    if (entry && entry->visible != visible)
+    {
+        entry->visible = visible;
+        markEntryDirty(textId, true);
+    }
+}
+
+void TextBatchNode::removeText(int textId)
+{
+    auto entry = getEntry(textId);
+    if (!entry)
+        return;
+
+    for (int pageIndex = 0; pageIndex < static_cast<int>(entry->ranges.size()); ++pageIndex)
+    {
+        releaseRange(pageIndex, entry->ranges[pageIndex]);
+    }
+    entry->text.clear();
+    entry->used = false;
+    entry->layoutDirty = false;
+    entry->colorDirty = false;
+    _freeEntries.push_back(textId);
+    --_textCount;
+}
+
+void TextBatchNode::removeAllTexts()
+{
+    _entries.clear();
+    _freeEntries.clear();
+    _dirtyEntries.clear();
+    _textCount = 0;
+    for (auto page : _pages)
+    {
+        page->quads.clear();
+        page->freeQuads = 0;
+        page->dirtyBegin = page->dirtyEnd = 0;
+    }
+}
+
+void TextBatchNode::setTextAnchorPoint(const Vec2& anchorPoint)
+{
+    if (_textAnchorPoint == anchorPoint)
+        return;
+
+    _textAnchorPoint = anchorPoint;
+    for (int textId = 0; textId < static_cast<int>(_entries.size()); ++textId)
+    {
+        if (_entries[textId].used)
+            markEntryDirty(textId, true);
+    }
+}
+
+void TextBatchNode::setBlendFunc(const BlendFunc& blendFunc)
+{
+    _blendFunc = blendFunc;
+}
+
+void TextBatchNode::updateColor()
+{
+    _colorsDirty = true;
+}
+
+Color4B TextBatchNode::getVertexColor(const Color4B& color) const
+{
+    Color4B vertexColor(color.r * _displayedColor.r / 255,
+                        color.g * _displayedColor.g / 255,
+                        color.b * _displayedColor.b / 255,
+                        color.a * _displayedOpacity / 255);
+    if (_premultipliedAlpha)
+    {
+        vertexColor.r = vertexColor.r * vertexColor.a / 255;
+        vertexColor.g = vertexColor.g * vertexColor.a / 255;
+        vertexColor.b = vertexColor.b * vertexColor.a / 255;
+    }
+    return vertexColor;
+}
+
+void TextBatchNode::ensurePages()
+{
+    auto pageCount = _fontAtlas->getTextures().size();
+    while (_pages.size() < pageCount)
+    {
+        auto page = new (std::nothrow) Page();
+        page->programState = _programState->clone();
+        _pages.push_back(page);
+    }
+}
+
+void TextBatchNode::markDirty(Page* page, int begin, int end)
+{
+    if (begin >= end)
+        return;
+
+    if (page->dirtyBegin == page->dirtyEnd)
+    {
+        page->dirtyBegin = begin;
+        page->dirtyEnd = end;
+    }
+    else
+    {
+        page->dirtyBegin = std::min(page->dirtyBegin, begin);
+        page->dirtyEnd = std::max(page->dirtyEnd, end);
+    }
+}
+
+void TextBatchNode::releaseRange(int pageIndex, QuadRange& range)
+{
+    if (range.capacity > 0 && pageIndex < static_cast<int>(_pages.size()))
+    {
+        auto page = _pages[pageIndex];
+        // zero sized quads are not rasterized
+        std::fill(page->quads.begin() + range.start, page->quads.begin() + range.start + range.capacity, V3F_C4B_T2F_Quad());
+        page->freeQuads += range.capacity;
+        markDirty(page, range.start, range.start + range.capacity);
+    }
+    range = QuadRange();
+}
+
+TextBatchNode::QuadRange& TextBatchNode::reserveRange(TextEntry& entry, int pageIndex, int count)
+{
+    auto& range = entry.ranges[pageIndex];
+    if (count <= range.capacity)
+    {
+        range.count = count;
+        return range;
+    }
+
+    releaseRange(pageIndex, range);
+    auto page = _pages[pageIndex];
+    range.start = static_cast<int>(page->quads.size());
+    range.capacity = (count + QUAD_RANGE_GRANULARITY - 1) / QUAD_RANGE_GRANULARITY * QUAD_RANGE_GRANULARITY;
+    range.count = count;
+    page->quads.resize(range.start + range.capacity);
+    return range;
+}
+
+void TextBatchNode::layoutText(TextEntry& entry)
+{
+    entry.lettersMissing = false;
+    if (entry.visible && !entry.text.empty())
+    {
+        _fontAtlas->prepareLetterDefinitions(entry.text);
+        ensurePages();
+    }
+
+    auto pageCount = _pages.size();
+    _pageQuads.resize(pageCount);
+    for (auto&& quads : _pageQuads)
+    {
+        quads.clear();
+    }
+    entry.ranges.resize(pageCount);
+
+    if (entry.visible && !entry.text.empty())
+    {
+        auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+        float lineHeight = _fontAtlas->getLineHeight() / contentScaleFactor;
+        int textLen = static_cast<int>(entry.text.length());
+        int letterCount = 0;
+        int* kernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF32(entry.text, letterCount);
+
+        // lay the letters out with the top left corner of the text at the origin
+        float nextLetterX = 0.f;
+        float lineTop = 0.f;
+        float width = 0.f;
+        int numberOfLines = 1;
+        FontLetterDefinition letterDef;
+        for (int index = 0; index < textLen; ++index)
+        {
+            auto character = entry.text[index];
+            if (character == StringUtils::UnicodeCharacters::NewLine)
+            {
+                width = std::max(width, nextLetterX / contentScaleFactor);
+                nextLetterX = 0.f;
+                lineTop -= lineHeight;
+                ++numberOfLines;
+                continue;
+            }
+
+            if (!_fontAtlas->getLetterDefinitionForChar(character, letterDef))
+            {
+                if (_fontAtlas->isLetterPending(character))
+                    entry.lettersMissing = true;
+                continue;
+            }
+
+            if (letterDef.width > 0.f && letterDef.height > 0.f && letterDef.textureID >= 0
+                && static_cast<size_t>(letterDef.textureID) < pageCount)
+            {
+                auto texture = _fontAtlas->getTexture(letterDef.textureID);
+                float atlasWidth = static_cast<float>(texture->getPixelsWide());
+                float atlasHeight = static_cast<float>(texture->getPixelsHigh());
+
+                float left = (nextLetterX + letterDef.offsetX) / contentScaleFactor;
+                float top = lineTop - letterDef.offsetY / contentScaleFactor;
+                float right = left + letterDef.width;
+                float bottom = top - letterDef.height;
+
+                V3F_C4B_T2F_Quad quad;
+                quad.bl.vertices.set(left, bottom, 0.f);
+                quad.br.vertices.set(right, bottom, 0.f);
+                quad.tl.vertices.set(left, top, 0.f);
+                quad.tr.vertices.set(right, top, 0.f);
+
+                float u = letterDef.U * contentScaleFactor / atlasWidth;
+                float v = letterDef.V * contentScaleFactor / atlasHeight;
+                if (letterDef.rotated)
+                {
+                    float u2 = (letterDef.U + letterDef.height) * contentScaleFactor / atlasWidth;
+                    float v2 = (letterDef.V + letterDef.width) * contentScaleFactor / atlasHeight;
+                    quad.bl.texCoords = Tex2F(u, v);
+                    quad.br.texCoords = Tex2F(u, v2);
+                    quad.tl.texCoords = Tex2F(u2, v);
+                    quad.tr.texCoords = Tex2F(u2, v2);
+                }
+                else
+                {
+                    float u2 = (letterDef.U + letterDef.width) * contentScaleFactor / atlasWidth;
+                    float v2 = (letterDef.V + letterDef.height) * contentScaleFactor / atlasHeight;
+                    quad.bl.texCoords = Tex2F(u, v2);
+                    quad.br.texCoords = Tex2F(u2, v2);
+                    quad.tl.texCoords = Tex2F(u, v);
+                    quad.tr.texCoords = Tex2F(u2, v);
+                }
+                _pageQuads[letterDef.textureID].push_back(quad);
+            }
+
+            nextLetterX += letterDef.xAdvance;
+            if (kernings && index < textLen - 1)
+                nextLetterX += kernings[index + 1];
+        }
+        delete [] kernings;
+
+        width = std::max(width, nextLetterX / contentScaleFactor);
+        float height = numberOfLines * lineHeight;
+
+        // place the anchor of the text at its position
+        Vec2 anchor(_textAnchorPoint.x * width, _textAnchorPoint.y * height - height);
+        auto vertexColor = getVertexColor(entry.color);
+        for (auto&& quads : _pageQuads)
+        {
+            for (auto&& quad : quads)
+            {
+                for (auto vertex : {&quad.bl, &quad.br, &quad.tl, &quad.tr})
+                {
+                    vertex->vertices.x = entry.position.x + (vertex->vertices.x - anchor.x) * entry.scale;
+                    vertex->vertices.y = entry.position.y + (vertex->vertices.y - anchor.y) * entry.scale;
+                    vertex->colors = vertexColor;
+                }
+            }
+        }
+    }
+
+    for (int pageIndex = 0; pageIndex < static_cast<int>(pageCount); ++pageIndex)
+    {
+        auto& quads = _pageQuads[pageIndex];
+        auto& range = reserveRange(entry, pageIndex, static_cast<int>(quads.size()));
+        if (range.capacity == 0)
+            continue;
+
+        auto page = _pages[pageIndex];
+        auto first = page->quads.begin() + range.start;
+        std::copy(quads.begin(), quads.end(), first);
+        std::fill(first + range.count, first + range.capacity, V3F_C4B_T2F_Quad());
+        markDirty(page, range.start, range.start + range.capacity);
+    }
+}
+
+void TextBatchNode::colorText(TextEntry& entry)
+{
+    auto vertexColor = getVertexColor(entry.color);
+    for (int pageIndex = 0; pageIndex < static_cast<int>(entry.ranges.size()); ++pageIndex)
+    {
+        auto& range = entry.ranges[pageIndex];
+        if (range.count == 0)
+            continue;
+
+        auto page = _pages[pageIndex];
+        for (int index = range.start; index < range.start + range.count; ++index)
+        {
+            auto& quad = page->quads[index];
+            quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = vertexColor;
+        }
+        markDirty(page, range.start, range.start + range.count);
+    }
+}
+
+void TextBatchNode::compactPage(int pageIndex)
+{
+    auto page = _pages[pageIndex];
+    std::vector<V3F_C4B_T2F_Quad> quads;
+    quads.reserve(page->quads.size() - page->freeQuads);
+    for (auto&& entry : _entries)
+    {
+        if (!entry.used || pageIndex >= static_cast<int>(entry.ranges.size()))
+            continue;
+
+        auto& range = entry.ranges[pageIndex];
+        if (range.capacity == 0)
+            continue;
+
+        auto start = static_cast<int>(quads.size());
+        quads.insert(quads.end(), page->quads.begin() + range.start, page->quads.begin() + range.start + range.capacity);
+        range.start = start;
+    }
+    page->quads.swap(quads);
+    page->freeQuads = 0;
+    page->dirtyBegin = 0;
+    page->dirtyEnd = static_cast<int>(page->quads.size());
+}
+
+void TextBatchNode::updateEntries()
+{
+    // letters rasterized in the background have arrived in the atlas
+    if (_fontAtlas->getLetterGeneration() != _fontAtlasLetterGeneration)
+    {
+        _fontAtlasLetterGeneration = _fontAtlas->getLetterGeneration();
+        for (int textId = 0; textId < static_cast<int>(_entries.size()); ++textId)
+        {
+            if (_entries[textId].used && _entries[textId].lettersMissing)
+                markEntryDirty(textId, true);
+        }
+    }
+
+    if (_colorsDirty)
+    {
+        _colorsDirty = false;
+        for (auto&& entry : _entries)
+        {
+            if (entry.used && !entry.layoutDirty)
+                colorText(entry);
+        }
+    }
+
+    for (auto textId : _dirtyEntries)
+    {
+        auto& entry = _entries[textId];
+        if (entry.used && entry.layoutDirty)
+            layoutText(entry);
+        else if (entry.used && entry.colorDirty)
+            colorText(entry);
+        entry.layoutDirty = false;
+        entry.colorDirty = false;
+    }
+    _dirtyEntries.clear();
+
+    for (int pageIndex = 0; pageIndex < static_cast<int>(_pages.size()); ++pageIndex)
+    {
+        auto page = _pages[pageIndex];
+        if (page->freeQuads > MIN_FREE_QUADS_TO_COMPACT && page->freeQuads * 2 > static_cast<int>(page->quads.size()))
+        {
+            compactPage(pageIndex);
+        }
+        uploadPage(page);
+    }
+}
+
+void TextBatchNode::uploadPage(Page* page)
+{
+    auto quadCount = page->quads.size();
+    auto commandCount = (quadCount + QUADS_PER_COMMAND - 1) / QUADS_PER_COMMAND;
+    while (page->commands.size() < commandCount)
+    {
+        page->commands.emplace_back();
+        page->commands.back().command.getPipelineDescriptor().programState = page->programState;
+    }
+
+    for (size_t i = 0; i < commandCount; ++i)
+    {
+        auto& pageCommand = page->commands[i];
+        auto first = i * QUADS_PER_COMMAND;
+        auto count = std::min(quadCount - first, QUADS_PER_COMMAND);
+        if (count <= pageCommand.bufferCapacity)
+            continue;
+
+        pageCommand.bufferCapacity = std::min(std::max(count + count / 2, static_cast<size_t>(64)), QUADS_PER_COMMAND);
+        pageCommand.command.createVertexBuffer(sizeof(V3F_C4B_T2F), pageCommand.bufferCapacity * 4, CustomCommand::BufferUsage::DYNAMIC);
+        pageCommand.command.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, pageCommand.bufferCapacity * 6, CustomCommand::BufferUsage::STATIC);
+
+        std::vector<unsigned short> indices(pageCommand.bufferCapacity * 6);
+        for (unsigned short j = 0; j < pageCommand.bufferCapacity; ++j)
+        {
+            indices[j * 6 + 0] = j * 4 + 0;
+            indices[j * 6 + 1] = j * 4 + 1;
+            indices[j * 6 + 2] = j * 4 + 2;
+            indices[j * 6 + 3] = j * 4 + 3;
+            indices[j * 6 + 4] = j * 4 + 2;
+            indices[j * 6 + 5] = j * 4 + 1;
+        }
+        pageCommand.command.updateIndexBuffer(indices.data(), indices.size() * sizeof(unsigned short));
+
+        // the new buffer has no content yet
+        markDirty(page, static_cast<int>(first), static_cast<int>(first + count));
+    }
+
+    for (size_t i = 0; i < commandCount && page->dirtyBegin < page->dirtyEnd; ++i)
+    {
+        auto first = static_cast<int>(i * QUADS_PER_COMMAND);
+        auto last = static_cast<int>(std::min(quadCount, first + QUADS_PER_COMMAND));
+        auto begin = std::max(page->dirtyBegin, first);
+        auto end = std::min(page->dirtyEnd, last);
+        if (begin < end)
+        {
+            page->commands[i].command.updateVertexBuffer(page->quads.data() + begin,
+                                                         (begin - first) * sizeof(V3F_C4B_T2F_Quad),
+                                                         (end - begin) * sizeof(V3F_C4B_T2F_Quad));
+        }
+    }
+    page->dirtyBegin = page->dirtyEnd = 0;
+
+    for (size_t i = 0; i < commandCount; ++i)
+    {
+        page->commands[i].command.setIndexDrawInfo(0, std::min(quadCount - i * QUADS_PER_COMMAND, QUADS_PER_COMMAND) * 6);
+    }
+}
+
+void TextBatchNode::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    if (_textCount == 0 && _dirtyEntries.empty())
+        return;
+
+    updateEntries();
+
+    const auto& projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Mat4 matrixMVP = projection * transform;
+    Vec4 textColor(1.f, 1.f, 1.f, 1.f);
+    int effectType = 0;
+
+    for (int pageIndex = 0; pageIndex < static_cast<int>(_pages.size()); ++pageIndex)
+    {
+        auto page = _pages[pageIndex];
+        if (page->quads.empty() || page->freeQuads == static_cast<int>(page->quads.size()))
+            continue;
+
+        auto programState = page->programState;
+        programState->setUniform(_mvpMatrixLocation, matrixMVP.m, sizeof(matrixMVP.m));
+        programState->setTexture(_textureLocation, 0, _fontAtlas->getTexture(pageIndex)->getBackendTexture());
+        if (_textColorLocation)
+            programState->setUniform(_textColorLocation, &textColor, sizeof(textColor));
+        if (_effectTypeLocation)
+            programState->setUniform(_effectTypeLocation, &effectType, sizeof(effectType));
+
+        auto commandCount = (page->quads.size() + QUADS_PER_COMMAND - 1) / QUADS_PER_COMMAND;
+        for (size_t i = 0; i < commandCount; ++i)
+        {
+            auto& command = page->commands[i].command;
+            command.init(_globalZOrder, _blendFunc);
+            renderer->addCommand(&command);
+        }
+    }
+}
+
+NS_CC_END
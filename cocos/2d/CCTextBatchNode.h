@@ -0,0 +1,194 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "2d/CCNode.h"
+#include "2d/CCLabel.h"
+#include "base/CCProtocols.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class FontAtlas;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * @brief Draws many short texts that share one font with one draw call per atlas page.
+ *
+ * Damage numbers, nameplates and counters are added as lightweight entries with a position,
+ * a string, a color and a scale instead of one Label node each. All the entries are laid out
+ * into a shared vertex buffer per font atlas page, and changing an entry only rewrites and
+ * uploads the quads of that entry. The quads are indexed with 16 bit indices, so a page of more
+ * than 16384 quads is drawn by several commands.
+ *
+ * Entries are laid out on single lines, a '\n' starts a new line. Wrapping, alignment inside
+ * a box, shadows, outlines and glows are not supported; use Label for those.
+ */
+class CC_DLL TextBatchNode : public Node, public BlendProtocol
+{
+public:
+    /** Creates a node drawing texts with a TrueType font. */
+    static TextBatchNode* createWithTTF(const TTFConfig& ttfConfig);
+
+    /** Creates a node drawing texts with a bitmap font. */
+    static TextBatchNode* createWithBMFont(const std::string& bmfontFilePath);
+
+    /** Creates a node drawing texts with the letters of the font atlas. */
+    static TextBatchNode* createWithFontAtlas(FontAtlas* fontAtlas);
+
+    /**
+     * Adds a text and returns its id, which stays valid until the text is removed.
+     *
+     * @param text UTF-8 string.
+     * @param position Position of the text anchor, in the coordinates of this node.
+     * @param color Color and opacity of the text.
+     * @param scale Scale of the text around its anchor.
+     */
+    int addText(const std::string& text, const Vec2& position, const Color4B& color = Color4B::WHITE, float scale = 1.0f);
+
+    void setText(int textId, const std::string& text);
+    void setTextPosition(int textId, const Vec2& position);
+    void setTextColor(int textId, const Color4B& color);
+    void setTextScale(int textId, float scale);
+    void setTextVisible(int textId, bool visible);
+
+    /** Removes the text, its id may be given to a text added later. */
+    void removeText(int textId);
+    void removeAllTexts();
+
+    /** Number of texts added and not removed. */
+    int getTextCount() const { return _textCount; }
+
+    /** Sets the point of every text that is placed at its position, (0.5, 0.5) by default. */
+    void setTextAnchorPoint(const Vec2& anchorPoint);
+    const Vec2& getTextAnchorPoint() const { return _textAnchorPoint; }
+
+    FontAtlas* getFontAtlas() const { return _fontAtlas; }
+
+    // Overrides
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+    virtual void updateColor() override;
+    virtual void setBlendFunc(const BlendFunc& blendFunc) override;
+    virtual const BlendFunc& getBlendFunc() const override { return _blendFunc; }
+
+CC_CONSTRUCTOR_ACCESS:
+    TextBatchNode();
+    virtual ~TextBatchNode();
+
+    bool initWithFontAtlas(FontAtlas* fontAtlas);
+
+protected:
+    /// quads of a text on one atlas page
+    struct QuadRange
+    {
+        int start = 0;
+        int capacity = 0;
+        int count = 0;
+    };
+
+    struct TextEntry
+    {
+        std::u32string text;
+        Vec2 position;
+        Color4B color;
+        float scale = 1.0f;
+        bool used = false;
+        bool visible = true;
+        bool layoutDirty = false;
+        bool colorDirty = false;
+        bool lettersMissing = false;
+        std::vector<QuadRange> ranges;
+    };
+
+    /// draws up to QUADS_PER_COMMAND quads of a page
+    struct PageCommand
+    {
+        PageCommand();
+
+        size_t bufferCapacity = 0;
+        CustomCommand command;
+    };
+
+    struct Page
+    {
+        ~Page();
+
+        std::vector<V3F_C4B_T2F_Quad> quads;
+        int freeQuads = 0;
+        int dirtyBegin = 0;
+        int dirtyEnd = 0;
+        backend::ProgramState* programState = nullptr;
+        std::deque<PageCommand> commands;   // only grows, as many are drawn as the quads need
+    };
+
+    TextEntry* getEntry(int textId);
+    void markEntryDirty(int textId, bool layout);
+    void ensurePages();
+    void updateEntries();
+    void layoutText(TextEntry& entry);
+    void colorText(TextEntry& entry);
+    void releaseRange(int pageIndex, QuadRange& range);
+    QuadRange& reserveRange(TextEntry& entry, int pageIndex, int count);
+    void compactPage(int pageIndex);
+    void markDirty(Page* page, int begin, int end);
+    void uploadPage(Page* page);
+    Color4B getVertexColor(const Color4B& color) const;
+
+    FontAtlas* _fontAtlas;
+    backend::ProgramState* _programState;
+    backend::UniformLocation _mvpMatrixLocation;
+    backend::UniformLocation _textureLocation;
+    backend::UniformLocation _textColorLocation;
+    backend::UniformLocation _effectTypeLocation;
+    BlendFunc _blendFunc;
+    bool _premultipliedAlpha;
+
+    std::vector<TextEntry> _entries;
+    std::vector<int> _freeEntries;
+    std::vector<Page*> _pages;
+    std::vector<int> _dirtyEntries;
+    int _textCount;
+    bool _colorsDirty;
+    Vec2 _textAnchorPoint;
+    unsigned int _fontAtlasLetterGeneration;
+
+    // scratch buffers reused by layoutText()
+    std::vector<std::vector<V3F_C4B_T2F_Quad>> _pageQuads;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(TextBatchNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
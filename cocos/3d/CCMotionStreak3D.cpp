@@ -49,7 +49,7 @@ MotionStreak3D::MotionStreak3D()
 , _minSeg(0.0f)
 , _maxPoints(0)
 , _nuPoints(0)
-, _previousNuPoints(0)
+, _headPoint(0)
 {
 }
 
@@ -108,6 +108,7 @@ bool MotionStreak3D::initWithFade(float fade, float minSeg, float stroke, const
 
     _maxPoints = (int)(fade*60.0f)+2;
     _nuPoints = 0;
+    _headPoint = 0;
     
     _pointState.resize(_maxPoints);
     _pointVertexes.resize(_maxPoints);
@@ -134,8 +135,8 @@ bool MotionStreak3D::initWithFade(float fade, float minSeg, float stroke, const
 
 void MotionStreak3D::initCustomCommand()
 {
-    _customCommand.setDrawType(CustomCommand::DrawType::ARRAY);
-    _customCommand.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE_STRIP);
+    _customCommand.setDrawType(CustomCommand::DrawType::ELEMENT);
+    _customCommand.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE);
 
     auto& pipelineDescriptor = _customCommand.getPipelineDescriptor();
     auto layout = _programState->getVertexLayout();
@@ -168,6 +169,14 @@ void MotionStreak3D::initCustomCommand()
     _locTexture = _programState->getUniformLocation("u_texture");
 
     _customCommand.createVertexBuffer(sizeof(VertexData), _vertexData.size(), CustomCommand::BufferUsage::DYNAMIC);
+
+    // the indices never change, draw() selects the live run of segments with setIndexDrawInfo()
+    // 16 bit indices, 32 bit ones aren't supported by every GLES2 device
+    CCASSERT(_maxPoints * 2 <= 65536, "fade too long for the frame rate, the streak needs more than 65536 vertices");
+    std::vector<unsigned short> indices(_maxPoints * 12);
+    ccVertexRingStripIndices(_maxPoints, indices.data());
+    _customCommand.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, indices.size(), CustomCommand::BufferUsage::STATIC);
+    _customCommand.updateIndexBuffer(indices.data(), indices.size() * sizeof(unsigned short));
 }
 
 void MotionStreak3D::setPosition(const Vec2& position)
@@ -250,10 +259,13 @@ void MotionStreak3D::tintWithColor(const Color3B& colors)
     setColor(colors);
 
     // Fast assignation
-    for(unsigned int i = 0; i<_nuPoints*2; i++) 
+    for(unsigned int i = 0; i<_nuPoints; i++) 
     {
-        auto &color = _vertexData[i].color;
+        const unsigned int slot = getPointSlot(i) * 2;
+        auto &color = _vertexData[slot].color;
         color.set(colors.r, colors.g, colors.b, color.a);
+        auto &color2 = _vertexData[slot + 1].color;
+        color2.set(colors.r, colors.g, colors.b, color2.a);
     }
 }
 
@@ -312,46 +324,20 @@ void MotionStreak3D::update(float delta)
     
     delta *= _fadeDelta;
 
-    unsigned int newIdx, newIdx2, i, i2;
-    unsigned int mov = 0;
+    unsigned int i, slot;
 
     // Update current points
     for(i = 0; i<_nuPoints; i++)
     {
-        _pointState[i]-=delta;
+        _pointState[getPointSlot(i)]-=delta;
+    }
 
-        if(_pointState[i] <= 0)
-            mov++;
-        else
-        {
-            newIdx = i-mov;
-
-            if(mov>0)
-            {
-                // Move data
-                _pointState[newIdx] = _pointState[i];
-
-                // Move point
-                _pointVertexes[newIdx] = _pointVertexes[i];
-
-                // Move vertices
-                i2 = i*2;
-                newIdx2 = newIdx*2;
-                _vertexData[newIdx2].pos = _vertexData[i2].pos;
-                _vertexData[newIdx2+1].pos = _vertexData[i2+1].pos;
-
-                // Move color
-                _vertexData[newIdx2].color = _vertexData[i2].color;
-                _vertexData[newIdx2 + 1].color = _vertexData[i2 + 1].color;
-            }else
-                newIdx2 = newIdx*2;
-
-            const uint8_t op = (uint8_t)(_pointState[newIdx] * 255.0f);
-            _vertexData[newIdx2].color.a = op;
-            _vertexData[newIdx2+1].color.a = op;
-        }
+    // Every point fades at the same rate, so the expired ones are always the oldest
+    while(_nuPoints > 0 && _pointState[_headPoint] <= 0)
+    {
+        _headPoint = (_headPoint + 1) % _maxPoints;
+        _nuPoints--;
     }
-    _nuPoints-=mov;
 
     // Append new point
     bool appendNewPoint = true;
@@ -362,8 +348,8 @@ void MotionStreak3D::update(float delta)
 
     else if(_nuPoints>0)
     {
-        bool a1 = (_pointVertexes[_nuPoints-1] - _positionR).lengthSquared() < _minSeg;
-        bool a2 = (_nuPoints == 1) ? false : ((_pointVertexes[_nuPoints-2] - _positionR).lengthSquared() < (_minSeg * 2.0f));
+        bool a1 = (_pointVertexes[getPointSlot(_nuPoints-1)] - _positionR).lengthSquared() < _minSeg;
+        bool a2 = (_nuPoints == 1) ? false : ((_pointVertexes[getPointSlot(_nuPoints-2)] - _positionR).lengthSquared() < (_minSeg * 2.0f));
         if(a1 || a2)
         {
             appendNewPoint = false;
@@ -372,39 +358,44 @@ void MotionStreak3D::update(float delta)
 
     if(appendNewPoint)
     {
-        _pointVertexes[_nuPoints] = _positionR;
-        _pointState[_nuPoints] = 1.0f;
+        slot = getPointSlot(_nuPoints);
+        _pointVertexes[slot] = _positionR;
+        _pointState[slot] = 1.0f;
 
         // Color assignment
-        _vertexData[_nuPoints * 2].color = Color4B(_displayedColor, 255);
-        _vertexData[_nuPoints * 2 + 1].color = Color4B(_displayedColor, 255);
+        _vertexData[slot * 2].color = Color4B(_displayedColor, 255);
+        _vertexData[slot * 2 + 1].color = Color4B(_displayedColor, 255);
 
 
         // Generate polygon
         {
             float stroke = _stroke * 0.5f;
-            _vertexData[_nuPoints * 2].pos = _pointVertexes[_nuPoints] + (_sweepAxis * stroke);
-            _vertexData[_nuPoints * 2 + 1].pos = _pointVertexes[_nuPoints] - (_sweepAxis * stroke);
+            _vertexData[slot * 2].pos = _pointVertexes[slot] + (_sweepAxis * stroke);
+            _vertexData[slot * 2 + 1].pos = _pointVertexes[slot] - (_sweepAxis * stroke);
         }
 
         _nuPoints ++;
     }
 
-    // Updated Tex Coords only if they are different than previous step
-    if( _nuPoints  && _previousNuPoints != _nuPoints ) {
+    // Opacity and tex coords are relative to the oldest point, so they follow the ring head
+    if( _nuPoints ) {
         float texDelta = 1.0f / _nuPoints;
         for( i=0; i < _nuPoints; i++ ) {
-            _vertexData[i*2].texPos = Tex2F(0, texDelta*i);
-            _vertexData[i*2+1].texPos = Tex2F(1, texDelta*i);
+            const unsigned int pointSlot = getPointSlot(i);
+            const uint8_t op = (uint8_t)(_pointState[pointSlot] * 255.0f);
+            slot = pointSlot * 2;
+            _vertexData[slot].color.a = op;
+            _vertexData[slot+1].color.a = op;
+            _vertexData[slot].texPos = Tex2F(0, texDelta*i);
+            _vertexData[slot+1].texPos = Tex2F(1, texDelta*i);
         }
-
-        _previousNuPoints = _nuPoints;
     }
 }
 
 void MotionStreak3D::reset()
 {
     _nuPoints = 0;
+    _headPoint = 0;
 }
 
 void MotionStreak3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
@@ -423,9 +414,15 @@ void MotionStreak3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t fl
     _beforeCommand.func = CC_CALLBACK_0(MotionStreak3D::onBeforeDraw, this);
     _afterCommand.func = CC_CALLBACK_0(MotionStreak3D::onAfterDraw, this);
     
-    _customCommand.updateVertexBuffer(_vertexData.data(), sizeof(_vertexData[0]) * _nuPoints * 2);
-
-    _customCommand.setVertexDrawInfo(0, _nuPoints * 2);
+    // Upload the live slots only, in two runs when they wrap around the end of the ring
+    const unsigned int headVertex = _headPoint * 2;
+    const unsigned int liveVertices = _nuPoints * 2;
+    const unsigned int firstRun = std::min(liveVertices, (unsigned int)_vertexData.size() - headVertex);
+    _customCommand.updateVertexBuffer(_vertexData.data() + headVertex, headVertex * sizeof(VertexData), firstRun * sizeof(VertexData));
+    if (firstRun < liveVertices)
+        _customCommand.updateVertexBuffer(_vertexData.data(), 0, (liveVertices - firstRun) * sizeof(VertexData));
+
+    _customCommand.setIndexDrawInfo(_headPoint * 6, (_nuPoints - 1) * 6);
 
     renderer->addCommand(&_beforeCommand);
     renderer->addCommand(&_customCommand);
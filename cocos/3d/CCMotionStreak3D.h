@@ -190,14 +190,19 @@ protected:
     float _fadeDelta;
     float _minSeg;
 
+    /** ring slot of the i-th live point, counting from the oldest one */
+    unsigned int getPointSlot(unsigned int index) const { return (_headPoint + index) % _maxPoints; }
+
     unsigned int _maxPoints;
     unsigned int _nuPoints;
-    unsigned int _previousNuPoints;
+    /** ring slot of the oldest point, points expire from here and are appended after the last one */
+    unsigned int _headPoint;
 
-    /** Pointers */
+    /** Pointers, all of them indexed by ring slot */
     std::vector<Vec3> _pointVertexes;
     std::vector<float> _pointState;
 
+    /** two vertices per ring slot */
     std::vector<VertexData> _vertexData;
     
     CustomCommand _customCommand;
@@ -41,6 +41,7 @@
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureStreamer.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCTechnique.h"
@@ -756,6 +757,61 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
+void Sprite3D::requestTextureDensities(const Mat4& transform)
+{
+    static const NTextureData::Usage streamedUsages[] = { NTextureData::Usage::Diffuse, NTextureData::Usage::Normal };
+
+    auto camera = Camera::getVisitingCamera();
+    if (camera == nullptr)
+        return;
+
+    float screenSize = -1;
+    for (auto mesh : _meshes)
+    {
+        if (!mesh->isVisible())
+            continue;
+
+        for (auto usage : streamedUsages)
+        {
+            Texture2D* texture = mesh->getTexture(usage);
+            if (texture == nullptr || !texture->isStreamed())
+                continue;
+
+            // the texture mapping isn't known, so assume the texture spans the projected bounding box once
+            if (screenSize < 0)
+            {
+                AABB aabb;
+                for (auto it : _meshes)
+                {
+                    if (it->isVisible())
+                        aabb.merge(it->getAABB());
+                }
+                aabb.transform(transform);
+
+                Vec3 corners[8];
+                aabb.getCorners(corners);
+                Vec2 minPoint = camera->projectGL(corners[0]);
+                Vec2 maxPoint = minPoint;
+                for (int i = 1; i < 8; ++i)
+                {
+                    Vec2 point = camera->projectGL(corners[i]);
+                    minPoint.set(std::min(minPoint.x, point.x), std::min(minPoint.y, point.y));
+                    maxPoint.set(std::max(maxPoint.x, point.x), std::max(maxPoint.y, point.y));
+                }
+
+                screenSize = std::max(maxPoint.x - minPoint.x, maxPoint.y - minPoint.y);
+                auto glView = Director::getInstance()->getOpenGLView();
+                if (glView)
+                    screenSize *= glView->getScaleX() * glView->getRetinaFactor();
+                screenSize = std::max(screenSize, 1.0f);
+            }
+
+            float density = std::max(texture->getPixelsWide(), texture->getPixelsHigh()) / screenSize;
+            TextureStreamer::getInstance()->requestTexelDensity(texture, density);
+        }
+    }
+}
+
 void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
 #if CC_USE_CULLING
@@ -790,6 +846,8 @@ void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         }
     }
     
+    requestTextureDensities(transform);
+
     for (auto mesh: _meshes)
     {
         mesh->draw(renderer,
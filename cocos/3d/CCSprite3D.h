@@ -240,6 +240,8 @@ CC_CONSTRUCTOR_ACCESS:
     void afterAsyncLoad(void* param);
 
     static AABB getAABBRecursivelyImp(Node *node);
+
+    void requestTextureDensities(const Mat4& transform);
     
 protected:
 
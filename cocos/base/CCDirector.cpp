@@ -38,11 +38,16 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontAtlasCache.h"
+#include "2d/CCLabelLayoutCache.h"
+#include "2d/CCParticleSimulator.h"
+#include "2d/CCParticlePrototypeCache.h"
+#include "2d/CCParticleQuadBatcher.h"
 #include "2d/CCAnimationCache.h"
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureStreamer.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
 #include "2d/CCCamera.h"
@@ -93,6 +98,7 @@ const char *Director::EVENT_AFTER_VISIT = "director_after_visit";
 const char *Director::EVENT_BEFORE_UPDATE = "director_before_update";
 const char *Director::EVENT_AFTER_UPDATE = "director_after_update";
 const char *Director::EVENT_RESET = "director_reset";
+const char *Director::EVENT_PURGE_CACHED_DATA = "director_purge_cached_data";
 const char *Director::EVENT_BEFORE_DRAW = "director_before_draw";
 
 Director* Director::getInstance()
@@ -147,6 +153,7 @@ bool Director::init()
     _eventProjectionChanged = new (std::nothrow) EventCustom(EVENT_PROJECTION_CHANGED);
     _eventProjectionChanged->setUserData(this);
     _eventResetDirector = new (std::nothrow) EventCustom(EVENT_RESET);
+    _eventPurgeCachedData = new (std::nothrow) EventCustom(EVENT_PURGE_CACHED_DATA);
     //init TextureCache
     initTextureCache();
     initMatrixStack();
@@ -178,6 +185,7 @@ Director::~Director()
     CC_SAFE_RELEASE(_eventAfterVisit);
     CC_SAFE_RELEASE(_eventProjectionChanged);
     CC_SAFE_RELEASE(_eventResetDirector);
+    CC_SAFE_RELEASE(_eventPurgeCachedData);
 
     delete _renderer;
     delete _console;
@@ -645,8 +653,13 @@ void Director::setProjection(Projection projection)
 
 void Director::purgeCachedData()
 {
+    // caches living outside of cocos, such as the extensions, release what they hold first
+    if (_eventDispatcher)
+        _eventDispatcher->dispatchEvent(_eventPurgeCachedData);
+
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    LabelLayoutCache::purgeCachedData();
 
     if (s_SharedDirector->getOpenGLView())
     {
@@ -1012,6 +1025,7 @@ void Director::reset()
     // purge bitmap cache
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    LabelLayoutCache::purgeCachedData();
     
     FontFreeType::shutdownFreeType();
     
@@ -1020,6 +1034,10 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    ParticleSimulator::destroyInstance();
+    ParticlePrototypeCache::destroyInstance();
+    ParticleQuadBatcher::destroyInstance();
+    TextureStreamer::destroyInstance();
     backend::ProgramCache::destroyInstance();
     
     
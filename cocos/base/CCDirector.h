@@ -104,6 +104,8 @@ public:
     static const char* EVENT_AFTER_UPDATE;
     /** Director will trigger an event while resetting Director */
     static const char* EVENT_RESET;
+    /** Director will trigger an event when purgeCachedData() is invoked, before the textures are purged. */
+    static const char* EVENT_PURGE_CACHED_DATA;
     /** Director will trigger an event after Scene::render() is invoked. */
     static const char* EVENT_AFTER_VISIT;
     /** Director will trigger an event after a scene is drawn, the data is sent to GPU. */
@@ -564,6 +566,7 @@ protected:
     EventCustom* _eventBeforeUpdate = nullptr;
     EventCustom* _eventAfterUpdate = nullptr;
     EventCustom* _eventResetDirector = nullptr;
+    EventCustom* _eventPurgeCachedData = nullptr;
     EventCustom* _beforeSetNextScene = nullptr;
     EventCustom* _afterSetNextScene = nullptr;
         
@@ -119,6 +119,8 @@ THE SOFTWARE.
 #include "2d/CCFontFNT.h"
 #include "2d/CCLabel.h"
 #include "2d/CCLabelAtlas.h"
+#include "2d/CCLabelLayoutCache.h"
+#include "2d/CCTextBatchNode.h"
 #include "2d/CCLayer.h"
 #include "2d/CCMenu.h"
 #include "2d/CCMenuItem.h"
@@ -129,6 +131,9 @@ THE SOFTWARE.
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleSystemQuad.h"
+#include "2d/CCParticleSimulator.h"
+#include "2d/CCParticlePrototypeCache.h"
+#include "2d/CCParticleQuadBatcher.h"
 #include "2d/CCProgressTimer.h"
 #include "2d/CCProtectedNode.h"
 #include "2d/CCRenderTexture.h"
@@ -161,6 +166,8 @@ THE SOFTWARE.
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCube.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureTranscoder.h"
+#include "renderer/CCTextureStreamer.h"
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/ccShaders.h"
 
@@ -102,6 +102,24 @@ void ccVertexLineToPolygon(Vec2 *points, float stroke, Vec2 *vertices, unsigned
     }
 }
 
+void ccVertexRingStripIndices(unsigned int nuSlots, unsigned short *indices)
+{
+    for(unsigned int i = 0; i < nuSlots * 2; i++)
+    {
+        const unsigned short a = (unsigned short)((i % nuSlots) * 2);
+        const unsigned short b = (unsigned short)(((i + 1) % nuSlots) * 2);
+
+        // same winding as the TRIANGLE_STRIP a0, a1, b0, b1
+        indices[0] = a;
+        indices[1] = a + 1;
+        indices[2] = b;
+        indices[3] = a + 1;
+        indices[4] = b;
+        indices[5] = b + 1;
+        indices += 6;
+    }
+}
+
 bool ccVertexLineIntersect(float Ax, float Ay,
                                float Bx, float By,
                                float Cx, float Cy,
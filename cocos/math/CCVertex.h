@@ -41,6 +41,13 @@ NS_CC_BEGIN
 /** converts a line to a polygon */
 void CC_DLL ccVertexLineToPolygon(Vec2 *points, float stroke, Vec2 *vertices, unsigned int offset, unsigned int nuPoints);
 
+/** fills the triangle indices of a strip stored in a ring of nuSlots points, two vertices per point.
+ * Segment i joins slot i%nuSlots to slot (i+1)%nuSlots; the ring is written twice so that any run of
+ * segments starting inside the ring is contiguous. indices must hold 12 * nuSlots elements.
+ * The indices are 16 bit so they can be drawn on every device, nuSlots must not exceed 32768.
+ */
+void CC_DLL ccVertexRingStripIndices(unsigned int nuSlots, unsigned short *indices);
+
 /** returns whether or not the line intersects */
 bool CC_DLL ccVertexLineIntersect(float Ax, float Ay,
                              float Bx, float By,
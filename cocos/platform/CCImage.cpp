@@ -29,6 +29,8 @@ THE SOFTWARE.
 
 #include <string>
 #include <ctype.h>
+#include <vector>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccConfig.h" // CC_USE_JPEG, CC_USE_WEBP
@@ -433,6 +435,16 @@ namespace
         ssize_t size;
         int offset;
     }tImageSource;
+
+    void premultiplyAlphaPixels(unsigned char* data, ssize_t pixelCount)
+    {
+        unsigned int* fourBytes = (unsigned int*)data;
+        for (ssize_t i = 0; i < pixelCount; i++)
+        {
+            unsigned char* p = data + i * 4;
+            fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        }
+    }
  
 #if CC_USE_PNG
     static void pngReadCallback(png_structp png_ptr, png_bytep data, png_size_t length)
@@ -612,6 +624,56 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
     return ret;
 }
 
+bool Image::initWithImageDataStreamed(const unsigned char * data, ssize_t dataLen, int rowsPerChunk,
+                                      const RowStreamHeaderCallback& onHeader, const RowStreamChunkCallback& onChunk)
+{
+    bool ret = false;
+
+    do
+    {
+        CC_BREAK_IF(! data || dataLen <= 0 || rowsPerChunk <= 0);
+
+        unsigned char* unpackedData = nullptr;
+        ssize_t unpackedLen = 0;
+
+        //detect and unzip the compress file, the compressed stream itself is small compared to the decoded pixels
+        if (ZipUtils::isCCZBuffer(data, dataLen))
+        {
+            unpackedLen = ZipUtils::inflateCCZBuffer(data, dataLen, &unpackedData);
+        }
+        else if (ZipUtils::isGZipBuffer(data, dataLen))
+        {
+            unpackedLen = ZipUtils::inflateMemory(const_cast<unsigned char*>(data), dataLen, &unpackedData);
+        }
+        else
+        {
+            unpackedData = const_cast<unsigned char*>(data);
+            unpackedLen = dataLen;
+        }
+
+        _fileType = detectFormat(unpackedData, unpackedLen);
+
+        switch (_fileType)
+        {
+        case Format::PNG:
+            ret = initWithPngDataStreamed(unpackedData, unpackedLen, rowsPerChunk, onHeader, onChunk);
+            break;
+        case Format::JPG:
+            ret = initWithJpgDataStreamed(unpackedData, unpackedLen, rowsPerChunk, onHeader, onChunk);
+            break;
+        default:
+            break;
+        }
+
+        if(unpackedData != data)
+        {
+            free(unpackedData);
+        }
+    } while (0);
+
+    return ret;
+}
+
 bool Image::isPng(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 8)
@@ -896,6 +958,90 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
 #endif // CC_USE_JPEG
 }
 
+bool Image::initWithJpgDataStreamed(const unsigned char * data, ssize_t dataLen, int rowsPerChunk,
+                                    const RowStreamHeaderCallback& onHeader, const RowStreamChunkCallback& onChunk)
+{
+#if CC_USE_JPEG
+    struct jpeg_decompress_struct cinfo;
+    struct MyErrorMgr jerr;
+    // declared outside of the setjmp scope so a longjmp never skips its destructors
+    std::vector<unsigned char> chunkData;
+    std::vector<JSAMPROW> rowPointers;
+
+    bool ret = false;
+    do
+    {
+        cinfo.err = jpeg_std_error(&jerr.pub);
+        jerr.pub.error_exit = myErrorExit;
+        if (setjmp(jerr.setjmp_buffer))
+        {
+            jpeg_destroy_decompress(&cinfo);
+            break;
+        }
+
+        jpeg_create_decompress( &cinfo );
+
+#ifndef CC_TARGET_QT5
+        jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), dataLen);
+#endif /* CC_TARGET_QT5 */
+
+        jpeg_read_header(&cinfo, TRUE);
+
+        // we only support RGB or grayscale
+        if (cinfo.jpeg_color_space == JCS_GRAYSCALE)
+        {
+            _pixelFormat = backend::PixelFormat::I8;
+        }else
+        {
+            cinfo.out_color_space = JCS_RGB;
+            _pixelFormat = backend::PixelFormat::RGB888;
+        }
+
+        jpeg_start_decompress( &cinfo );
+
+        _width  = cinfo.output_width;
+        _height = cinfo.output_height;
+
+        if (!onHeader(this))
+        {
+            jpeg_destroy_decompress( &cinfo );
+            break;
+        }
+
+        size_t rowBytes = cinfo.output_width * cinfo.output_components;
+        int chunkRows = std::min(rowsPerChunk, _height);
+        chunkData.resize(rowBytes * chunkRows);
+        rowPointers.resize(chunkRows);
+        for (int i = 0; i < chunkRows; ++i)
+        {
+            rowPointers[i] = chunkData.data() + i * rowBytes;
+        }
+
+        while (cinfo.output_scanline < cinfo.output_height)
+        {
+            int firstRow = cinfo.output_scanline;
+            int rowCount = std::min(chunkRows, (int)(cinfo.output_height - cinfo.output_scanline));
+            int readRows = 0;
+            // jpeg_read_scanlines may return fewer rows than requested
+            while (readRows < rowCount)
+            {
+                readRows += jpeg_read_scanlines(&cinfo, rowPointers.data() + readRows, rowCount - readRows);
+            }
+            onChunk(chunkData.data(), firstRow, rowCount);
+        }
+
+        // see initWithJpgData() for why jpeg_finish_decompress() is not called
+        jpeg_destroy_decompress( &cinfo );
+        ret = true;
+    } while (0);
+
+    return ret;
+#else
+    CCLOG("jpeg is not enabled, please enable it in ccConfig.h");
+    return false;
+#endif // CC_USE_JPEG
+}
+
 bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
 {
 #if CC_USE_PNG
@@ -1053,6 +1199,137 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
 #endif //CC_USE_PNG
 }
 
+bool Image::initWithPngDataStreamed(const unsigned char * data, ssize_t dataLen, int rowsPerChunk,
+                                    const RowStreamHeaderCallback& onHeader, const RowStreamChunkCallback& onChunk)
+{
+#if CC_USE_PNG
+    bool ret = false;
+    png_byte        header[PNGSIGSIZE]   = {0};
+    png_structp     png_ptr     =   0;
+    png_infop       info_ptr    = 0;
+    // declared outside of the setjmp scope so a longjmp never skips its destructor
+    std::vector<unsigned char> chunkData;
+
+    do
+    {
+        CC_BREAK_IF(dataLen < PNGSIGSIZE);
+
+        memcpy(header, data, PNGSIGSIZE);
+        CC_BREAK_IF(png_sig_cmp(header, 0, PNGSIGSIZE));
+
+        png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+        CC_BREAK_IF(! png_ptr);
+
+        info_ptr = png_create_info_struct(png_ptr);
+        CC_BREAK_IF(!info_ptr);
+
+        CC_BREAK_IF(setjmp(png_jmpbuf(png_ptr)));
+
+        tImageSource imageSource;
+        imageSource.data    = (unsigned char*)data;
+        imageSource.size    = dataLen;
+        imageSource.offset  = 0;
+        png_set_read_fn(png_ptr, &imageSource, pngReadCallback);
+
+        png_read_info(png_ptr, info_ptr);
+
+        // interlaced rows are only complete after the last pass, they can't be streamed
+        CC_BREAK_IF(png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE);
+
+        _width = png_get_image_width(png_ptr, info_ptr);
+        _height = png_get_image_height(png_ptr, info_ptr);
+        png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+        png_uint_32 color_type = png_get_color_type(png_ptr, info_ptr);
+
+        // same transformations as initWithPngData()
+        if (color_type == PNG_COLOR_TYPE_PALETTE)
+        {
+            png_set_palette_to_rgb(png_ptr);
+        }
+        if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+        {
+            bit_depth = 8;
+            png_set_expand_gray_1_2_4_to_8(png_ptr);
+        }
+        if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+        {
+            png_set_tRNS_to_alpha(png_ptr);
+        }
+        if (bit_depth == 16)
+        {
+            png_set_strip_16(png_ptr);
+        }
+        if (bit_depth < 8)
+        {
+            png_set_packing(png_ptr);
+        }
+        png_read_update_info(png_ptr, info_ptr);
+        color_type = png_get_color_type(png_ptr, info_ptr);
+
+        switch (color_type)
+        {
+        case PNG_COLOR_TYPE_GRAY:
+            _pixelFormat = backend::PixelFormat::I8;
+            break;
+        case PNG_COLOR_TYPE_GRAY_ALPHA:
+            _pixelFormat = backend::PixelFormat::AI88;
+            break;
+        case PNG_COLOR_TYPE_RGB:
+            _pixelFormat = backend::PixelFormat::RGB888;
+            break;
+        case PNG_COLOR_TYPE_RGB_ALPHA:
+            _pixelFormat = backend::PixelFormat::RGBA8888;
+            break;
+        default:
+            break;
+        }
+
+        // premultiplied alpha for RGBA8888, band by band
+        bool premultiply = false;
+#if CC_ENABLE_PREMULTIPLIED_ALPHA != 0
+        if (color_type == PNG_COLOR_TYPE_RGB_ALPHA)
+        {
+            premultiply = PNG_PREMULTIPLIED_ALPHA_ENABLED;
+            _hasPremultipliedAlpha = true;
+        }
+#endif
+
+        CC_BREAK_IF(!onHeader(this));
+
+        png_size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+        int chunkRows = std::min(rowsPerChunk, _height);
+        chunkData.resize(rowbytes * chunkRows);
+
+        for (int firstRow = 0; firstRow < _height; firstRow += chunkRows)
+        {
+            int rowCount = std::min(chunkRows, _height - firstRow);
+            for (int i = 0; i < rowCount; ++i)
+            {
+                png_read_row(png_ptr, chunkData.data() + i * rowbytes, nullptr);
+            }
+            if (premultiply)
+            {
+                premultiplyAlphaPixels(chunkData.data(), (ssize_t)_width * rowCount);
+            }
+            onChunk(chunkData.data(), firstRow, rowCount);
+        }
+
+        png_read_end(png_ptr, nullptr);
+
+        ret = true;
+    } while (0);
+
+    if (png_ptr)
+    {
+        png_destroy_read_struct(&png_ptr, (info_ptr) ? &info_ptr : 0, 0);
+    }
+    return ret;
+#else
+    CCLOG("png is not enabled, please enable it in ccConfig.h");
+    return false;
+#endif //CC_USE_PNG
+}
+
 namespace
 {
     bool testFormatForPvr2TCSupport(PVR2TexturePixelFormat /*format*/)
@@ -2157,12 +2434,7 @@ void Image::premultiplyAlpha()
 #else
     CCASSERT(_pixelFormat == backend::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    premultiplyAlphaPixels(_data, (ssize_t)_width * _height);
     
     _hasPremultipliedAlpha = true;
 #endif
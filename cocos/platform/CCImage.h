@@ -28,6 +28,8 @@ THE SOFTWARE.
 #define __CC_IMAGE_H__
 /// @cond DO_NOT_SHOW
 
+#include <functional>
+
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 
@@ -130,6 +132,26 @@ public:
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, ssize_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
+    /** Called once the width, height and pixel format of a streamed image are known. Return false to abort decoding. */
+    typedef std::function<bool(Image* image)> RowStreamHeaderCallback;
+    /** Receives rowCount tightly packed rows, starting at row firstRow, in the pixel format of the image. */
+    typedef std::function<void(const unsigned char* rows, int firstRow, int rowCount)> RowStreamChunkCallback;
+
+    /**
+    @brief Decode PNG or JPEG data in bands of rows instead of into one image sized buffer.
+    Only one band of at most rowsPerChunk rows is alive at a time, and getData() stays null afterwards.
+    Formats that can't be decoded row by row (compressed textures, WebP, TGA, interlaced PNG) return false
+    before onHeader is called, so the caller can fall back to initWithImageData().
+    @param data  stream buffer which holds the image data.
+    @param dataLen  data length expressed in (number of) bytes.
+    @param rowsPerChunk  maximum number of rows passed to onChunk at once.
+    @return true if every row was decoded and handed to onChunk.
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageDataStreamed(const unsigned char * data, ssize_t dataLen, int rowsPerChunk,
+                                   const RowStreamHeaderCallback& onHeader, const RowStreamChunkCallback& onChunk);
+
     // Getters
     unsigned char *   getData()               { return _data; }
     ssize_t           getDataLen()            { return _dataLen; }
@@ -159,6 +181,10 @@ public:
 protected:
     bool initWithJpgData(const unsigned char *  data, ssize_t dataLen);
     bool initWithPngData(const unsigned char * data, ssize_t dataLen);
+    bool initWithJpgDataStreamed(const unsigned char * data, ssize_t dataLen, int rowsPerChunk,
+                                 const RowStreamHeaderCallback& onHeader, const RowStreamChunkCallback& onChunk);
+    bool initWithPngDataStreamed(const unsigned char * data, ssize_t dataLen, int rowsPerChunk,
+                                 const RowStreamHeaderCallback& onHeader, const RowStreamChunkCallback& onChunk);
     bool initWithWebpData(const unsigned char * data, ssize_t dataLen);
     bool initWithPVRData(const unsigned char * data, ssize_t dataLen);
     bool initWithPVRv2Data(const unsigned char * data, ssize_t dataLen);
@@ -158,6 +158,9 @@ public:
     /** Pops a group from the render queue */
     void popGroup();
 
+    /** Returns the Id of the render queue that addCommand(RenderCommand*) currently adds to */
+    int getCurrentRenderQueueID() const { return _commandGroupStack.top(); }
+
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
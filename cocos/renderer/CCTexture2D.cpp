@@ -48,6 +48,7 @@ THE SOFTWARE.
 #include "renderer/backend/ProgramState.h"
 #include "renderer/ccShaders.h"
 #include "renderer/CCTextureUtils.h"
+#include "renderer/CCTextureStreamer.h"
 #include "renderer/CCRenderer.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -113,6 +114,54 @@ namespace {
         PixelFormatInfoMapValue(backend::PixelFormat::MTL_BGR5A1, Texture2D::PixelFormatInfo(16, false, true)),
 #endif
     };
+
+    backend::PixelFormat getRenderFormat(backend::PixelFormat imagePixelFormat, backend::PixelFormat format)
+    {
+        backend::PixelFormat renderFormat = ((PixelFormat::NONE == format) || (PixelFormat::AUTO == format)) ? imagePixelFormat : format;
+
+#ifdef CC_USE_METAL
+        //compressed format does not need conversion
+        switch (imagePixelFormat) {
+            case PixelFormat::PVRTC4A:
+            case PixelFormat::PVRTC4:
+            case PixelFormat::PVRTC2A:
+            case PixelFormat::PVRTC2:
+            case PixelFormat::A8:
+                renderFormat = imagePixelFormat;
+            default:
+                break;
+        }
+        //override renderFormat, since some render format is not supported by metal
+        switch (renderFormat)
+        {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS && !TARGET_OS_SIMULATOR)
+            //packed 16 bits pixels only available on iOS
+            case PixelFormat::RGB565:
+                renderFormat = PixelFormat::MTL_B5G6R5;
+                break;
+            case PixelFormat::RGBA4444:
+                renderFormat = PixelFormat::MTL_ABGR4;
+                break;
+            case PixelFormat::RGB5A1:
+                renderFormat = PixelFormat::MTL_BGR5A1;
+                break;
+#else
+            case PixelFormat::RGB565:
+            case PixelFormat::RGB5A1:
+            case PixelFormat::RGBA4444:
+#endif
+            case PixelFormat::I8:
+            case PixelFormat::AI88:
+                //TODO: conversion RGBA8888 -> I8(AI88) -> RGBA8888 may happends
+                renderFormat = PixelFormat::RGBA8888;
+                break;
+            default:
+                break;
+        }
+#endif
+
+        return renderFormat;
+    }
 }
 
 //CLASS IMPLEMENTATIONS:
@@ -137,6 +186,7 @@ Texture2D::Texture2D()
 , _antialiasEnabled(true)
 , _ninePatchInfo(nullptr)
 , _valid(true)
+, _streamed(false)
 , _alphaTexture(nullptr)
 {
     backend::TextureDescriptor textureDescriptor;
@@ -151,6 +201,9 @@ Texture2D::~Texture2D()
 #endif
     CC_SAFE_RELEASE_NULL(_alphaTexture); // ETC1 ALPHA support.
 
+    if (_streamed)
+        TextureStreamer::getInstance()->removeTexture(this);
+
     CCLOGINFO("deallocing Texture2D: %p - id=%u", this, _name);
 
     CC_SAFE_DELETE(_ninePatchInfo);
@@ -307,7 +360,8 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, backend::Pi
         textureDescriptor.textureFormat = pixelFormat;
         CCASSERT(textureDescriptor.textureFormat != backend::PixelFormat::NONE, "PixelFormat should not be NONE");
 
-        if(_texture->getTextureFormat() != textureDescriptor.textureFormat)
+        if(_texture->getTextureFormat() != textureDescriptor.textureFormat
+           || (i == 0 && (_texture->getWidth() != (std::size_t)width || _texture->getHeight() != (std::size_t)height)))
             _texture->updateTextureDescriptor(textureDescriptor);
 
         if(info.compressed)
@@ -373,6 +427,9 @@ bool Texture2D::initWithImage(Image *image, backend::PixelFormat format)
         return false;
     }
 
+    if (_streamed)
+        TextureStreamer::getInstance()->removeTexture(this);
+
     int imageWidth = image->getWidth();
     int imageHeight = image->getHeight();
     this->_filePath = image->getFilePath();
@@ -387,52 +444,10 @@ bool Texture2D::initWithImage(Image *image, backend::PixelFormat format)
 
     unsigned char*   tempData = image->getData();
     Size             imageSize = Size((float)imageWidth, (float)imageHeight);
-    backend::PixelFormat      renderFormat = ((PixelFormat::NONE == format) || (PixelFormat::AUTO == format)) ? image->getPixelFormat() : format;
     backend::PixelFormat      imagePixelFormat = image->getPixelFormat();
+    backend::PixelFormat      renderFormat = getRenderFormat(imagePixelFormat, format);
     size_t           tempDataLen = image->getDataLen();
 
-    
-#ifdef CC_USE_METAL
-    //compressed format does not need conversion
-    switch (imagePixelFormat) {
-        case PixelFormat::PVRTC4A:
-        case PixelFormat::PVRTC4:
-        case PixelFormat::PVRTC2A:
-        case PixelFormat::PVRTC2:
-        case PixelFormat::A8:
-            renderFormat = imagePixelFormat;
-        default:
-            break;
-    }
-    //override renderFormat, since some render format is not supported by metal
-    switch (renderFormat)
-    {
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS && !TARGET_OS_SIMULATOR)
-        //packed 16 bits pixels only available on iOS
-        case PixelFormat::RGB565:
-            renderFormat = PixelFormat::MTL_B5G6R5;
-            break;
-        case PixelFormat::RGBA4444:
-            renderFormat = PixelFormat::MTL_ABGR4;
-            break;
-        case PixelFormat::RGB5A1:
-            renderFormat = PixelFormat::MTL_BGR5A1;
-            break;
-#else
-        case PixelFormat::RGB565:
-        case PixelFormat::RGB5A1:
-        case PixelFormat::RGBA4444:
-#endif
-        case PixelFormat::I8:
-        case PixelFormat::AI88:
-            //TODO: conversion RGBA8888 -> I8(AI88) -> RGBA8888 may happends
-            renderFormat = PixelFormat::RGBA8888;
-            break;
-        default:
-            break;
-    }
-#endif
-
     if (image->getNumberOfMipmaps() > 1)
     {
         if (renderFormat != image->getPixelFormat())
@@ -466,6 +481,152 @@ bool Texture2D::initWithImage(Image *image, backend::PixelFormat format)
     }
 }
 
+bool Texture2D::initWithImageStreamed(Image *image)
+{
+    // the streamer reads the levels again from the file, images decoded from memory can't be streamed
+    if (image == nullptr || image->getNumberOfMipmaps() <= 1 || image->getFilePath().empty())
+    {
+        return initWithImage(image);
+    }
+
+    int imageWidth = image->getWidth();
+    int imageHeight = image->getHeight();
+    this->_filePath = image->getFilePath();
+
+    int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    if (imageWidth > maxTextureSize || imageHeight > maxTextureSize)
+    {
+        CCLOG("cocos2d: WARNING: Image (%u x %u) is bigger than the supported %u x %u", imageWidth, imageHeight, maxTextureSize, maxTextureSize);
+        return false;
+    }
+
+    backend::PixelFormat renderFormat = getRenderFormat(image->getPixelFormat(), g_defaultAlphaPixelFormat);
+    TextureStreamer* streamer = TextureStreamer::getInstance();
+    int baseLevel = streamer->getInitialMipLevel(imageWidth, imageHeight, image->getNumberOfMipmaps());
+
+    if (!updateResidentMipmaps(image->getMipmaps(), image->getNumberOfMipmaps(), baseLevel, image->getPixelFormat(), renderFormat, imageWidth, imageHeight, image->hasPremultipliedAlpha()))
+    {
+        return false;
+    }
+
+    streamer->addTexture(this, image, renderFormat, baseLevel);
+    return true;
+}
+
+bool Texture2D::updateResidentMipmaps(MipmapInfo* mipmaps, int mipmapsNum, int baseLevel, backend::PixelFormat pixelFormat, backend::PixelFormat renderFormat, int pixelsWide, int pixelsHigh, bool preMultipliedAlpha)
+{
+    int width = MAX(pixelsWide >> baseLevel, 1);
+    int height = MAX(pixelsHigh >> baseLevel, 1);
+    if (!initWithMipmaps(mipmaps + baseLevel, mipmapsNum - baseLevel, pixelFormat, renderFormat, width, height, preMultipliedAlpha))
+    {
+        return false;
+    }
+
+    // texture coordinates are normalized, so the texture keeps the size of the full image
+    _contentSize = Size((float)pixelsWide, (float)pixelsHigh);
+    _pixelsWide = pixelsWide;
+    _pixelsHigh = pixelsHigh;
+    return true;
+}
+
+bool Texture2D::initWithImageDataStreamed(const unsigned char* data, ssize_t dataLen, backend::PixelFormat format, int rowsPerChunk)
+{
+    Image image;
+    int width = 0;
+    int height = 0;
+    backend::PixelFormat imagePixelFormat = PixelFormat::NONE;
+    backend::PixelFormat renderFormat = PixelFormat::NONE;
+
+    auto onHeader = [&](Image* header) -> bool {
+        width = header->getWidth();
+        height = header->getHeight();
+
+        int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+        if (width > maxTextureSize || height > maxTextureSize)
+        {
+            CCLOG("cocos2d: WARNING: Image (%u x %u) is bigger than the supported %u x %u", width, height, maxTextureSize, maxTextureSize);
+            return false;
+        }
+
+        imagePixelFormat = header->getPixelFormat();
+        renderFormat = getRenderFormat(imagePixelFormat, format);
+        if (renderFormat != imagePixelFormat)
+        {
+            // probe the conversion with one pixel, keep the image format if it isn't supported like initWithMipmaps() does
+            unsigned char pixel[4] = {0};
+            unsigned char* outPixel = nullptr;
+            size_t outPixelLen = 0;
+            if (backend::PixelFormatUtils::convertDataToFormat(pixel, getBitsPerPixelForFormat(imagePixelFormat) / 8, imagePixelFormat, renderFormat, &outPixel, &outPixelLen) != renderFormat)
+            {
+                renderFormat = imagePixelFormat;
+            }
+            if (outPixel && outPixel != pixel)
+            {
+                free(outPixel);
+            }
+        }
+        if (_pixelFormatInfoTables.find(renderFormat) == _pixelFormatInfoTables.end())
+        {
+            CCLOG("cocos2d: WARNING: unsupported pixelformat: %lx", (unsigned long)renderFormat);
+            return false;
+        }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        VolatileTextureMgr::findVolotileTexture(this);
+#endif
+
+        backend::TextureDescriptor textureDescriptor;
+        textureDescriptor.width = width;
+        textureDescriptor.height = height;
+        textureDescriptor.textureFormat = renderFormat;
+        textureDescriptor.samplerDescriptor.magFilter = (_antialiasEnabled) ? backend::SamplerFilter::LINEAR : backend::SamplerFilter::NEAREST;
+        textureDescriptor.samplerDescriptor.minFilter = (_antialiasEnabled) ? backend::SamplerFilter::LINEAR : backend::SamplerFilter::NEAREST;
+        // every row is uploaded by onChunk, clearing the storage first would only cost a full size upload
+        textureDescriptor.zeroInitialized = false;
+        _texture->updateTextureDescriptor(textureDescriptor);
+        return true;
+    };
+
+    // every band is converted into the same staging buffer, it only grows if a band is taller than the previous ones
+    std::vector<unsigned char> stagingBuffer;
+
+    auto onChunk = [&](const unsigned char* rows, int firstRow, int rowCount) {
+        unsigned char* chunkData = const_cast<unsigned char*>(rows);
+        size_t chunkDataLen = (size_t)width * rowCount * getBitsPerPixelForFormat(imagePixelFormat) / 8;
+        unsigned char* outData = chunkData;
+        size_t outDataLen = chunkDataLen;
+
+        if (renderFormat != imagePixelFormat)
+        {
+            size_t stagingLen = (size_t)width * rowCount * getBitsPerPixelForFormat(renderFormat) / 8;
+            if (stagingBuffer.size() < stagingLen)
+            {
+                stagingBuffer.resize(stagingLen);
+            }
+            backend::PixelFormatUtils::convertDataToFormat(chunkData, chunkDataLen, imagePixelFormat, renderFormat, &outData, &outDataLen, stagingBuffer.data());
+        }
+
+        _texture->updateSubData(0, firstRow, width, rowCount, 0, outData);
+    };
+
+    if (!image.initWithImageDataStreamed(data, dataLen, rowsPerChunk, onHeader, onChunk))
+    {
+        return false;
+    }
+
+    _contentSize = Size((float)width, (float)height);
+    _pixelsWide = width;
+    _pixelsHigh = height;
+    _pixelFormat = renderFormat;
+    _maxS = 1;
+    _maxT = 1;
+
+    _hasPremultipliedAlpha = image.hasPremultipliedAlpha();
+    _hasMipmaps = false;
+
+    return true;
+}
+
 // implementation Texture2D (Text)
 bool Texture2D::initWithString(const char *text, const std::string& fontName, float fontSize, const Size& dimensions/* = Size(0, 0)*/, TextHAlignment hAlignment/* =  TextHAlignment::CENTER */, TextVAlignment vAlignment/* =  TextVAlignment::TOP */, bool enableWrap /* = false */, int overflow /* = 0 */)
 {
@@ -210,6 +210,33 @@ public:
     **/
     bool initWithImage(Image * image, backend::PixelFormat format);
 
+    /**
+    Initializes a texture from encoded PNG or JPEG data without holding the decoded image in memory.
+
+    The data is decoded a band of rows at a time, and every band is converted to the texture format and
+    uploaded with a sub-image update, so peak memory is one band instead of the image plus a converted copy.
+    Returns false if the data can't be streamed (see Image::initWithImageDataStreamed()), the caller
+    should fall back to initWithImage() in that case.
+    @param data The encoded image file content.
+    @param dataLen The length of data in bytes.
+    @param format Texture pixel formats, PixelFormat::AUTO keeps the decoded format.
+    @param rowsPerChunk The number of rows decoded and uploaded per step.
+    */
+    bool initWithImageDataStreamed(const unsigned char* data, ssize_t dataLen, backend::PixelFormat format, int rowsPerChunk = 64);
+
+    /**
+    Initializes a texture from an image with mipmaps, uploading only its smallest levels.
+
+    The texture is handed to TextureStreamer, which reads the image file again and uploads higher
+    levels as sprites draw it larger on screen. Images without mipmaps or without a file they were
+    loaded from are loaded with initWithImage().
+    @param image An UIImage object with mipmaps, such as a PVR or KTX file.
+    */
+    bool initWithImageStreamed(Image * image);
+
+    /** Whether or not the mipmap levels of the texture are managed by TextureStreamer. */
+    bool isStreamed() const { return _streamed; }
+
     /** Initializes a texture from a string with dimensions, alignment, font name and font size. 
      
      @param text A null terminated string.
@@ -368,6 +395,12 @@ private:
     void addSpriteFrameCapInset(SpriteFrame* spritframe, const Rect& capInsets);
     
     void initProgram();
+
+    /**
+     * Uploads the mipmaps from baseLevel on as the whole texture, keeping the size of the full image.
+     * Used by TextureStreamer to change the resident levels of a streamed texture.
+     */
+    bool updateResidentMipmaps(MipmapInfo* mipmaps, int mipmapsNum, int baseLevel, backend::PixelFormat pixelFormat, backend::PixelFormat renderFormat, int pixelsWide, int pixelsHigh, bool preMultipliedAlpha);
    
 protected:
     /** pixel format of the texture */
@@ -405,8 +438,10 @@ protected:
     friend class SpriteFrameCache;
     friend class TextureCache;
     friend class ui::Scale9Sprite;
+    friend class TextureStreamer;
 
     bool _valid;
+    bool _streamed;
     std::string _filePath;
 
     Texture2D* _alphaTexture;
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -41,6 +42,10 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
+#include "base/CCConfiguration.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/ZipUtils.h"
+#include "renderer/CCTextureTranscoder.h"
 #include "renderer/backend/Device.h"
 //#include "renderer/backend/StringUtils.h"
 
@@ -67,6 +72,13 @@ TextureCache::TextureCache()
 : _loadingThread(nullptr)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _streamingDecodeThreshold(0)
+, _transcodingEnabled(false)
+, _mipmapStreamingEnabled(false)
+, _memoryBudget(0)
+, _totalMemoryUsage(0)
+, _evictedDataCacheSize(0)
+, _evictedDataSize(0)
 {
 }
 
@@ -324,6 +336,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         if (it != _textures.end())
         {
             texture = it->second;
+            touchTexture(asyncStruct->filename);
         }
         else
         {
@@ -342,8 +355,9 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
 #endif
                 // cache the texture. retain it, since it is added in the map
-                _textures.emplace(asyncStruct->filename, texture);
+                insertTexture(asyncStruct->filename, texture);
                 texture->retain();
+                enforceMemoryBudget();
 
                 texture->autorelease();
                 // ETC1 ALPHA supports.
@@ -392,33 +406,106 @@ Texture2D * TextureCache::addImage(const std::string &path)
         return nullptr;
     }
     auto it = _textures.find(fullpath);
-    if (it != _textures.end())
+    bool cached = it != _textures.end();
+    if (cached)
+    {
         texture = it->second;
+        touchTexture(fullpath);
+    }
 
     if (!texture)
     {
+        // the file content may still be in memory if the texture was evicted recently
+        Data data = takeEvictedData(fullpath);
+        std::string alphaBasePath = path;
+        std::string transcodePath;
+
+        // a transcoded ETC1 copy from an earlier run replaces the source file
+        if (_transcodingEnabled && Configuration::getInstance()->supportsETC() && !NinePatchImageParser::isNinePatchImage(path))
+        {
+            if (data.isNull())
+            {
+                data = FileUtils::getInstance()->getDataFromFile(fullpath);
+            }
+            // the file is hashed only when it can go through the transcoder
+            if (isTranscodableData(data))
+            {
+                std::string cachedPath = TextureTranscoder::getCachedFilePath(data);
+                if (FileUtils::getInstance()->isFileExist(cachedPath))
+                {
+                    data = FileUtils::getInstance()->getDataFromFile(cachedPath);
+                    alphaBasePath = cachedPath;
+                }
+                else
+                {
+                    transcodePath = cachedPath;
+                }
+            }
+        }
+
+        // big PNG/JPEG files are decoded straight into the texture, a band of rows at a time,
+        // unless the decoded image is still needed for transcoding
+        if (_streamingDecodeThreshold > 0 && transcodePath.empty() && alphaBasePath == path && !NinePatchImageParser::isNinePatchImage(path))
+        {
+            if (data.isNull())
+            {
+                data = FileUtils::getInstance()->getDataFromFile(fullpath);
+            }
+            if (data.getSize() >= _streamingDecodeThreshold)
+            {
+                texture = new (std::nothrow) Texture2D();
+                if (texture && texture->initWithImageDataStreamed(data.getBytes(), data.getSize(), Texture2D::getDefaultAlphaPixelFormat()))
+                {
+                    texture->_filePath = fullpath;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+                    VolatileTextureMgr::addImageTexture(texture, fullpath);
+#endif
+                    insertTexture(fullpath, texture);
+                    enforceMemoryBudget();
+                    return texture;
+                }
+                CC_SAFE_RELEASE_NULL(texture);
+            }
+        }
+
         // all images are handled by UIImage except PVR extension that is handled by our own handler
         do
         {
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = false;
+            if (data.isNull())
+            {
+                bRet = image->initWithImageFile(fullpath);
+            }
+            else
+            {
+                // reuse the file content read above
+                image->_filePath = fullpath;
+                bRet = image->initWithImageData(data.getBytes(), data.getSize());
+            }
             CC_BREAK_IF(!bRet);
 
             texture = new (std::nothrow) Texture2D();
 
-            if (texture && texture->initWithImage(image))
+            bool textureInited = false;
+            if (texture)
+            {
+                textureInited = _mipmapStreamingEnabled ? texture->initWithImageStreamed(image) : texture->initWithImage(image);
+            }
+
+            if (textureInited)
             {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
                 VolatileTextureMgr::addImageTexture(texture, fullpath);
 #endif
                 // texture already retained, no need to re-retain it
-                _textures.emplace(fullpath, texture);
+                insertTexture(fullpath, texture);
 
                 //-- ANDROID ETC1 ALPHA SUPPORTS.
-                std::string alphaFullPath = path + s_etc1AlphaFileSuffix;
+                std::string alphaFullPath = alphaBasePath + s_etc1AlphaFileSuffix;
                 if (image->getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty() && FileUtils::getInstance()->isFileExist(alphaFullPath))
                 {
                     Image alphaImage;
@@ -434,6 +521,12 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+
+                // transcode in the background, the next load will pick up the cached file
+                if (!transcodePath.empty() && TextureTranscoder::canTranscode(image))
+                {
+                    transcodeImageAsync(image, transcodePath);
+                }
             }
             else
             {
@@ -446,9 +539,91 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
     CC_SAFE_RELEASE(image);
 
+    if (texture && !cached)
+    {
+        enforceMemoryBudget();
+    }
+
     return texture;
 }
 
+void TextureCache::setStreamingDecodeThreshold(ssize_t minFileSize)
+{
+    _streamingDecodeThreshold = minFileSize;
+}
+
+ssize_t TextureCache::getStreamingDecodeThreshold() const
+{
+    return _streamingDecodeThreshold;
+}
+
+void TextureCache::setTranscodingEnabled(bool enabled)
+{
+    _transcodingEnabled = enabled;
+}
+
+bool TextureCache::isTranscodingEnabled() const
+{
+    return _transcodingEnabled;
+}
+
+void TextureCache::setMipmapStreamingEnabled(bool enabled)
+{
+    _mipmapStreamingEnabled = enabled;
+}
+
+bool TextureCache::isMipmapStreamingEnabled() const
+{
+    return _mipmapStreamingEnabled;
+}
+
+bool TextureCache::isTranscodableData(const Data& data)
+{
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    // GPU compressed files, zipped or not, are uploaded as they are, only decoded images are transcoded
+    if (ZipUtils::isCCZBuffer(data.getBytes(), data.getSize()) || ZipUtils::isGZipBuffer(data.getBytes(), data.getSize()))
+    {
+        return false;
+    }
+
+    Image image;
+    switch (image.detectFormat(data.getBytes(), data.getSize()))
+    {
+        case Image::Format::PVR:
+        case Image::Format::ETC:
+        case Image::Format::S3TC:
+        case Image::Format::ATITC:
+            return false;
+        default:
+            return true;
+    }
+}
+
+void TextureCache::transcodeImageAsync(Image* image, const std::string& cachedPath)
+{
+    std::string cacheDirectory = TextureTranscoder::getCacheDirectory();
+    if (!FileUtils::getInstance()->isDirectoryExist(cacheDirectory) && !FileUtils::getInstance()->createDirectory(cacheDirectory))
+    {
+        CCLOG("cocos2d: Couldn't create texture transcoding cache directory:%s", cacheDirectory.c_str());
+        return;
+    }
+
+    // the image is only read by the task and released on the GL thread once it is done
+    image->retain();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [image](void*) {
+        image->release();
+    }, nullptr, [image, cachedPath]() {
+        if (!TextureTranscoder::encodeETC1(image, cachedPath))
+        {
+            CCLOG("cocos2d: Couldn't transcode texture to:%s", cachedPath.c_str());
+        }
+    });
+}
+
 void TextureCache::parseNinePatchImage(cocos2d::Image *image, cocos2d::Texture2D *texture, const std::string& path)
 {
     if (NinePatchImageParser::isNinePatchImage(path))
@@ -472,6 +647,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if (it != _textures.end()) {
             texture = it->second;
+            touchTexture(key);
             break;
         }
 
@@ -481,7 +657,9 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         {
             if (texture->initWithImage(image))
             {
-                _textures.emplace(key, texture);
+                insertTexture(key, texture);
+                _imageKeys.insert(key);
+                enforceMemoryBudget();
             }
             else
             {
@@ -551,6 +729,12 @@ void TextureCache::removeAllTextures()
         texture.second->release();
     }
     _textures.clear();
+    _totalMemoryUsage = 0;
+    _lruKeys.clear();
+    _textureUsages.clear();
+    _imageKeys.clear();
+    _evictedData.clear();
+    _evictedDataSize = 0;
 }
 
 void TextureCache::removeUnusedTextures()
@@ -561,7 +745,7 @@ void TextureCache::removeUnusedTextures()
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
             tex->release();
-            it = _textures.erase(it);
+            it = eraseTexture(it);
         }
         else {
             ++it;
@@ -580,7 +764,7 @@ void TextureCache::removeTexture(Texture2D* texture)
     for (auto it = _textures.cbegin(); it != _textures.cend(); /* nothing */) {
         if (it->second == texture) {
             it->second->release();
-            it = _textures.erase(it);
+            eraseTexture(it);
             break;
         }
         else
@@ -600,7 +784,7 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
 
     if (it != _textures.end()) {
         it->second->release();
-        _textures.erase(it);
+        eraseTexture(it);
     }
 }
 
@@ -615,7 +799,10 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if (it != _textures.end())
+    {
+        touchTexture(key);
         return it->second;
+    }
     return nullptr;
 }
 
@@ -642,43 +829,251 @@ void TextureCache::waitForQuit()
     if (_loadingThread) _loadingThread->join();
 }
 
+size_t TextureCache::getTextureMemorySize(Texture2D* texture)
+{
+    // Each texture takes up width * height * bytesPerPixel bytes, a full mipmap chain adds a third.
+    size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    if (texture->hasMipmaps())
+    {
+        bytes += bytes / 3;
+    }
+    return bytes;
+}
+
+std::vector<TextureCache::TextureMemoryInfo> TextureCache::getTextureMemoryInfo() const
+{
+    std::vector<TextureMemoryInfo> infos;
+    infos.reserve(_textures.size());
+
+    for (auto& texture : _textures) {
+        Texture2D* tex = texture.second;
+        TextureMemoryInfo info;
+        info.key = texture.first;
+        info.pixelFormat = tex->getPixelFormat();
+        info.pixelsWide = tex->getPixelsWide();
+        info.pixelsHigh = tex->getPixelsHigh();
+        info.bytes = getTextureMemorySize(tex);
+        info.referenceCount = tex->getReferenceCount();
+        auto usage = _textureUsages.find(texture.first);
+        info.lastUsedFrame = usage != _textureUsages.end() ? usage->second.lastUsedFrame : 0;
+        infos.push_back(info);
+    }
+
+    return infos;
+}
+
+std::map<backend::PixelFormat, size_t> TextureCache::getMemoryUsageByPixelFormat() const
+{
+    std::map<backend::PixelFormat, size_t> usage;
+    for (auto& texture : _textures) {
+        usage[texture.second->getPixelFormat()] += getTextureMemorySize(texture.second);
+    }
+    return usage;
+}
+
+size_t TextureCache::getTotalMemoryUsage() const
+{
+    return _totalMemoryUsage;
+}
+
 std::string TextureCache::getCachedTextureInfo() const
 {
     std::string buffer;
     char buftmp[4096];
 
     unsigned int count = 0;
-    unsigned int totalBytes = 0;
+    size_t totalBytes = 0;
 
-    for (auto& texture : _textures) {
+    for (auto& info : getTextureMemoryInfo()) {
 
         memset(buftmp, 0, sizeof(buftmp));
 
-
-        Texture2D* tex = texture.second;
-        unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
-        totalBytes += bytes;
+        totalBytes += info.bytes;
         count++;
-        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%p %lu x %lu @ %ld bpp => %lu KB\n",
-            texture.first.c_str(),
-            (long)tex->getReferenceCount(),
-            tex->getBackendTexture(),
-            (long)tex->getPixelsWide(),
-            (long)tex->getPixelsHigh(),
-            (long)bpp,
-            (long)bytes / 1024);
+        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu %lu x %lu @ %ld bpp => %lu KB, last used at frame %u\n",
+            info.key.c_str(),
+            (long)info.referenceCount,
+            (long)info.pixelsWide,
+            (long)info.pixelsHigh,
+            (long)Texture2D::getPixelFormatInfoMap().at(info.pixelFormat).bpp,
+            (long)info.bytes / 1024,
+            info.lastUsedFrame);
+
+        buffer += buftmp;
+    }
 
+    for (auto& usage : getMemoryUsageByPixelFormat()) {
+        snprintf(buftmp, sizeof(buftmp) - 1, "format %d => %lu KB\n", static_cast<int>(usage.first), (long)usage.second / 1024);
         buffer += buftmp;
     }
 
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_memoryBudget > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp) - 1, "memory budget %lu KB, %ld evicted files kept for %lu KB\n", (long)_memoryBudget / 1024, (long)_evictedData.size(), (long)_evictedDataSize / 1024);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+size_t TextureCache::getMemoryBudget() const
+{
+    return _memoryBudget;
+}
+
+void TextureCache::setEvictedDataCacheSize(size_t bytes)
+{
+    _evictedDataCacheSize = bytes;
+    while (_evictedDataSize > _evictedDataCacheSize && !_evictedData.empty())
+    {
+        _evictedDataSize -= _evictedData.back().second.getSize();
+        _evictedData.pop_back();
+    }
+}
+
+size_t TextureCache::getEvictedDataCacheSize() const
+{
+    return _evictedDataCacheSize;
+}
+
+void TextureCache::insertTexture(const std::string& key, Texture2D* texture)
+{
+    if (!_textures.emplace(key, texture).second)
+    {
+        return;
+    }
+
+    // the size is recorded so that removing the texture gives back exactly what was added
+    TextureUsage usage;
+    usage.lruPosition = _lruKeys.insert(_lruKeys.begin(), key);
+    usage.lastUsedFrame = Director::getInstance()->getTotalFrames();
+    usage.bytes = getTextureMemorySize(texture);
+    _totalMemoryUsage += usage.bytes;
+    _textureUsages[key] = usage;
+}
+
+std::unordered_map<std::string, Texture2D*>::const_iterator TextureCache::eraseTexture(std::unordered_map<std::string, Texture2D*>::const_iterator it)
+{
+    auto usage = _textureUsages.find(it->first);
+    if (usage != _textureUsages.end())
+    {
+        _totalMemoryUsage -= usage->second.bytes;
+        _lruKeys.erase(usage->second.lruPosition);
+        _textureUsages.erase(usage);
+    }
+    _imageKeys.erase(it->first);
+    return _textures.erase(it);
+}
+
+void TextureCache::touchTexture(const std::string& key) const
+{
+    auto usage = _textureUsages.find(key);
+    if (usage != _textureUsages.end())
+    {
+        _lruKeys.splice(_lruKeys.begin(), _lruKeys, usage->second.lruPosition);
+        usage->second.lastUsedFrame = Director::getInstance()->getTotalFrames();
+    }
+}
+
+void TextureCache::enforceMemoryBudget()
+{
+    if (_memoryBudget == 0)
+    {
+        return;
+    }
+
+    // walk from the least recently used texture and stop at the ones handed out this frame;
+    // textures retained elsewhere are skipped, and so are the ones added from an Image since
+    // they have no file to be loaded again from
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    auto lruIt = _lruKeys.end();
+    while (_totalMemoryUsage > _memoryBudget && lruIt != _lruKeys.begin())
+    {
+        --lruIt;
+        if (_textureUsages[*lruIt].lastUsedFrame == currentFrame)
+        {
+            break;
+        }
+
+        auto it = _textures.find(*lruIt);
+        if (it->second->getReferenceCount() != 1 || _imageKeys.find(it->first) != _imageKeys.end())
+        {
+            continue;
+        }
+
+        CCLOG("cocos2d: TextureCache: evicting texture: %s", it->first.c_str());
+        // erasing the texture erases its list entry, continue from the more recent neighbour
+        ++lruIt;
+        keepEvictedData(it->first);
+        it->second->release();
+        eraseTexture(it);
+    }
+}
+
+void TextureCache::keepEvictedData(const std::string& key)
+{
+    if (_evictedDataCacheSize == 0 || !FileUtils::getInstance()->isAbsolutePath(key))
+    {
+        return;
+    }
+
+    // eviction runs inside insertions on the main thread, so the file is read on the IO thread
+    auto data = std::make_shared<Data>();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [key, data](void*) {
+        auto textureCache = Director::getInstance()->getTextureCache();
+        if (textureCache)
+        {
+            textureCache->storeEvictedData(key, std::move(*data));
+        }
+    }, nullptr, [key, data]() {
+        *data = FileUtils::getInstance()->getDataFromFile(key);
+    });
+}
+
+void TextureCache::storeEvictedData(const std::string& key, Data data)
+{
+    // the texture may have been loaded again while the file was read
+    if (data.isNull() || (size_t)data.getSize() > _evictedDataCacheSize || _textures.find(key) != _textures.end())
+    {
+        return;
+    }
+
+    // a file evicted again before being taken replaces its older copy
+    takeEvictedData(key);
+    _evictedDataSize += data.getSize();
+    _evictedData.emplace_front(key, std::move(data));
+    while (_evictedDataSize > _evictedDataCacheSize)
+    {
+        _evictedDataSize -= _evictedData.back().second.getSize();
+        _evictedData.pop_back();
+    }
+}
+
+Data TextureCache::takeEvictedData(const std::string& key)
+{
+    Data data;
+    for (auto it = _evictedData.begin(); it != _evictedData.end(); ++it)
+    {
+        if (it->first == key)
+        {
+            data = std::move(it->second);
+            _evictedDataSize -= data.getSize();
+            _evictedData.erase(it);
+            break;
+        }
+    }
+    return data;
+}
+
 void TextureCache::renameTextureWithKey(const std::string& srcName, const std::string& dstName)
 {
     std::string key = srcName;
@@ -700,8 +1095,8 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
             if (ret)
             {
                 tex->initWithImage(image);
-                _textures.emplace(fullpath, tex);
-                _textures.erase(it);
+                eraseTexture(it);
+                insertTexture(fullpath, tex);
             }
             CC_SAFE_DELETE(image);
         }
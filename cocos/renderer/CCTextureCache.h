@@ -35,15 +35,16 @@ THE SOFTWARE.
 #include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <list>
+#include <map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 #include "platform/CCImage.h"
-
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-    #include <list>
-#endif
+#include "base/CCData.h"
 
 NS_CC_BEGIN
 
@@ -63,6 +64,20 @@ NS_CC_BEGIN
 class CC_DLL TextureCache : public Ref
 {
 public:
+    /** Memory statistics of one cached texture, see getTextureMemoryInfo(). */
+    struct TextureMemoryInfo
+    {
+        std::string key;
+        backend::PixelFormat pixelFormat;
+        int pixelsWide;
+        int pixelsHigh;
+        /** Estimated GPU memory in bytes, mipmaps included. */
+        size_t bytes;
+        unsigned int referenceCount;
+        /** Director frame of the last lookup of this texture in the cache. */
+        unsigned int lastUsedFrame;
+    };
+
     // ETC1 ALPHA supports.
     static void setETC1AlphaFileSuffix(const std::string& suffix);
     static std::string getETC1AlphaFileSuffix();
@@ -197,11 +212,81 @@ public:
     */
     void renameTextureWithKey(const std::string& srcName, const std::string& dstName);
 
+    /** Sets the file size from which addImage() decodes PNG and JPEG files straight into the texture.
+    * Such files are decoded, converted and uploaded a band of rows at a time instead of being held
+    * in memory as a whole image, see Texture2D::initWithImageDataStreamed().
+    * Files that can't be streamed are loaded as usual.
+    *
+    * @param minFileSize Size of the file on disk in bytes, 0 disables streaming (the default).
+    */
+    void setStreamingDecodeThreshold(ssize_t minFileSize);
+    ssize_t getStreamingDecodeThreshold() const;
+
+    /** Enables transcoding of uncompressed images to ETC1 on devices that support it.
+    * The first addImage() of a file transcodes the decoded image in the background and stores it
+    * in a cache under the writable path, keyed by the file content. Later calls load the cached
+    * ETC1 data instead of decoding the source. See TextureTranscoder.
+    *
+    * @param enabled Whether to use and fill the transcoding cache, disabled by default.
+    */
+    void setTranscodingEnabled(bool enabled);
+    bool isTranscodingEnabled() const;
+
+    /** Enables mipmap streaming for images that come with mipmaps, such as PVR or KTX files.
+    * addImage() creates such textures with Texture2D::initWithImageStreamed(), so only their
+    * smallest levels are uploaded at first. See TextureStreamer.
+    *
+    * @param enabled Whether to stream mipmaps, disabled by default.
+    */
+    void setMipmapStreamingEnabled(bool enabled);
+    bool isMipmapStreamingEnabled() const;
+
+    /** Sets how much texture memory the cache may hold before it starts evicting textures.
+    * When an insertion goes over the budget, the least recently used textures that are retained
+    * only by the cache and weren't looked up in the current frame are released until the cache
+    * fits again. Only textures loaded from a file are evicted, the ones added with
+    * addImage(Image*, key) can't be loaded again. Textures in use are never evicted either,
+    * so the budget may be exceeded.
+    *
+    * @param bytes Budget in bytes as estimated by getTotalMemoryUsage(), 0 means unlimited (the default).
+    */
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+
+    /** Sets how many bytes of file content the cache keeps for evicted textures.
+    * When a texture loaded from a file is evicted, its encoded file is read again on a background
+    * thread and kept in memory, so that loading it again skips the file system. The oldest files
+    * are dropped first.
+    *
+    * @param bytes Size of the kept files in bytes, 0 disables keeping them (the default).
+    */
+    void setEvictedDataCacheSize(size_t bytes);
+    size_t getEvictedDataCacheSize() const;
+
+    /** Returns the memory statistics of every cached texture. */
+    std::vector<TextureMemoryInfo> getTextureMemoryInfo() const;
+
+    /** Returns the estimated memory of the cached textures in bytes, per pixel format. */
+    std::map<backend::PixelFormat, size_t> getMemoryUsageByPixelFormat() const;
+
+    /** Returns the estimated memory of all cached textures in bytes. */
+    size_t getTotalMemoryUsage() const;
+
 
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    void transcodeImageAsync(Image* image, const std::string& cachedPath);
+    static bool isTranscodableData(const Data& data);
+    void insertTexture(const std::string& key, Texture2D* texture);
+    std::unordered_map<std::string, Texture2D*>::const_iterator eraseTexture(std::unordered_map<std::string, Texture2D*>::const_iterator it);
+    void touchTexture(const std::string& key) const;
+    void enforceMemoryBudget();
+    void keepEvictedData(const std::string& key);
+    void storeEvictedData(const std::string& key, Data data);
+    Data takeEvictedData(const std::string& key);
+    static size_t getTextureMemorySize(Texture2D* texture);
 public:
 protected:
     struct AsyncStruct;
@@ -223,6 +308,27 @@ protected:
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    ssize_t _streamingDecodeThreshold;
+    bool _transcodingEnabled;
+    bool _mipmapStreamingEnabled;
+
+    struct TextureUsage
+    {
+        std::list<std::string>::iterator lruPosition;
+        unsigned int lastUsedFrame;
+        size_t bytes;
+    };
+
+    size_t _memoryBudget;
+    size_t _totalMemoryUsage;
+    // keys ordered from the most to the least recently used, eviction starts from the back
+    mutable std::list<std::string> _lruKeys;
+    mutable std::unordered_map<std::string, TextureUsage> _textureUsages;
+    std::unordered_set<std::string> _imageKeys;
+    size_t _evictedDataCacheSize;
+    size_t _evictedDataSize;
+    std::list<std::pair<std::string, Data>> _evictedData;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -0,0 +1,406 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCTextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <vector>
+
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "platform/CCImage.h"
+
+NS_CC_BEGIN
+
+namespace {
+    TextureStreamer* s_sharedTextureStreamer = nullptr;
+    unsigned int s_nextSerial = 0;
+}
+
+TextureStreamer* TextureStreamer::getInstance()
+{
+    if (s_sharedTextureStreamer == nullptr)
+    {
+        s_sharedTextureStreamer = new (std::nothrow) TextureStreamer();
+    }
+    return s_sharedTextureStreamer;
+}
+
+void TextureStreamer::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedTextureStreamer);
+}
+
+TextureStreamer::TextureStreamer()
+: _uploadBudget(2 * 1024 * 1024)
+, _memoryBudget(0)
+, _initialResidentSize(64)
+{
+    Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureStreamer::update), this, 0, false);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureStreamer::update), this);
+
+    for (auto& texture : _textures)
+    {
+        texture.first->_streamed = false;
+    }
+    _textures.clear();
+}
+
+void TextureStreamer::setUploadBudget(size_t bytes)
+{
+    _uploadBudget = bytes;
+}
+
+size_t TextureStreamer::getUploadBudget() const
+{
+    return _uploadBudget;
+}
+
+void TextureStreamer::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+}
+
+size_t TextureStreamer::getMemoryBudget() const
+{
+    return _memoryBudget;
+}
+
+void TextureStreamer::setInitialResidentSize(int pixels)
+{
+    _initialResidentSize = std::max(pixels, 1);
+}
+
+int TextureStreamer::getInitialResidentSize() const
+{
+    return _initialResidentSize;
+}
+
+size_t TextureStreamer::getResidentMemory() const
+{
+    size_t bytes = 0;
+    for (auto& texture : _textures)
+    {
+        bytes += getMipmapsSize(texture.second, texture.second.residentLevel);
+    }
+    return bytes;
+}
+
+void TextureStreamer::requestTexelDensity(Texture2D* texture, float texelsPerPixel)
+{
+    auto it = _textures.find(texture);
+    if (it == _textures.end())
+    {
+        return;
+    }
+
+    // every level halves the texels, so one pixel covers about one texel of level log2(density)
+    StreamedTexture& streamed = it->second;
+    int level = texelsPerPixel > 1.0f ? (int)std::floor(std::log2(texelsPerPixel)) : 0;
+    level = std::min(level, (int)streamed.mipmapSizes.size() - 1);
+
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    if (streamed.lastRequestFrame != currentFrame)
+    {
+        streamed.lastRequestFrame = currentFrame;
+        streamed.requestedLevel = level;
+    }
+    else
+    {
+        streamed.requestedLevel = std::min(streamed.requestedLevel, level);
+    }
+}
+
+int TextureStreamer::getResidentMipLevel(Texture2D* texture) const
+{
+    auto it = _textures.find(texture);
+    return it != _textures.end() ? it->second.residentLevel : 0;
+}
+
+void TextureStreamer::update(float /*dt*/)
+{
+    if (_textures.empty())
+    {
+        return;
+    }
+
+    // requests were made while drawing the previous frame
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    auto isDrawn = [currentFrame](const StreamedTexture& streamed) {
+        return streamed.lastRequestFrame + 1 >= currentFrame;
+    };
+
+    if (_memoryBudget > 0)
+    {
+        size_t residentMemory = getResidentMemory();
+        if (residentMemory > _memoryBudget)
+        {
+            // textures that weren't drawn drop to their initial levels first, least recently drawn first,
+            // then drawn textures give up the levels they no longer need
+            std::vector<std::pair<Texture2D*, StreamedTexture*>> candidates;
+            for (auto& texture : _textures)
+            {
+                StreamedTexture& streamed = texture.second;
+                int level = isDrawn(streamed) ? streamed.requestedLevel : streamed.initialLevel;
+                if (level > streamed.residentLevel)
+                {
+                    candidates.emplace_back(texture.first, &streamed);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [&isDrawn](const std::pair<Texture2D*, StreamedTexture*>& a, const std::pair<Texture2D*, StreamedTexture*>& b) {
+                bool drawnA = isDrawn(*a.second);
+                bool drawnB = isDrawn(*b.second);
+                if (drawnA != drawnB)
+                    return drawnB;
+                return a.second->lastRequestFrame < b.second->lastRequestFrame;
+            });
+
+            for (auto& candidate : candidates)
+            {
+                if (residentMemory <= _memoryBudget)
+                {
+                    break;
+                }
+                // the smaller levels are swapped in from memory, so the memory is released once this returns
+                StreamedTexture& streamed = *candidate.second;
+                int level = isDrawn(streamed) ? streamed.requestedLevel : streamed.initialLevel;
+                size_t residentBytes = getMipmapsSize(streamed, streamed.residentLevel);
+                if (uploadKeptMipmaps(candidate.first, streamed, level))
+                {
+                    residentMemory -= residentBytes - getMipmapsSize(streamed, streamed.residentLevel);
+                }
+            }
+        }
+    }
+
+    // upload the textures missing the most levels first
+    std::vector<std::pair<Texture2D*, StreamedTexture*>> pending;
+    for (auto& texture : _textures)
+    {
+        StreamedTexture& streamed = texture.second;
+        if (isDrawn(streamed) && streamed.requestedLevel < streamed.residentLevel)
+        {
+            pending.emplace_back(texture.first, &streamed);
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [](const std::pair<Texture2D*, StreamedTexture*>& a, const std::pair<Texture2D*, StreamedTexture*>& b) {
+        return a.second->residentLevel - a.second->requestedLevel > b.second->residentLevel - b.second->requestedLevel;
+    });
+
+    size_t uploadedBytes = 0;
+    for (auto& texture : pending)
+    {
+        StreamedTexture& streamed = *texture.second;
+
+        // step towards the requested level as far as the budget allows, a whole mip chain is uploaded each time
+        int level = streamed.requestedLevel;
+        while (level < streamed.residentLevel - 1 && uploadedBytes + getMipmapsSize(streamed, level) > _uploadBudget)
+        {
+            ++level;
+        }
+
+        size_t bytes = getMipmapsSize(streamed, level);
+        if (uploadedBytes > 0 && uploadedBytes + bytes > _uploadBudget)
+        {
+            continue;
+        }
+
+        if (makeResident(texture.first, streamed, level))
+        {
+            uploadedBytes += bytes;
+        }
+    }
+}
+
+int TextureStreamer::getInitialMipLevel(int pixelsWide, int pixelsHigh, int mipmapsNum) const
+{
+    int level = 0;
+    while (level < mipmapsNum - 1 && std::max(pixelsWide >> level, pixelsHigh >> level) > _initialResidentSize)
+    {
+        ++level;
+    }
+    return level;
+}
+
+void TextureStreamer::addTexture(Texture2D* texture, Image* image, backend::PixelFormat renderFormat, int residentLevel)
+{
+    removeTexture(texture);
+
+    // the levels below the resident ones are kept to drop levels without the file, larger ones are read again
+    StreamedTexture streamed;
+    streamed.filePath = image->getFilePath();
+    MipmapInfo* mipmaps = image->getMipmaps();
+    for (int i = 0; i < image->getNumberOfMipmaps(); ++i)
+    {
+        streamed.mipmapSizes.push_back(mipmaps[i].len);
+    }
+    streamed.imageFormat = image->getPixelFormat();
+    streamed.renderFormat = renderFormat;
+    streamed.pixelsWide = image->getWidth();
+    streamed.pixelsHigh = image->getHeight();
+    streamed.premultipliedAlpha = image->hasPremultipliedAlpha();
+    keepMipmaps(streamed, mipmaps, residentLevel + 1);
+    streamed.initialLevel = residentLevel;
+    streamed.residentLevel = residentLevel;
+    streamed.requestedLevel = residentLevel;
+    streamed.loadingLevel = -1;
+    streamed.lastRequestFrame = 0;
+    streamed.serial = ++s_nextSerial;
+
+    texture->_streamed = true;
+    _textures.emplace(texture, streamed);
+}
+
+void TextureStreamer::removeTexture(Texture2D* texture)
+{
+    auto it = _textures.find(texture);
+    if (it != _textures.end())
+    {
+        texture->_streamed = false;
+        _textures.erase(it);
+    }
+}
+
+bool TextureStreamer::makeResident(Texture2D* texture, StreamedTexture& streamed, int level)
+{
+    if (level > streamed.residentLevel)
+    {
+        return uploadKeptMipmaps(texture, streamed, level);
+    }
+
+    // one read per texture at a time, the next update asks again if another level is wanted by then
+    if (streamed.loadingLevel >= 0)
+    {
+        return false;
+    }
+    streamed.loadingLevel = level;
+
+    std::string filePath = streamed.filePath;
+    unsigned int serial = streamed.serial;
+    Image* image = new (std::nothrow) Image();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [texture, serial, image](void*) {
+        // the streamer or the texture may be gone by now, the serial check covers the latter
+        if (s_sharedTextureStreamer)
+        {
+            s_sharedTextureStreamer->uploadMipmaps(texture, serial, image);
+        }
+        image->release();
+    }, nullptr, [image, filePath]() {
+        image->initWithImageFile(filePath);
+    });
+    return true;
+}
+
+void TextureStreamer::uploadMipmaps(Texture2D* texture, unsigned int serial, Image* image)
+{
+    auto it = _textures.find(texture);
+    if (it == _textures.end() || it->second.serial != serial)
+    {
+        return;
+    }
+
+    StreamedTexture& streamed = it->second;
+    int level = streamed.loadingLevel;
+    streamed.loadingLevel = -1;
+
+    // the smaller levels are kept with the sizes recorded when the texture was added
+    bool sameLevels = image->getNumberOfMipmaps() == (int)streamed.mipmapSizes.size();
+    for (int i = 0; sameLevels && i < image->getNumberOfMipmaps(); ++i)
+    {
+        sameLevels = (size_t)image->getMipmaps()[i].len == streamed.mipmapSizes[i];
+    }
+
+    if (!sameLevels
+        || !texture->updateResidentMipmaps(image->getMipmaps(), image->getNumberOfMipmaps(), level, image->getPixelFormat(), streamed.renderFormat,
+                                           image->getWidth(), image->getHeight(), image->hasPremultipliedAlpha()))
+    {
+        CCLOG("cocos2d: TextureStreamer: couldn't upload mipmap level %d of %s", level, streamed.filePath.c_str());
+        return;
+    }
+    streamed.residentLevel = level;
+    keepMipmaps(streamed, image->getMipmaps(), level + 1);
+}
+
+bool TextureStreamer::uploadKeptMipmaps(Texture2D* texture, StreamedTexture& streamed, int level)
+{
+    if (level <= streamed.residentLevel || level < streamed.keptLevel || level >= (int)streamed.mipmapSizes.size())
+    {
+        return false;
+    }
+
+    int mipmapsNum = (int)streamed.mipmapSizes.size();
+    std::vector<MipmapInfo> mipmaps(mipmapsNum);
+    unsigned char* address = streamed.keptMipmaps.data();
+    for (int i = streamed.keptLevel; i < mipmapsNum; ++i)
+    {
+        mipmaps[i].address = address;
+        mipmaps[i].len = (int)streamed.mipmapSizes[i];
+        address += streamed.mipmapSizes[i];
+    }
+
+    if (!texture->updateResidentMipmaps(mipmaps.data(), mipmapsNum, level, streamed.imageFormat, streamed.renderFormat,
+                                        streamed.pixelsWide, streamed.pixelsHigh, streamed.premultipliedAlpha))
+    {
+        CCLOG("cocos2d: TextureStreamer: couldn't upload mipmap level %d of %s", level, streamed.filePath.c_str());
+        return false;
+    }
+    streamed.residentLevel = level;
+    keepMipmaps(streamed, mipmaps.data(), level + 1);
+    return true;
+}
+
+void TextureStreamer::keepMipmaps(StreamedTexture& streamed, MipmapInfo* mipmaps, int level)
+{
+    // built aside, mipmaps may point into the current copy
+    int mipmapsNum = (int)streamed.mipmapSizes.size();
+    level = std::min(level, mipmapsNum);
+    std::vector<unsigned char> kept;
+    kept.reserve(getMipmapsSize(streamed, level));
+    for (int i = level; i < mipmapsNum; ++i)
+    {
+        kept.insert(kept.end(), mipmaps[i].address, mipmaps[i].address + streamed.mipmapSizes[i]);
+    }
+    streamed.keptMipmaps.swap(kept);
+    streamed.keptLevel = level;
+}
+
+size_t TextureStreamer::getMipmapsSize(const StreamedTexture& streamed, int level)
+{
+    size_t bytes = 0;
+    for (size_t i = level; i < streamed.mipmapSizes.size(); ++i)
+    {
+        bytes += streamed.mipmapSizes[i];
+    }
+    return bytes;
+}
+
+NS_CC_END
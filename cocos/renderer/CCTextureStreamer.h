@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+ 
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "base/CCRef.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+class Image;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * @brief Keeps only the mipmap levels of streamed textures that are needed on screen.
+ *
+ * A texture created with Texture2D::initWithImageStreamed() starts with its smallest mipmap levels.
+ * Only the levels below the resident ones are kept in memory, about a third of the resident size, so
+ * dropping levels is done right away. When larger levels are needed, the file is read again on the IO
+ * thread of AsyncTaskPool and the levels are uploaded once it is decoded. Sprite and Sprite3D report
+ * how many texels of a streamed texture fall on one screen pixel when they draw it, and once per frame
+ * the streamer uploads the levels that were asked for, within a per-frame upload budget.
+ * When the resident levels of all streamed textures go over the memory budget, textures that were
+ * not drawn in the last frame drop back to their initial levels.
+ *
+ * Texture coordinates are normalized, so a texture keeps reporting the size of its full resolution
+ * image whatever levels are resident.
+ */
+class CC_DLL TextureStreamer : public Ref
+{
+public:
+    /** Returns the shared instance of the streamer. */
+    static TextureStreamer* getInstance();
+
+    /** Purges the shared instance, streamed textures keep the levels they have. */
+    static void destroyInstance();
+
+    /**
+     * Sets how many bytes of mipmap data may be uploaded per frame.
+     * A texture that doesn't fit is uploaded alone in a frame of its own.
+     *
+     * @param bytes Upload budget in bytes, 2 MB by default.
+     */
+    void setUploadBudget(size_t bytes);
+    size_t getUploadBudget() const;
+
+    /**
+     * Sets how much memory the resident levels of all streamed textures may use.
+     *
+     * @param bytes Budget in bytes, 0 means unlimited (the default).
+     */
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+
+    /**
+     * Sets the largest side of the first level made resident when a texture is created.
+     *
+     * @param pixels Size in pixels, 64 by default.
+     */
+    void setInitialResidentSize(int pixels);
+    int getInitialResidentSize() const;
+
+    /** Returns the memory used by the resident levels of all streamed textures. */
+    size_t getResidentMemory() const;
+
+    /**
+     * Asks for the levels needed to draw a texture at a given density.
+     * Requests are collected during the frame and served by the next update.
+     *
+     * @param texture A streamed texture.
+     * @param texelsPerPixel How many texels of the full resolution image fall on one screen pixel.
+     */
+    void requestTexelDensity(Texture2D* texture, float texelsPerPixel);
+
+    /** Returns the first resident mipmap level of a texture, 0 is the full resolution image. */
+    int getResidentMipLevel(Texture2D* texture) const;
+
+    /** Uploads the levels requested in the last frame, called once per frame by the scheduler. */
+    void update(float dt);
+
+protected:
+    friend class Texture2D;
+
+    struct StreamedTexture
+    {
+        std::string filePath;
+        std::vector<size_t> mipmapSizes;
+        backend::PixelFormat imageFormat;
+        backend::PixelFormat renderFormat;
+        int pixelsWide;
+        int pixelsHigh;
+        bool premultipliedAlpha;
+        int keptLevel;                          // first level in keptMipmaps, the one below the resident level
+        std::vector<unsigned char> keptMipmaps; // levels from keptLevel to the smallest one, back to back
+        int initialLevel;
+        int residentLevel;
+        int requestedLevel;
+        int loadingLevel;           // level the file is being read for, -1 when no read is in flight
+        unsigned int lastRequestFrame;
+        unsigned int serial;        // tells a re-added texture from a read started for its previous image
+    };
+
+    TextureStreamer();
+    virtual ~TextureStreamer();
+
+    int getInitialMipLevel(int pixelsWide, int pixelsHigh, int mipmapsNum) const;
+    void addTexture(Texture2D* texture, Image* image, backend::PixelFormat renderFormat, int residentLevel);
+    void removeTexture(Texture2D* texture);
+    bool makeResident(Texture2D* texture, StreamedTexture& streamed, int level);
+    bool uploadKeptMipmaps(Texture2D* texture, StreamedTexture& streamed, int level);
+    void uploadMipmaps(Texture2D* texture, unsigned int serial, Image* image);
+    static void keepMipmaps(StreamedTexture& streamed, MipmapInfo* mipmaps, int level);
+    static size_t getMipmapsSize(const StreamedTexture& streamed, int level);
+
+    std::unordered_map<Texture2D*, StreamedTexture> _textures;
+    size_t _uploadBudget;
+    size_t _memoryBudget;
+    int _initialResidentSize;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
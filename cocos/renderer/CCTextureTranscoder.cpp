@@ -0,0 +1,208 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCTextureTranscoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "xxhash.h"
+
+#include "base/CCData.h"
+#include "base/etc1.h"
+#include "base/ccUTF8.h"
+#include "platform/CCImage.h"
+#include "platform/CCFileUtils.h"
+#include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureUtils.h"
+
+NS_CC_BEGIN
+
+namespace {
+    // bump when the encoding changes, so stale cache entries are not used anymore
+    const unsigned int TRANSCODER_VERSION = 1;
+
+    // transcodes of the same source may run concurrently, each of them writes its own temporary file
+    std::atomic<unsigned int> s_tmpFileCounter(0);
+
+    bool writePKM(const unsigned char* rgb, int width, int height, const std::string& path)
+    {
+        etc1_uint32 encodedSize = etc1_get_encoded_data_size(width, height);
+        Data data;
+        unsigned char* bytes = static_cast<unsigned char*>(malloc(ETC_PKM_HEADER_SIZE + encodedSize));
+        if (bytes == nullptr)
+        {
+            return false;
+        }
+        data.fastSet(bytes, ETC_PKM_HEADER_SIZE + encodedSize);
+
+        etc1_pkm_format_header(bytes, width, height);
+        if (etc1_encode_image(rgb, width, height, 3, width * 3, bytes + ETC_PKM_HEADER_SIZE) != 0)
+        {
+            return false;
+        }
+
+        // write to a temporary file first, so an interrupted write never leaves a truncated cache entry behind
+        std::string tmpPath = path + "." + std::to_string(++s_tmpFileCounter) + ".tmp";
+        auto fileUtils = FileUtils::getInstance();
+        if (fileUtils->writeDataToFile(data, tmpPath) && fileUtils->renameFile(tmpPath, path))
+        {
+            return true;
+        }
+        fileUtils->removeFile(tmpPath);
+        return false;
+    }
+}
+
+std::string TextureTranscoder::getCacheDirectory()
+{
+    return FileUtils::getInstance()->getWritablePath() + "texturecache/";
+}
+
+std::string TextureTranscoder::getCachedFilePath(const Data& sourceData)
+{
+    unsigned int hash = XXH32(sourceData.getBytes(), sourceData.getSize(), TRANSCODER_VERSION);
+    return getCacheDirectory() + StringUtils::format("%08x%08x.pkm", hash, static_cast<unsigned int>(sourceData.getSize()));
+}
+
+bool TextureTranscoder::canTranscode(Image* image)
+{
+    if (image == nullptr || image->isCompressed() || image->getNumberOfMipmaps() > 1)
+    {
+        return false;
+    }
+
+    switch (image->getPixelFormat())
+    {
+        case backend::PixelFormat::RGBA8888:
+        case backend::PixelFormat::RGB888:
+        case backend::PixelFormat::AI88:
+        case backend::PixelFormat::I8:
+            break;
+        default:
+            return false;
+    }
+
+    return image->getWidth() > 0 && image->getHeight() > 0
+        && image->getWidth() % 4 == 0 && image->getHeight() % 4 == 0;
+}
+
+bool TextureTranscoder::encodeETC1(Image* image, const std::string& outputPath)
+{
+    if (!canTranscode(image))
+    {
+        return false;
+    }
+
+    const int width = image->getWidth();
+    const int height = image->getHeight();
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    const backend::PixelFormat format = image->getPixelFormat();
+
+    if (format == backend::PixelFormat::RGB888)
+    {
+        return writePKM(image->getData(), width, height, outputPath);
+    }
+
+    // expand everything else to RGBA8888, then split it into a color and an alpha image
+    unsigned char* rgba = image->getData();
+    size_t rgbaLen = image->getDataLen();
+    if (format != backend::PixelFormat::RGBA8888)
+    {
+        backend::PixelFormatUtils::convertDataToFormat(image->getData(), image->getDataLen(), format, backend::PixelFormat::RGBA8888, &rgba, &rgbaLen);
+    }
+
+    std::vector<unsigned char> rgb(pixelCount * 3);
+    std::vector<unsigned char> alpha(pixelCount * 3);
+    bool hasAlpha = false;
+    const bool premultiplied = image->hasPremultipliedAlpha();
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        const unsigned char* p = rgba + i * 4;
+        unsigned char a = p[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            // the ETC1 shaders premultiply after sampling, so store straight colors
+            rgb[i * 3 + c] = (premultiplied && a > 0 && a < 255) ? static_cast<unsigned char>(std::min(255, (p[c] * 255 + a / 2) / a)) : p[c];
+            alpha[i * 3 + c] = a;
+        }
+        hasAlpha = hasAlpha || a != 255;
+    }
+
+    if (rgba != image->getData())
+    {
+        free(rgba);
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string alphaPath = outputPath + TextureCache::getETC1AlphaFileSuffix();
+    if (hasAlpha)
+    {
+        // the alpha file goes first, the color file marks the entry as complete
+        if (TextureCache::getETC1AlphaFileSuffix().empty() || !writePKM(alpha.data(), width, height, alphaPath))
+        {
+            return false;
+        }
+    }
+    else if (fileUtils->isFileExist(alphaPath))
+    {
+        fileUtils->removeFile(alphaPath);
+    }
+
+    return writePKM(rgb.data(), width, height, outputPath);
+}
+
+std::string TextureTranscoder::transcodeFile(const std::string& filename)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string fullpath = fileUtils->fullPathForFilename(filename);
+    Data data = fileUtils->getDataFromFile(fullpath);
+    if (data.isNull())
+    {
+        return "";
+    }
+
+    std::string cachedPath = getCachedFilePath(data);
+    if (fileUtils->isFileExist(cachedPath))
+    {
+        return cachedPath;
+    }
+
+    Image image;
+    if (!image.initWithImageData(data.getBytes(), data.getSize()) || !canTranscode(&image))
+    {
+        return "";
+    }
+
+    std::string cacheDirectory = getCacheDirectory();
+    if (!fileUtils->isDirectoryExist(cacheDirectory) && !fileUtils->createDirectory(cacheDirectory))
+    {
+        return "";
+    }
+
+    return encodeETC1(&image, cachedPath) ? cachedPath : "";
+}
+
+NS_CC_END
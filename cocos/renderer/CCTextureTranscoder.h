@@ -0,0 +1,92 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#pragma once
+
+#include <string>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Data;
+class Image;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * @brief Transcodes decoded images into ETC1 and keeps the results in an on-disk cache.
+ *
+ * Cached files are keyed by a hash of the source file content, so a changed source is transcoded again.
+ * ETC1 has no alpha channel, so transparent images are written as a color file plus an alpha file named
+ * with TextureCache::getETC1AlphaFileSuffix(), which TextureCache already combines into one texture.
+ *
+ * Transcoding runs on the CPU with the encoder in base/etc1.h and is meant to be done offline, or once
+ * on first run in the background, see TextureCache::setTranscodingEnabled().
+ */
+class CC_DLL TextureTranscoder
+{
+public:
+    /** Returns the directory cached files are written to, under the writable path. */
+    static std::string getCacheDirectory();
+
+    /**
+     * Returns the path of the cached ETC1 file for a source file, whether it exists or not.
+     *
+     * @param sourceData The content of the source image file.
+     */
+    static std::string getCachedFilePath(const Data& sourceData);
+
+    /**
+     * Whether an image can be transcoded: it must be uncompressed, without mipmaps,
+     * and both sides must be a multiple of the 4x4 block size.
+     */
+    static bool canTranscode(Image* image);
+
+    /**
+     * Encodes an image to an ETC1 PKM file, plus an alpha PKM file if the image has transparent pixels.
+     * The image is not modified, so this can run on a background thread.
+     *
+     * @param image The decoded image.
+     * @param outputPath The path of the color file.
+     * @return true if all files were written.
+     */
+    static bool encodeETC1(Image* image, const std::string& outputPath);
+
+    /**
+     * Decodes an image file and transcodes it into the cache unless it is cached already.
+     * Use this to fill the cache offline or from a loading screen.
+     *
+     * @param filename The path of the source image.
+     * @return The path of the cached file, or an empty string if the image could not be transcoded.
+     */
+    static std::string transcodeFile(const std::string& filename);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
@@ -588,40 +588,46 @@ namespace backend { namespace PixelFormatUtils {
     // converter function end
     //////////////////////////////////////////////////////////////////////////
     
+    static unsigned char* allocateOutData(unsigned char* outBuffer, size_t outDataLen)
+    {
+        // write into the caller's buffer when there is one, the caller keeps owning it
+        return outBuffer ? outBuffer : (unsigned char*)malloc(sizeof(unsigned char) * outDataLen);
+    }
+    
     
     
-    cocos2d::backend::PixelFormat convertI8ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertI8ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen*4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToRGBA8888(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB888:
                 *outDataLen = dataLen*3;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToRGB888(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB565:
                 *outDataLen = dataLen*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToRGB565(data, dataLen, *outData);
                 break;
             case PixelFormat::AI88:
                 *outDataLen = dataLen*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToAI88(data, dataLen, *outData);
                 break;
             case PixelFormat::RGBA4444:
                 *outDataLen = dataLen*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToRGBA4444(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB5A1:
                 *outDataLen = dataLen*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToRGB5A1(data, dataLen, *outData);
                 break;
             case PixelFormat::A8:
@@ -630,17 +636,17 @@ namespace backend { namespace PixelFormatUtils {
                 break;
             case PixelFormat::MTL_BGR5A1:
                 *outDataLen = dataLen * 2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToBGR5A1(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_ABGR4:
                 *outDataLen = dataLen * 2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToABGR4(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_B5G6R5:
                 *outDataLen = dataLen * 2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertI8ToBGR565(data, dataLen, *outData);
                 break;
             default:
@@ -658,58 +664,58 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertAI88ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertAI88ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToRGBA8888(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB888:
                 *outDataLen = dataLen/2*3;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToRGB888(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB565:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToRGB565(data, dataLen, *outData);
                 break;
             case PixelFormat::A8:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToA8(data, dataLen, *outData);
                 break;
             case PixelFormat::I8:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToI8(data, dataLen, *outData);
                 break;
             case PixelFormat::RGBA4444:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToRGBA4444(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB5A1:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToRGB5A1(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_ABGR4:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToABGR4(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_B5G6R5:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToBGR565(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_BGR5A1:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertAI88ToBGR5A1(data, dataLen, *outData);
                 break;
             default:
@@ -728,58 +734,58 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertRGB888ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertRGB888ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen/3*4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToRGBA8888(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB565:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToRGB565(data, dataLen, *outData);
                 break;
             case PixelFormat::A8:
                 *outDataLen = dataLen/3;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToA8(data, dataLen, *outData);
                 break;
             case PixelFormat::I8:
                 *outDataLen = dataLen/3;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToI8(data, dataLen, *outData);
                 break;
             case PixelFormat::AI88:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToAI88(data, dataLen, *outData);
                 break;
             case PixelFormat::RGBA4444:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToRGBA4444(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB5A1:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToRGB5A1(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_B5G6R5:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToB5G6R5(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_BGR5A1:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToBGR5A1(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_ABGR4:
                 *outDataLen = dataLen/3*2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB888ToABGR4(data, dataLen, *outData);
                 break;
             default:
@@ -796,59 +802,59 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertRGBA8888ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertRGBA8888ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         
         switch (format)
         {
             case PixelFormat::RGB888:
                 *outDataLen = dataLen/4*3;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToRGB888(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB565:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToRGB565(data, dataLen, *outData);
                 break;
             case PixelFormat::A8:
                 *outDataLen = dataLen/4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToA8(data, dataLen, *outData);
                 break;
             case PixelFormat::I8:
                 *outDataLen = dataLen/4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToI8(data, dataLen, *outData);
                 break;
             case PixelFormat::AI88:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToAI88(data, dataLen, *outData);
                 break;
             case PixelFormat::RGBA4444:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToRGBA4444(data, dataLen, *outData);
                 break;
             case PixelFormat::RGB5A1:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToRGB5A1(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_B5G6R5:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToBGR565(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_ABGR4:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToABGR4(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_BGR5A1:
                 *outDataLen = dataLen/2;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA8888ToBGR5A1(data, dataLen, *outData);
                 break;
             default:
@@ -866,18 +872,18 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertRGB5A1ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertRGB5A1ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen/2*4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB5A1ToRGBA8888(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_BGR5A1:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB5A1ToBGR5A1(data, dataLen, *outData);
                 break;
             default:
@@ -894,13 +900,13 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertRGB565ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertRGB565ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen/2*4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGB565ToRGBA8888(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_B5G6R5:
@@ -923,13 +929,13 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertA8ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertA8ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen*4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertA8ToRGBA8888(data, dataLen, *outData);
                 break;
             default:
@@ -946,13 +952,13 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    cocos2d::backend::PixelFormat convertRGBA4444ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertRGBA4444ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format)
         {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen/ 2 * 4;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertRGBA4444ToRGBA8888(data, dataLen, *outData);
                 break;
             case PixelFormat::MTL_ABGR4:
@@ -974,12 +980,12 @@ namespace backend { namespace PixelFormatUtils {
         return format;
     }
     
-    PixelFormat convertBGRA8888ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    PixelFormat convertBGRA8888ToFormat(const unsigned char* data, size_t dataLen, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         switch (format) {
             case PixelFormat::RGBA8888:
                 *outDataLen = dataLen;
-                *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+                *outData = allocateOutData(outBuffer, *outDataLen);
                 convertBGRA8888ToRGBA8888(data, dataLen, *outData);
                 break;
                 
@@ -1006,7 +1012,7 @@ namespace backend { namespace PixelFormatUtils {
      rgba(1) -> 12345678
      
      */
-    cocos2d::backend::PixelFormat convertDataToFormat(const unsigned char* data, size_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, size_t* outDataLen)
+    cocos2d::backend::PixelFormat convertDataToFormat(const unsigned char* data, size_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, size_t* outDataLen, unsigned char* outBuffer)
     {
         // don't need to convert
         if (format == originFormat || format == PixelFormat::AUTO)
@@ -1019,26 +1025,26 @@ namespace backend { namespace PixelFormatUtils {
         switch (originFormat)
         {
             case PixelFormat::I8:
-                return convertI8ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertI8ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             case PixelFormat::AI88:
-                return convertAI88ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertAI88ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             case PixelFormat::RGB888:
-                return convertRGB888ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertRGB888ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             case PixelFormat::RGBA8888:
-                return convertRGBA8888ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertRGBA8888ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             case PixelFormat::RGB5A1:
-                return convertRGB5A1ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertRGB5A1ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             case PixelFormat::RGB565:
-                return convertRGB565ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertRGB565ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
 #ifdef CC_USE_METAL
             case PixelFormat::RGBA4444:
-                return convertRGBA4444ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertRGBA4444ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             case PixelFormat::A8:
-                return convertA8ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertA8ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
                 
 #endif
             case PixelFormat::BGRA8888:
-                return convertBGRA8888ToFormat(data, dataLen, format, outData, outDataLen);
+                return convertBGRA8888ToFormat(data, dataLen, format, outData, outDataLen, outBuffer);
             default:
                 CCLOG("unsupported conversion from format %d to format %d", static_cast<int>(originFormat), static_cast<int>(format));
                 *outData = (unsigned char*)data;
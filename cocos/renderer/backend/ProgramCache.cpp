@@ -104,6 +104,7 @@ bool ProgramCache::init()
     addProgram(ProgramType::LABEL_NORMAL);
     addProgram(ProgramType::LABLE_OUTLINE);
     addProgram(ProgramType::LABLE_DISTANCEFIELD_GLOW);
+    addProgram(ProgramType::LABEL_DISTANCEFIELD_OUTLINE);
     addProgram(ProgramType::POSITION_COLOR_LENGTH_TEXTURE);
     addProgram(ProgramType::POSITION_COLOR_TEXTURE_AS_POINTSIZE);
     addProgram(ProgramType::POSITION_COLOR);
@@ -116,6 +117,7 @@ bool ProgramCache::init()
     addProgram(ProgramType::GRAY_SCALE);
     addProgram(ProgramType::LINE_COLOR_3D);
     addProgram(ProgramType::CAMERA_CLEAR);
+    addProgram(ProgramType::PARTICLE_STATELESS);
     addProgram(ProgramType::SKYBOX_3D);
     addProgram(ProgramType::SKINPOSITION_TEXTURE_3D);
     addProgram(ProgramType::SKINPOSITION_NORMAL_TEXTURE_3D);
@@ -153,6 +155,9 @@ void ProgramCache::addProgram(ProgramType type)
         case ProgramType::LABLE_DISTANCEFIELD_GLOW:
             program = backend::Device::getInstance()->newProgram(positionTextureColor_vert, labelDistanceFieldGlow_frag);
             break;
+        case ProgramType::LABEL_DISTANCEFIELD_OUTLINE:
+            program = backend::Device::getInstance()->newProgram(positionTextureColor_vert, labelDistanceFieldOutline_frag);
+            break;
         case ProgramType::POSITION_COLOR_LENGTH_TEXTURE:
             program = backend::Device::getInstance()->newProgram(positionColorLengthTexture_vert, positionColorLengthTexture_frag);
             break;
@@ -190,6 +195,9 @@ void ProgramCache::addProgram(ProgramType type)
         case ProgramType::CAMERA_CLEAR:
             program = backend::Device::getInstance()->newProgram(cameraClear_vert, cameraClear_frag);
             break;
+        case ProgramType::PARTICLE_STATELESS:
+            program = backend::Device::getInstance()->newProgram(particleStateless_vert, positionTextureColor_frag);
+            break;
         case ProgramType::SKYBOX_3D:
             program = backend::Device::getInstance()->newProgram(CC3D_skybox_vert, CC3D_skybox_frag);
             break;
@@ -48,6 +48,8 @@ struct TextureDescriptor
     uint32_t height = 0;
     uint32_t depth = 0;
     SamplerDescriptor samplerDescriptor;
+    /// false skips clearing the storage when it is allocated, for textures whose every texel is uploaded right after
+    bool zeroInitialized = true;
 };
 
 /**
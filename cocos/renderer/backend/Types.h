@@ -340,6 +340,7 @@ enum class ProgramType : size_t
     LABLE_OUTLINE,                          //positionTextureColor_vert,    labelOutline_frag
     LABLE_DISTANCEFIELD_GLOW,               //positionTextureColor_vert,    labelDistanceFieldGlow_frag
     LABEL_DISTANCE_NORMAL,                  //positionTextureColor_vert,    label_distanceNormal_frag
+    LABEL_DISTANCEFIELD_OUTLINE,            //positionTextureColor_vert,    labelDistanceFieldOutline_frag
    
     LAYER_RADIA_GRADIENT,                   //position_vert,                layer_radialGradient_frag
     
@@ -347,6 +348,7 @@ enum class ProgramType : size_t
     ETC1_GRAY,                              //positionTextureColor_vert,    etc1Gray_frag
     GRAY_SCALE,                             //positionTextureColor_vert,    grayScale_frag
     CAMERA_CLEAR,                           //cameraClear_vert,             cameraClear_frag
+    PARTICLE_STATELESS,                     //particleStateless_vert,       positionTextureColor_frag
     
     TERRAIN_3D,                             //CC3D_terrain_vert,                    CC3D_terrain_frag
     LINE_COLOR_3D,                          //lineColor3D_vert,                     lineColor3D_frag
@@ -116,7 +116,11 @@ void Texture2DGL::updateTextureDescriptor(const cocos2d::backend::TextureDescrip
 
     // Update data here because `updateData()` may not be invoked later.
     // For example, a texture used as depth buffer will not invoke updateData().
-    initWithZeros();
+    // Streamed textures upload every row right after, they only need the storage allocated.
+    if (descriptor.zeroInitialized)
+        initWithZeros();
+    else
+        updateData(nullptr, _width, _height, 0);
 }
 
 Texture2DGL::~Texture2DGL()
@@ -41,6 +41,7 @@ NS_CC_BEGIN
 #include "renderer/shaders/label_distanceNormal.frag"
 #include "renderer/shaders/label_outline.frag"
 #include "renderer/shaders/label_distanceFieldGlow.frag"
+#include "renderer/shaders/label_distanceFieldOutline.frag"
 #include "renderer/shaders/positionColorLengthTexture.vert"
 #include "renderer/shaders/positionColorLengthTexture.frag"
 #include "renderer/shaders/positionColorTextureAsPointsize.vert"
@@ -56,6 +57,7 @@ NS_CC_BEGIN
 #include "renderer/shaders/etc1_Gray.frag"
 #include "renderer/shaders/cameraClear.vert"
 #include "renderer/shaders/cameraClear.frag"
+#include "renderer/shaders/particleStateless.vert"
 
 
 #include "renderer/shaders/3D_color.frag"
@@ -48,6 +48,7 @@ extern CC_DLL const char * label_normal_frag;
 extern CC_DLL const char * label_distanceNormal_frag;
 extern CC_DLL const char * labelOutline_frag;
 extern CC_DLL const char * labelDistanceFieldGlow_frag;
+extern CC_DLL const char * labelDistanceFieldOutline_frag;
 extern CC_DLL const char * lineColor3D_frag;
 extern CC_DLL const char * lineColor3D_vert;
 extern CC_DLL const char * positionColorLengthTexture_vert;
@@ -65,6 +66,7 @@ extern CC_DLL const char * etc1_frag;
 extern CC_DLL const char * etc1Gray_frag;
 extern CC_DLL const char * cameraClear_vert;
 extern CC_DLL const char * cameraClear_frag;
+extern CC_DLL const char * particleStateless_vert;
 
 extern CC_DLL const char * CC3D_color_frag;
 extern CC_DLL const char * CC3D_colorNormal_frag;
@@ -0,0 +1,92 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+
+// Evaluates a ParticleSystemQuad particle in stateless mode from its emission record.
+// ParticleSystemQuad::evaluateStatelessVertex() is the CPU reference, keep both in sync.
+const char* particleStateless_vert = R"(
+attribute vec4 a_corner;        // corner sign x, y, texture coordinates
+attribute vec4 a_emission;      // emission time, life, start position
+attribute vec4 a_motion;        // gravity: position, velocity. radius: angle, angular speed, radius, radius speed
+attribute vec4 a_color;
+attribute vec4 a_deltaColor;
+attribute vec4 a_sizeRotation;  // size, size speed, rotation, rotation speed
+
+uniform mat4 u_MVPMatrix;
+uniform float u_time;
+uniform vec2 u_gravity;
+uniform vec4 u_startTransform;
+uniform vec2 u_offset;
+uniform vec4 u_flags;           // y coordinate flip, radius mode, premultiplied alpha
+
+#ifdef GL_ES
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+#else
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    float t = u_time - a_emission.x;
+    if (t < 0.0 || t >= a_emission.y)
+    {
+        // all four corners collapse to one point outside the clip volume
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        v_fragmentColor = vec4(0.0);
+        v_texCoord = vec2(0.0);
+        return;
+    }
+
+    vec2 pos;
+    if (u_flags.y > 0.5)
+    {
+        float angle = a_motion.x + a_motion.y * t;
+        float radius = a_motion.z + a_motion.w * t;
+        pos = -vec2(cos(angle), sin(angle) * u_flags.x) * radius;
+    }
+    else
+    {
+        pos = a_motion.xy + (a_motion.zw * t + 0.5 * u_gravity * t * t) * u_flags.x;
+    }
+
+    vec2 center = pos + u_offset
+                + vec2(u_startTransform.x * a_emission.z + u_startTransform.z * a_emission.w,
+                       u_startTransform.y * a_emission.z + u_startTransform.w * a_emission.w);
+    float halfSize = max(a_sizeRotation.x + a_sizeRotation.y * t, 0.0) * 0.5;
+    float r = -radians(a_sizeRotation.z + a_sizeRotation.w * t);
+    float hc = halfSize * cos(r);
+    float hs = halfSize * sin(r);
+    vec2 corner = vec2(center.x + a_corner.x * hc - a_corner.y * hs,
+                       center.y + a_corner.x * hs + a_corner.y * hc);
+    gl_Position = u_MVPMatrix * vec4(corner, 0.0, 1.0);
+
+    vec4 color = a_color + a_deltaColor * t;
+    if (u_flags.z > 0.5)
+        color.rgb *= color.a;
+    v_fragmentColor = clamp(color, 0.0, 1.0);
+    v_texCoord = a_corner.zw;
+}
+)";
@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "ui/UILoadingBar.h"
 #include "ui/UIScrollView.h"
 #include "ui/UIListView.h"
+#include "ui/UIVirtualListView.h"
 #include "ui/UISlider.h"
 #include "ui/UITextField.h"
 #include "ui/UITextBMFont.h"
@@ -53,6 +54,7 @@ THE SOFTWARE.
 #endif
 #include "ui/GUIExport.h"
 #include "ui/UIScale9Sprite.h"
+#include "ui/UIScale9SpriteBatchNode.h"
 #include "ui/UIEditBox/UIEditBox.h"
 #include "ui/UILayoutComponent.h"
 #include "ui/UITabControl.h"
@@ -74,6 +74,7 @@ _clippingParent(nullptr),
 _clippingRectDirty(true),
 _stencilStateManager(new StencilStateManager()),
 _doLayoutDirty(true),
+_layoutManager(nullptr),
 _isInterceptTouch(false),
 _loopFocus(false),
 _passFocusToChild(true),
@@ -85,6 +86,7 @@ _isFocusPassing(false)
 Layout::~Layout()
 {
     CC_SAFE_RELEASE(_clippingStencil);
+    CC_SAFE_RELEASE(_layoutManager);
     CC_SAFE_DELETE(_stencilStateManager);
 }
     
@@ -890,6 +892,10 @@ const Size& Layout::getBackGroundImageTextureSize() const
 
 void Layout::setLayoutType(Type type)
 {
+    if (_layoutType != type)
+    {
+        CC_SAFE_RELEASE_NULL(_layoutManager);
+    }
     _layoutType = type;
    
     for (auto& child : _children)
@@ -962,11 +968,15 @@ void Layout::doLayout()
     
     sortAllChildren();
 
-    LayoutManager* executant = this->createLayoutManager();
+    if (!_layoutManager)
+    {
+        _layoutManager = this->createLayoutManager();
+        CC_SAFE_RETAIN(_layoutManager);
+    }
     
-    if (executant)
+    if (_layoutManager)
     {
-        executant->doLayout(this);
+        _layoutManager->doLayout(this);
     }
     
     _doLayoutDirty = false;
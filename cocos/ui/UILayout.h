@@ -640,6 +640,8 @@ protected:
     CallbackCommand _afterVisitCmdScissor;
     
     bool _doLayoutDirty;
+    // created on the first layout pass and kept until the layout type changes
+    LayoutManager* _layoutManager;
     bool _isInterceptTouch;
     
     //whether enable loop focus or not
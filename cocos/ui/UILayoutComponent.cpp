@@ -27,10 +27,20 @@
 #include "2d/CCNode.h"
 #include "ui/GUIDefine.h"
 #include "ui/UIHelper.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 
 NS_CC_BEGIN
 
 namespace ui {
+    // components whose layout was requested, refreshed once before the next frame
+    static std::vector<LayoutComponent*> s_requestedLayouts;
+    static const std::string FLUSH_REQUESTED_LAYOUTS_KEY = "LayoutComponent::flushRequestedLayouts";
+    // releases the requested components when the Director is reset
+    static EventListenerCustom* s_resetListener = nullptr;
+
     LayoutComponent::LayoutComponent()
         :_horizontalEdge(HorizontalEdge::None)
         , _verticalEdge(VerticalEdge::None)
@@ -50,6 +60,10 @@ namespace ui {
         , _usingPercentHeight(false)
         , _actived(true)
         , _isPercentOnly(false)
+        , _layoutDirty(true)
+        , _childLayoutDirty(false)
+        , _layoutRequested(false)
+        , _arranging(false)
     {
         _name = __LAYOUT_COMPONENT_NAME;
     }
@@ -130,6 +144,7 @@ namespace ui {
     //OldVersion
     void LayoutComponent::setUsingPercentContentSize(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPercentWidth = _usingPercentHeight = isUsed;
     }
     bool LayoutComponent::getUsingPercentContentSize()const
@@ -139,6 +154,7 @@ namespace ui {
 
     void LayoutComponent::setPercentContentSize(const Vec2 &percent)
     {
+        _layoutDirty = true;
         this->setPercentWidth(percent.x);
         this->setPercentHeight(percent.y);
     }
@@ -155,6 +171,7 @@ namespace ui {
     }
     void LayoutComponent::setAnchorPosition(const Point& point)
     {
+        _layoutDirty = true;
         Rect oldRect = _owner->getBoundingBox();
         _owner->setAnchorPoint(point);
         Rect newRect = _owner->getBoundingBox();
@@ -174,6 +191,7 @@ namespace ui {
     }
     void LayoutComponent::setPosition(const Point& position)
     {
+        _layoutDirty = true;
         Node* parent = this->getOwnerParent();
         if (parent != nullptr)
         {
@@ -213,6 +231,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentXEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPositionPercentX = isUsed;
         if (_usingPositionPercentX)
         {
@@ -226,6 +245,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentX(float percentMargin)
     {
+        _layoutDirty = true;
         _positionPercentX = percentMargin;
 
         if (_usingPositionPercentX || _horizontalEdge == HorizontalEdge::Center)
@@ -245,6 +265,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentYEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPositionPercentY = isUsed;
         if (_usingPositionPercentY)
         {
@@ -258,6 +279,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentY(float percentMargin)
     {
+        _layoutDirty = true;
         _positionPercentY = percentMargin;
 
         if (_usingPositionPercentY || _verticalEdge == VerticalEdge::Center)
@@ -277,6 +299,7 @@ namespace ui {
     }
     void LayoutComponent::setHorizontalEdge(HorizontalEdge hEage)
     {
+        _layoutDirty = true;
         _horizontalEdge = hEage;
         if (_horizontalEdge != HorizontalEdge::None)
         {
@@ -290,6 +313,7 @@ namespace ui {
     }
     void LayoutComponent::setVerticalEdge(VerticalEdge vEage)
     {
+        _layoutDirty = true;
         _verticalEdge = vEage;
         if (_verticalEdge != VerticalEdge::None)
         {
@@ -303,6 +327,7 @@ namespace ui {
     }
     void LayoutComponent::setLeftMargin(float margin)
     {
+        _layoutDirty = true;
         _leftMargin = margin;
     }
 
@@ -312,6 +337,7 @@ namespace ui {
     }
     void LayoutComponent::setRightMargin(float margin)
     {
+        _layoutDirty = true;
         _rightMargin = margin;
     }
 
@@ -321,6 +347,7 @@ namespace ui {
     }
     void LayoutComponent::setTopMargin(float margin)
     {
+        _layoutDirty = true;
         _topMargin = margin;
     }
 
@@ -330,6 +357,7 @@ namespace ui {
     }
     void LayoutComponent::setBottomMargin(float margin)
     {
+        _layoutDirty = true;
         _bottomMargin = margin;
     }
 
@@ -340,6 +368,7 @@ namespace ui {
     }
     void LayoutComponent::setSize(const Size& size)
     {
+        _layoutDirty = true;
         Node* parent = this->getOwnerParent();
         if (parent != nullptr)
         {
@@ -379,6 +408,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentWidthEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPercentWidth = isUsed;
         if (_usingPercentWidth)
         {
@@ -392,6 +422,7 @@ namespace ui {
     }
     void LayoutComponent::setSizeWidth(float width)
     {
+        _layoutDirty = true;
         Size ownerSize = _owner->getContentSize();
         ownerSize.width = width;
 
@@ -420,6 +451,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentWidth(float percentWidth)
     {
+        _layoutDirty = true;
         _percentWidth = percentWidth;
 
         if (_usingPercentWidth)
@@ -442,6 +474,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentHeightEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPercentHeight = isUsed;
         if (_usingPercentHeight)
         {
@@ -455,6 +488,7 @@ namespace ui {
     }
     void LayoutComponent::setSizeHeight(float height)
     {
+        _layoutDirty = true;
         Size ownerSize = _owner->getContentSize();
         ownerSize.height = height;
 
@@ -483,6 +517,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentHeight(float percentHeight)
     {
+        _layoutDirty = true;
         _percentHeight = percentHeight;
 
         if (_usingPercentHeight)
@@ -505,6 +540,7 @@ namespace ui {
     }
     void LayoutComponent::setStretchWidthEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingStretchWidth = isUsed;
         if (_usingStretchWidth)
         {
@@ -518,6 +554,7 @@ namespace ui {
     }
     void LayoutComponent::setStretchHeightEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingStretchHeight = isUsed;
         if (_usingStretchHeight)
         {
@@ -528,15 +565,51 @@ namespace ui {
     void LayoutComponent::refreshLayout()
     {
         if (!_actived)
+        {
+            clearChildLayoutDirty();
             return;
+        }
         
         Node* parent = this->getOwnerParent();
         if (parent == nullptr)
             return;
 
-        const Size& parentSize = parent->getContentSize();
+        this->arrangeOwner();
+        _childLayoutDirty = false;
+
+        if (typeid(*_owner) == typeid(PageView))
+        {
+            PageView* page = static_cast<PageView*>(_owner);
+            page->forceDoLayout();
+
+            Vector<Widget*> _widgetVector = page->getItems();
+            for(auto& item : _widgetVector)
+            {
+                ui::Helper::doLayout(item);
+            }
+        }
+        else
+        {
+            ui::Helper::doLayout(_owner);
+        }
+    }
+
+    bool LayoutComponent::arrangeOwner()
+    {
+        Node* parent = this->getOwnerParent();
+        const Size parentSize = parent->getContentSize();
         const Point& ownerAnchor = _owner->getAnchorPoint();
-        Size ownerSize = _owner->getContentSize();
+        if (!_layoutDirty
+            && parentSize.equals(_arrangedParentSize)
+            && _owner->getContentSize().equals(_arrangedSize)
+            && _owner->getPosition() == _arrangedPosition
+            && ownerAnchor == _arrangedAnchorPoint)
+        {
+            return false;
+        }
+
+        Size previousSize = _owner->getContentSize();
+        Size ownerSize = previousSize;
         Point ownerPosition = _owner->getPosition();
 
         switch (this->_horizontalEdge)
@@ -641,33 +714,176 @@ namespace ui {
             break;
         }
 
+        // the owner reporting its new size must not request another layout
+        _arranging = true;
         _owner->setPosition(ownerPosition);
         _owner->setContentSize(ownerSize);
+        _arranging = false;
+
+        _layoutDirty = false;
+        _arrangedParentSize = parentSize;
+        _arrangedSize = _owner->getContentSize();
+        _arrangedPosition = _owner->getPosition();
+        _arrangedAnchorPoint = _owner->getAnchorPoint();
+        return !previousSize.equals(_arrangedSize);
+    }
+
+    void LayoutComponent::layoutIfNeeded()
+    {
+        if (!_actived)
+        {
+            clearChildLayoutDirty();
+            return;
+        }
+
+        bool sizeChanged = false;
+        if (this->getOwnerParent() != nullptr)
+        {
+            sizeChanged = this->arrangeOwner();
+        }
+        if (!sizeChanged && !_childLayoutDirty)
+        {
+            return;
+        }
+        _childLayoutDirty = false;
+
+        // children are refreshed when their parent size changed or when they are on a requested path
+        auto layoutChildren = [sizeChanged](Node* node) {
+            for (auto& child : node->getChildren())
+            {
+                auto component = static_cast<LayoutComponent*>(child->getComponent(__LAYOUT_COMPONENT_NAME));
+                if (component && (sizeChanged || component->_layoutDirty || component->_childLayoutDirty))
+                {
+                    component->layoutIfNeeded();
+                }
+            }
+        };
 
         if (typeid(*_owner) == typeid(PageView))
         {
             PageView* page = static_cast<PageView*>(_owner);
-            page->forceDoLayout();
-
-            Vector<Widget*> _widgetVector = page->getItems();
-            for(auto& item : _widgetVector)
+            if (sizeChanged)
             {
-                ui::Helper::doLayout(item);
+                page->forceDoLayout();
+            }
+            for (auto& item : page->getItems())
+            {
+                layoutChildren(item);
             }
         }
         else
         {
-            ui::Helper::doLayout(_owner);
+            layoutChildren(_owner);
+        }
+    }
+
+    void LayoutComponent::clearChildLayoutDirty()
+    {
+        // an inactive component doesn't refresh its descendants, their requested paths are dropped
+        // too or requestLayout() would stop at them forever
+        _childLayoutDirty = false;
+        for (auto& child : _owner->getChildren())
+        {
+            auto component = static_cast<LayoutComponent*>(child->getComponent(__LAYOUT_COMPONENT_NAME));
+            if (component)
+            {
+                component->clearChildLayoutDirty();
+            }
+        }
+    }
+
+    void LayoutComponent::requestLayout()
+    {
+        if (_arranging || _owner == nullptr)
+            return;
+
+        _layoutDirty = true;
+
+        // mark the path down from the topmost laid out ancestor, stop at a path already requested
+        LayoutComponent* root = this;
+        for (Node* node = _owner->getParent(); node != nullptr; node = node->getParent())
+        {
+            auto component = static_cast<LayoutComponent*>(node->getComponent(__LAYOUT_COMPONENT_NAME));
+            if (component == nullptr)
+                break;
+            if (component->_childLayoutDirty)
+                return;
+            component->_childLayoutDirty = true;
+            root = component;
         }
+
+        if (root->_layoutRequested)
+            return;
+        root->_layoutRequested = true;
+        root->retain();
+        s_requestedLayouts.push_back(root);
+
+        auto scheduler = Director::getInstance()->getScheduler();
+        if (!scheduler->isScheduled(FLUSH_REQUESTED_LAYOUTS_KEY, &s_requestedLayouts))
+        {
+            scheduler->schedule([](float) {
+                LayoutComponent::flushRequestedLayouts();
+            }, &s_requestedLayouts, 0.0f, 0, 0.0f, false, FLUSH_REQUESTED_LAYOUTS_KEY);
+        }
+
+        if (s_resetListener == nullptr)
+        {
+            s_resetListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_RESET, [](EventCustom*) {
+                for (auto& component : s_requestedLayouts)
+                {
+                    component->_layoutRequested = false;
+                    if (component->_owner)
+                    {
+                        component->clearChildLayoutDirty();
+                    }
+                    component->release();
+                }
+                s_requestedLayouts.clear();
+
+                Director::getInstance()->getScheduler()->unschedule(FLUSH_REQUESTED_LAYOUTS_KEY, &s_requestedLayouts);
+                Director::getInstance()->getEventDispatcher()->removeEventListener(s_resetListener);
+                s_resetListener = nullptr;
+            });
+        }
+    }
+
+    void LayoutComponent::flushRequestedLayouts()
+    {
+        if (s_requestedLayouts.empty())
+            return;
+
+        CC_PROFILER_START("LayoutComponent - flushRequestedLayouts");
+
+        // layouts requested while flushing are refreshed in the same pass
+        for (size_t i = 0; i < s_requestedLayouts.size(); ++i)
+        {
+            auto component = s_requestedLayouts[i];
+            component->_layoutRequested = false;
+            if (component->_owner)
+            {
+                component->layoutIfNeeded();
+            }
+        }
+
+        auto requestedLayouts = std::move(s_requestedLayouts);
+        s_requestedLayouts.clear();
+        for (auto& component : requestedLayouts)
+        {
+            component->release();
+        }
+
+        CC_PROFILER_STOP("LayoutComponent - flushRequestedLayouts");
     }
 
     void LayoutComponent::setActiveEnabled(bool enable)
     {
+        _layoutDirty = true;
         _actived = enable;
     }
 
     void LayoutComponent::setPercentOnlyEnabled(bool enable)
     {
+        _layoutDirty = true;
         _isPercentOnly = enable;
     }
 }
@@ -388,13 +388,30 @@ namespace ui {
 
         /**
          * Refresh layout of the owner.
+         * The owner keeps its position and size when neither its parent size nor its layout settings changed
+         * since the last refresh.
          */
         void refreshLayout();
 
+        /**
+         * Request a refresh of the layout of the owner before the next frame is drawn.
+         * Only the owner, the children whose parent size changes and the descendants that requested a layout
+         * themselves are refreshed, however many requests are made in a frame.
+         */
+        void requestLayout();
+
+        /**
+         * Refresh all the layouts requested with `requestLayout` right away.
+         */
+        static void flushRequestedLayouts();
+
     protected:
         Node* getOwnerParent();
         void refreshHorizontalMargin();
         void refreshVerticalMargin();
+        bool arrangeOwner();
+        void layoutIfNeeded();
+        void clearChildLayoutDirty();
     protected:
         HorizontalEdge  _horizontalEdge;
         VerticalEdge    _verticalEdge;
@@ -420,6 +437,16 @@ namespace ui {
 
         bool            _actived;
         bool            _isPercentOnly;
+
+        // inputs and result of the last refresh, an unchanged owner is not arranged again
+        bool            _layoutDirty;
+        bool            _childLayoutDirty;
+        bool            _layoutRequested;
+        bool            _arranging;
+        Size            _arrangedParentSize;
+        Size            _arrangedSize;
+        Vec2            _arrangedPosition;
+        Vec2            _arrangedAnchorPoint;
     };
 }
 
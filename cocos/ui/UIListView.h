@@ -41,7 +41,7 @@ namespace ui{
 /**
  *@brief ListView is a view group that displays a list of scrollable items.
  *The list items are inserted to the list by using `addChild` or  `insertDefaultItem`.
- * @warning The list item in ListView doesn't support cell reuse at the moment, if you have a large amount of data need to be displayed, use  `TableView` instead.
+ * @warning The list item in ListView doesn't support cell reuse, if you have a large amount of data need to be displayed, use  `VirtualListView` instead.
  * ListView is a subclass of  `ScrollView`, so it shares many features of ScrollView.
  */
 class CC_GUI_DLL ListView : public ScrollView
@@ -29,12 +29,15 @@
 #include <vector>
 #include <locale>
 #include <algorithm>
+#include <list>
+#include <memory>
 
 #include "platform/CCFileUtils.h"
 #include "platform/CCApplication.h"
 #include "base/CCEventListenerTouch.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCDirector.h"
+#include "base/CCAsyncTaskPool.h"
 #include "2d/CCLabel.h"
 #include "2d/CCSprite.h"
 #include "base/ccUTF8.h"
@@ -840,6 +843,158 @@ ValueMap MyXMLVisitor::tagAttrMapWithXMLElement(const char ** attrs)
     return tagAttrValueMap;
 }
 
+namespace {
+    // Renderer of a formatted layout: the element it was created from, the text it shows and where it sits
+    struct FormattedRun
+    {
+        int elementIndex;
+        std::string text;
+        Vec2 position;
+    };
+
+    struct FormattedLayout
+    {
+        std::vector<FormattedRun> runs;
+        Size contentSize;
+    };
+
+    // Least recently used formatted layouts, keyed by RichText::getLayoutCacheKey
+    class LayoutCache
+    {
+    public:
+        const FormattedLayout* find(const std::string& key)
+        {
+            auto it = _index.find(key);
+            if (it == _index.end())
+                return nullptr;
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return &it->second->second;
+        }
+
+        void add(const std::string& key, FormattedLayout&& layout)
+        {
+            if (_capacity == 0)
+                return;
+            auto it = _index.find(key);
+            if (it != _index.end())
+            {
+                _entries.erase(it->second);
+                _index.erase(it);
+            }
+            _entries.emplace_front(key, std::move(layout));
+            _index[key] = _entries.begin();
+            trim();
+        }
+
+        void setCapacity(size_t capacity)
+        {
+            _capacity = capacity;
+            trim();
+        }
+
+        size_t getCapacity() const { return _capacity; }
+
+        void clear()
+        {
+            _index.clear();
+            _entries.clear();
+        }
+
+    private:
+        void trim()
+        {
+            while (_entries.size() > _capacity)
+            {
+                _index.erase(_entries.back().first);
+                _entries.pop_back();
+            }
+        }
+
+        typedef std::list<std::pair<std::string, FormattedLayout>> Entries;
+        Entries _entries;
+        std::unordered_map<std::string, Entries::iterator> _index;
+        size_t _capacity = 64;
+    };
+
+    LayoutCache s_layoutCache;
+
+    // Records the SAX events of a parse so they can be replayed later on another thread
+    class RecordingSAXDelegator : public SAXDelegator
+    {
+    public:
+        virtual void startElement(void* /*ctx*/, const char *name, const char **atts) override
+        {
+            Event event;
+            event.type = EventType::START;
+            event.name = name;
+            for (const char** attr = atts; attr && attr[0] && attr[1]; attr += 2)
+            {
+                event.attributes.push_back(attr[0]);
+                event.attributes.push_back(attr[1]);
+            }
+            _events.push_back(std::move(event));
+        }
+
+        virtual void endElement(void* /*ctx*/, const char *name) override
+        {
+            Event event;
+            event.type = EventType::END;
+            event.name = name;
+            _events.push_back(std::move(event));
+        }
+
+        virtual void textHandler(void* /*ctx*/, const char *s, size_t len) override
+        {
+            Event event;
+            event.type = EventType::TEXT;
+            event.name.assign(s, len);
+            _events.push_back(std::move(event));
+        }
+
+        void replay(SAXDelegator* delegator) const
+        {
+            std::vector<const char*> atts;
+            for (const auto& event : _events)
+            {
+                switch (event.type)
+                {
+                    case EventType::START:
+                        atts.clear();
+                        for (const auto& attr : event.attributes)
+                            atts.push_back(attr.c_str());
+                        atts.push_back(nullptr);
+                        atts.push_back(nullptr);
+                        delegator->startElement(nullptr, event.name.c_str(), atts.data());
+                        break;
+                    case EventType::END:
+                        delegator->endElement(nullptr, event.name.c_str());
+                        break;
+                    case EventType::TEXT:
+                        delegator->textHandler(nullptr, event.name.data(), event.name.length());
+                        break;
+                }
+            }
+        }
+
+    private:
+        enum class EventType
+        {
+            START,
+            END,
+            TEXT
+        };
+
+        struct Event
+        {
+            EventType type;
+            std::string name;   // element name, or the characters of a text event
+            std::vector<std::string> attributes;
+        };
+
+        std::vector<Event> _events;
+    };
+}
+
 const std::string RichText::KEY_VERTICAL_SPACE("KEY_VERTICAL_SPACE");
 const std::string RichText::KEY_WRAP_MODE("KEY_WRAP_MODE");
 const std::string RichText::KEY_HORIZONTAL_ALIGNMENT("KEY_HORIZONTAL_ALIGNMENT");
@@ -883,6 +1038,7 @@ const std::string RichText::KEY_ANCHOR_TEXT_GLOW_COLOR("KEY_ANCHOR_TEXT_GLOW_COL
 RichText::RichText()
     : _formatTextDirty(true)
     , _leftSpaceWidth(0.0f)
+    , _formattingElementIndex(-1)
 {
     _defaults[KEY_VERTICAL_SPACE] = 0.0f;
     _defaults[KEY_WRAP_MODE] = static_cast<int>(WrapMode::WRAP_PER_WORD);
@@ -926,6 +1082,62 @@ RichText* RichText::createWithXML(const std::string& xml, const ValueMap& defaul
     return nullptr;
 }
 
+void RichText::createWithXMLAsync(const std::string& xml, const ValueMap& defaults, const CreateCallback& callback,
+                                  const OpenUrlHandler& handleOpenUrl)
+{
+    RichText* widget = new (std::nothrow) RichText();
+    if (!widget || !widget->initWithDefaults(defaults, handleOpenUrl))
+    {
+        CC_SAFE_DELETE(widget);
+        if (callback)
+            callback(nullptr);
+        return;
+    }
+
+    struct AsyncXMLData
+    {
+        std::string xml;
+        RecordingSAXDelegator recorder;
+        bool parsed = false;
+    };
+    auto data = std::make_shared<AsyncXMLData>();
+    data->xml = widget->getXMLWithDefaultFont(xml);
+
+    // Only the parsing runs on the worker: the elements, custom tag handlers and labels
+    // create Refs and use the font atlases, which must stay on the main thread.
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [widget, data, callback](void*) {
+        RichText* result = nullptr;
+        if (data->parsed)
+        {
+            MyXMLVisitor visitor(widget);
+            data->recorder.replay(&visitor);
+            widget->formatText();
+            widget->autorelease();
+            result = widget;
+        }
+        else
+        {
+            widget->release();
+        }
+        if (callback)
+            callback(result);
+    }, nullptr, [data]() {
+        SAXParser parser;
+        parser.setDelegator(&data->recorder);
+        data->parsed = parser.parseIntrusive(&data->xml.front(), data->xml.length());
+    });
+}
+
+void RichText::setLayoutCacheCapacity(size_t capacity)
+{
+    s_layoutCache.setCapacity(capacity);
+}
+
+void RichText::purgeLayoutCache()
+{
+    s_layoutCache.clear();
+}
+
 bool RichText::init()
 {
     if (Widget::init())
@@ -937,25 +1149,9 @@ bool RichText::init()
 
 bool RichText::initWithXML(const std::string& origxml, const ValueMap& defaults, const OpenUrlHandler& handleOpenUrl)
 {
-    static std::function<std::string(RichText*)> startTagFont = [](RichText* richText) {
-        std::string fontFace = richText->getFontFace();
-        std::stringstream ss;
-        ss << richText->getFontSize();
-        std::string fontSize = ss.str();
-        std::string fontColor = richText->getFontColor();
-        return "<font face=\"" + fontFace + "\" size=\"" + fontSize + "\" color=\"" + fontColor + "\">";
-    };
-    if (Widget::init())
+    if (initWithDefaults(defaults, handleOpenUrl))
     {
-        setDefaults(defaults);
-        setOpenUrlHandler(handleOpenUrl);
-
-        // solves to issues:
-        //  - creates defaults values
-        //  - makes sure that the xml well formed and starts with an element
-        std::string xml = startTagFont(this);
-        xml += origxml;
-        xml += "</font>";
+        std::string xml = getXMLWithDefaultFont(origxml);
 
         MyXMLVisitor visitor(this);
         SAXParser parser;
@@ -964,6 +1160,30 @@ bool RichText::initWithXML(const std::string& origxml, const ValueMap& defaults,
     }
     return false;
 }
+
+bool RichText::initWithDefaults(const ValueMap& defaults, const OpenUrlHandler& handleOpenUrl)
+{
+    if (Widget::init())
+    {
+        setDefaults(defaults);
+        setOpenUrlHandler(handleOpenUrl);
+        return true;
+    }
+    return false;
+}
+
+std::string RichText::getXMLWithDefaultFont(const std::string& xml)
+{
+    // solves to issues:
+    //  - creates defaults values
+    //  - makes sure that the xml well formed and starts with an element
+    std::stringstream ss;
+    ss << getFontSize();
+    std::string result = "<font face=\"" + getFontFace() + "\" size=\"" + ss.str() + "\" color=\"" + getFontColor() + "\">";
+    result += xml;
+    result += "</font>";
+    return result;
+}
     
 void RichText::initRenderer()
 {
@@ -1353,148 +1573,349 @@ void RichText::formatText()
 {
     if (_formatTextDirty)
     {
-        this->removeAllProtectedChildren();
+        this->recycleRenderers();
         _elementRenders.clear();
         _lineHeights.clear();
-        if (_ignoreSize)
+        _rendererElementIndices.clear();
+        std::string layoutKey = getLayoutCacheKey();
+        if (layoutKey.empty() || !applyCachedLayout(layoutKey))
         {
-            addNewLine();
-            for (ssize_t i=0, size = _richElements.size(); i<size; ++i)
+            if (_ignoreSize)
             {
-                RichElement* element = _richElements.at(i);
-                Node* elementRenderer = nullptr;
-                switch (element->_type)
+                addNewLine();
+                for (ssize_t i=0, size = _richElements.size(); i<size; ++i)
                 {
-                    case RichElement::Type::TEXT:
+                    RichElement* element = _richElements.at(i);
+                    _formattingElementIndex = static_cast<int>(i);
+                    Node* elementRenderer = nullptr;
+                    switch (element->_type)
                     {
-                        RichElementText* elmtText = static_cast<RichElementText*>(element);
-                        Label* label;
-                        if (FileUtils::getInstance()->isFileExist(elmtText->_fontName))
+                        case RichElement::Type::TEXT:
                         {
-                             label = Label::createWithTTF(elmtText->_text, elmtText->_fontName, elmtText->_fontSize);
+                            RichElementText* elmtText = static_cast<RichElementText*>(element);
+                            elementRenderer = createTextRenderer(elmtText->_text, elmtText->_fontName, elmtText->_fontSize,
+                                                                 FileUtils::getInstance()->isFileExist(elmtText->_fontName),
+                                                                 elmtText->_color, elmtText->_opacity, elmtText->_flags, elmtText->_url,
+                                                                 elmtText->_outlineColor, elmtText->_outlineSize,
+                                                                 elmtText->_shadowColor, elmtText->_shadowOffset, elmtText->_shadowBlurRadius,
+                                                                 elmtText->_glowColor);
+                            break;
                         }
-                        else
+                        case RichElement::Type::IMAGE:
                         {
-                            label = Label::createWithSystemFont(elmtText->_text, elmtText->_fontName, elmtText->_fontSize);
+                            RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
+                            if (elmtImage->_textureType == Widget::TextureResType::LOCAL)
+                                elementRenderer = Sprite::create(elmtImage->_filePath);
+                            else
+                                elementRenderer = Sprite::createWithSpriteFrameName(elmtImage->_filePath);
+
+                            if (elementRenderer && (elmtImage->_height != -1 || elmtImage->_width != -1))
+                            {
+                                auto currentSize = elementRenderer->getContentSize();
+                                if (elmtImage->_width != -1)
+                                    elementRenderer->setScaleX(elmtImage->_width / currentSize.width);
+                                if (elmtImage->_height != -1)
+                                    elementRenderer->setScaleY(elmtImage->_height / currentSize.height);
+                                elementRenderer->setContentSize(Size(currentSize.width * elementRenderer->getScaleX(),
+                                                                     currentSize.height * elementRenderer->getScaleY()));
+                                elementRenderer->addComponent(ListenerComponent::create(elementRenderer,
+                                                                                        elmtImage->_url,
+                                                                                        std::bind(&RichText::openUrl, this, std::placeholders::_1)));
+                                elementRenderer->setColor(element->_color);
+                            }
+                            break;
                         }
-                        if (elmtText->_flags & RichElementText::ITALICS_FLAG)
-                            label->enableItalics();
-                        if (elmtText->_flags & RichElementText::BOLD_FLAG)
-                            label->enableBold();
-                        if (elmtText->_flags & RichElementText::UNDERLINE_FLAG)
-                            label->enableUnderline();
-                        if (elmtText->_flags & RichElementText::STRIKETHROUGH_FLAG)
-                            label->enableStrikethrough();
-                        if (elmtText->_flags & RichElementText::URL_FLAG)
-                            label->addComponent(ListenerComponent::create(label, elmtText->_url,
-                                                                          std::bind(&RichText::openUrl, this, std::placeholders::_1)));
-                        if (elmtText->_flags & RichElementText::OUTLINE_FLAG) {
-                            label->enableOutline(Color4B(elmtText->_outlineColor), elmtText->_outlineSize);
-                        }
-                        if (elmtText->_flags & RichElementText::SHADOW_FLAG) {
-                            label->enableShadow(Color4B(elmtText->_shadowColor),
-                                                elmtText->_shadowOffset,
-                                                elmtText->_shadowBlurRadius);
-                        }
-                        if (elmtText->_flags & RichElementText::GLOW_FLAG) {
-                            label->enableGlow(Color4B(elmtText->_glowColor));
-                        }
-                        label->setTextColor(Color4B(elmtText->_color));
-                        elementRenderer = label;
-                        break;
-                    }
-                    case RichElement::Type::IMAGE:
-                    {
-                        RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
-                        if (elmtImage->_textureType == Widget::TextureResType::LOCAL)
-                            elementRenderer = Sprite::create(elmtImage->_filePath);
-                        else
-                            elementRenderer = Sprite::createWithSpriteFrameName(elmtImage->_filePath);
-                        
-                        if (elementRenderer && (elmtImage->_height != -1 || elmtImage->_width != -1))
+                        case RichElement::Type::CUSTOM:
                         {
-                            auto currentSize = elementRenderer->getContentSize();
-                            if (elmtImage->_width != -1)
-                                elementRenderer->setScaleX(elmtImage->_width / currentSize.width);
-                            if (elmtImage->_height != -1)
-                                elementRenderer->setScaleY(elmtImage->_height / currentSize.height);
-                            elementRenderer->setContentSize(Size(currentSize.width * elementRenderer->getScaleX(),
-                                                                 currentSize.height * elementRenderer->getScaleY()));
-                            elementRenderer->addComponent(ListenerComponent::create(elementRenderer,
-                                                                                    elmtImage->_url,
-                                                                                    std::bind(&RichText::openUrl, this, std::placeholders::_1)));
+                            RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
+                            elementRenderer = elmtCustom->_customNode;
                             elementRenderer->setColor(element->_color);
+                            break;
                         }
-                        break;
-                    }
-                    case RichElement::Type::CUSTOM:
-                    {
-                        RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
-                        elementRenderer = elmtCustom->_customNode;
-                        elementRenderer->setColor(element->_color);
-                        break;
+                        case RichElement::Type::NEWLINE:
+                        {
+                            addNewLine();
+                            break;
+                        }
+                        default:
+                            break;
                     }
-                    case RichElement::Type::NEWLINE:
+
+                    if (elementRenderer)
                     {
-                        addNewLine();
-                        break;
+                        elementRenderer->setOpacity(element->_opacity);
+                        pushToContainer(elementRenderer);
                     }
-                    default:
-                        break;
-                }
-
-                if (elementRenderer)
-                {
-                    elementRenderer->setOpacity(element->_opacity);
-                    pushToContainer(elementRenderer);
                 }
             }
-        }
-        else
-        {
-            addNewLine();
-            for (ssize_t i=0, size = _richElements.size(); i<size; ++i)
+            else
             {
-                RichElement* element = static_cast<RichElement*>(_richElements.at(i));
-                switch (element->_type)
+                addNewLine();
+                for (ssize_t i=0, size = _richElements.size(); i<size; ++i)
                 {
-                    case RichElement::Type::TEXT:
+                    RichElement* element = static_cast<RichElement*>(_richElements.at(i));
+                    _formattingElementIndex = static_cast<int>(i);
+                    switch (element->_type)
                     {
-                        RichElementText* elmtText = static_cast<RichElementText*>(element);
-                        handleTextRenderer(elmtText->_text, elmtText->_fontName, elmtText->_fontSize, elmtText->_color,
-                                           elmtText->_opacity, elmtText->_flags, elmtText->_url,
-                                           elmtText->_outlineColor, elmtText->_outlineSize,
-                                           elmtText->_shadowColor, elmtText->_shadowOffset, elmtText->_shadowBlurRadius,
-                                           elmtText->_glowColor);
-                        break;
-                    }
-                    case RichElement::Type::IMAGE:
-                    {
-                        RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
-                        handleImageRenderer(elmtImage->_filePath, elmtImage->_color, elmtImage->_opacity, elmtImage->_width, elmtImage->_height, elmtImage->_url);
-                        break;
-                    }
-                    case RichElement::Type::CUSTOM:
-                    {
-                        RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
-                        handleCustomRenderer(elmtCustom->_customNode);
-                        break;
-                    }
-                    case RichElement::Type::NEWLINE:
-                    {
-                        addNewLine();
-                        break;
+                        case RichElement::Type::TEXT:
+                        {
+                            RichElementText* elmtText = static_cast<RichElementText*>(element);
+                            handleTextRenderer(elmtText->_text, elmtText->_fontName, elmtText->_fontSize, elmtText->_color,
+                                               elmtText->_opacity, elmtText->_flags, elmtText->_url,
+                                               elmtText->_outlineColor, elmtText->_outlineSize,
+                                               elmtText->_shadowColor, elmtText->_shadowOffset, elmtText->_shadowBlurRadius,
+                                               elmtText->_glowColor);
+                            break;
+                        }
+                        case RichElement::Type::IMAGE:
+                        {
+                            RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
+                            handleImageRenderer(elmtImage->_filePath, elmtImage->_color, elmtImage->_opacity, elmtImage->_width, elmtImage->_height, elmtImage->_url);
+                            break;
+                        }
+                        case RichElement::Type::CUSTOM:
+                        {
+                            RichElementCustomNode* elmtCustom = static_cast<RichElementCustomNode*>(element);
+                            handleCustomRenderer(elmtCustom->_customNode);
+                            break;
+                        }
+                        case RichElement::Type::NEWLINE:
+                        {
+                            addNewLine();
+                            break;
+                        }
+                        default:
+                            break;
                     }
-                    default:
-                        break;
                 }
             }
+            _formattingElementIndex = -1;
+            formatRenderers();
+            if (!layoutKey.empty())
+                addCachedLayout(layoutKey);
         }
-        formatRenderers();
+        _rendererElementIndices.clear();
+
+        // pooled renderers that weren't reused are released, keep the keys of the ones shown
+        _textRendererPool.clear();
+        std::unordered_map<Node*, std::string> shownKeys;
+        for (auto& child : _protectedChildren)
+        {
+            auto it = _textRendererKeys.find(child);
+            if (it != _textRendererKeys.end())
+                shownKeys.emplace(it->first, std::move(it->second));
+        }
+        _textRendererKeys.swap(shownKeys);
         _formatTextDirty = false;
     }
 }
 
+void RichText::recycleRenderers()
+{
+    for (auto& child : _protectedChildren)
+    {
+        auto it = _textRendererKeys.find(child);
+        if (it != _textRendererKeys.end())
+        {
+            _textRendererPool[it->second].pushBack(static_cast<Label*>(child));
+            _textRendererKeys.erase(it);
+        }
+    }
+    this->removeAllProtectedChildren();
+}
+
+Label* RichText::createTextRenderer(const std::string& text, const std::string& fontName, float fontSize, bool fileExist,
+                                    const Color3B& color, uint8_t opacity, uint32_t flags, const std::string& url,
+                                    const Color3B& outlineColor, int outlineSize,
+                                    const Color3B& shadowColor, const Size& shadowOffset, int shadowBlurRadius,
+                                    const Color3B& glowColor)
+{
+    // labels with the same font and the same enabled effects only differ by their string and colors
+    std::stringstream ss;
+    ss << fontName << '|' << fontSize << '|' << fileExist << '|' << flags << '|' << outlineSize;
+    std::string key = ss.str();
+
+    Label* textRenderer = nullptr;
+    auto pooled = _textRendererPool.find(key);
+    if (pooled != _textRendererPool.end() && !pooled->second.empty())
+    {
+        textRenderer = pooled->second.back();
+        // keep it alive once it leaves the pool
+        textRenderer->retain();
+        textRenderer->autorelease();
+        pooled->second.popBack();
+        textRenderer->setString(text);
+        textRenderer->removeComponent(ListenerComponent::COMPONENT_NAME);
+    }
+    else
+    {
+        textRenderer = fileExist ? Label::createWithTTF(text, fontName, fontSize)
+            : Label::createWithSystemFont(text, fontName, fontSize);
+
+        if (flags & RichElementText::ITALICS_FLAG)
+            textRenderer->enableItalics();
+        if (flags & RichElementText::BOLD_FLAG)
+            textRenderer->enableBold();
+        if (flags & RichElementText::UNDERLINE_FLAG)
+            textRenderer->enableUnderline();
+        if (flags & RichElementText::STRIKETHROUGH_FLAG)
+            textRenderer->enableStrikethrough();
+    }
+    _textRendererKeys[textRenderer] = key;
+
+    if (flags & RichElementText::URL_FLAG)
+        textRenderer->addComponent(ListenerComponent::create(textRenderer,
+                                                             url,
+                                                             std::bind(&RichText::openUrl, this, std::placeholders::_1)));
+    if (flags & RichElementText::OUTLINE_FLAG)
+        textRenderer->enableOutline(Color4B(outlineColor), outlineSize);
+    if (flags & RichElementText::SHADOW_FLAG)
+        textRenderer->enableShadow(Color4B(shadowColor), shadowOffset, shadowBlurRadius);
+    if (flags & RichElementText::GLOW_FLAG)
+        textRenderer->enableGlow(Color4B(glowColor));
+
+    textRenderer->setTextColor(Color4B(color));
+    textRenderer->setOpacity(opacity);
+    return textRenderer;
+}
+
+Sprite* RichText::createImageRenderer(const std::string& filePath, int width, int height, const std::string& url)
+{
+    Sprite* imageRenderer = Sprite::create(filePath);
+    if (imageRenderer)
+    {
+        auto currentSize = imageRenderer->getContentSize();
+        if (width != -1)
+            imageRenderer->setScaleX(width / currentSize.width);
+        if (height != -1)
+            imageRenderer->setScaleY(height / currentSize.height);
+        imageRenderer->setContentSize(Size(currentSize.width * imageRenderer->getScaleX(),
+                                             currentSize.height * imageRenderer->getScaleY()));
+        imageRenderer->setScale(1.f, 1.f);
+        imageRenderer->addComponent(ListenerComponent::create(imageRenderer,
+                                                              url,
+                                                              std::bind(&RichText::openUrl, this, std::placeholders::_1)));
+    }
+    return imageRenderer;
+}
+
+std::string RichText::getLayoutCacheKey()
+{
+    if (s_layoutCache.getCapacity() == 0)
+        return "";
+
+    std::stringstream ss;
+    ss << _ignoreSize << '|' << (_ignoreSize ? 0.0f : _customSize.width)
+       << '|' << _defaults.at(KEY_WRAP_MODE).asInt()
+       << '|' << _defaults.at(KEY_HORIZONTAL_ALIGNMENT).asInt()
+       << '|' << _defaults.at(KEY_VERTICAL_SPACE).asFloat()
+       << '|' << _defaults.at(KEY_FONT_SIZE).asFloat();
+    for (const auto& element : _richElements)
+    {
+        switch (element->_type)
+        {
+            case RichElement::Type::TEXT:
+            {
+                auto elmtText = static_cast<const RichElementText*>(element);
+                // strings are length prefixed so their content can't be confused with the separators
+                ss << "|T" << elmtText->_text.length() << ':' << elmtText->_text
+                   << elmtText->_fontName.length() << ':' << elmtText->_fontName
+                   << elmtText->_url.length() << ':' << elmtText->_url
+                   << ',' << elmtText->_fontSize << ',' << elmtText->_flags
+                   << ',' << stringWithColor3B(elmtText->_color) << ',' << static_cast<int>(elmtText->_opacity)
+                   << ',' << stringWithColor3B(elmtText->_outlineColor) << ',' << elmtText->_outlineSize
+                   << ',' << stringWithColor3B(elmtText->_shadowColor) << ',' << elmtText->_shadowOffset.width
+                   << ',' << elmtText->_shadowOffset.height << ',' << elmtText->_shadowBlurRadius
+                   << ',' << stringWithColor3B(elmtText->_glowColor);
+                break;
+            }
+            case RichElement::Type::IMAGE:
+            {
+                // images laid out with the ignored size are created differently, don't bother caching them
+                if (_ignoreSize)
+                    return "";
+                auto elmtImage = static_cast<const RichElementImage*>(element);
+                ss << "|I" << elmtImage->_filePath.length() << ':' << elmtImage->_filePath
+                   << elmtImage->_url.length() << ':' << elmtImage->_url
+                   << ',' << elmtImage->_width << ',' << elmtImage->_height;
+                break;
+            }
+            case RichElement::Type::NEWLINE:
+                ss << "|N";
+                break;
+            default:
+                // custom nodes are owned by their elements and can't be recreated
+                return "";
+        }
+    }
+    return ss.str();
+}
+
+bool RichText::applyCachedLayout(const std::string& key)
+{
+    const FormattedLayout* layout = s_layoutCache.find(key);
+    if (!layout)
+        return false;
+
+    std::unordered_map<std::string, bool> fontFileExist;
+    for (const auto& run : layout->runs)
+    {
+        RichElement* element = _richElements.at(run.elementIndex);
+        Node* renderer = nullptr;
+        if (element->_type == RichElement::Type::TEXT)
+        {
+            RichElementText* elmtText = static_cast<RichElementText*>(element);
+            auto fileExist = fontFileExist.find(elmtText->_fontName);
+            if (fileExist == fontFileExist.end())
+                fileExist = fontFileExist.emplace(elmtText->_fontName, FileUtils::getInstance()->isFileExist(elmtText->_fontName)).first;
+            renderer = createTextRenderer(run.text, elmtText->_fontName, elmtText->_fontSize, fileExist->second,
+                                          elmtText->_color, elmtText->_opacity, elmtText->_flags, elmtText->_url,
+                                          elmtText->_outlineColor, elmtText->_outlineSize,
+                                          elmtText->_shadowColor, elmtText->_shadowOffset, elmtText->_shadowBlurRadius,
+                                          elmtText->_glowColor);
+        }
+        else if (element->_type == RichElement::Type::IMAGE)
+        {
+            RichElementImage* elmtImage = static_cast<RichElementImage*>(element);
+            renderer = createImageRenderer(elmtImage->_filePath, elmtImage->_width, elmtImage->_height, elmtImage->_url);
+        }
+
+        if (renderer)
+        {
+            renderer->setAnchorPoint(Vec2::ZERO);
+            renderer->setPosition(run.position);
+            this->addProtectedChild(renderer, 1);
+        }
+    }
+
+    if (!_ignoreSize)
+        _customSize.height = layout->contentSize.height;
+    this->setContentSize(layout->contentSize);
+    updateContentSizeWithTextureSize(_contentSize);
+    return true;
+}
+
+void RichText::addCachedLayout(const std::string& key)
+{
+    FormattedLayout layout;
+    layout.runs.reserve(_protectedChildren.size());
+    for (auto& child : _protectedChildren)
+    {
+        auto it = _rendererElementIndices.find(child);
+        if (it == _rendererElementIndices.end())
+            return;
+
+        FormattedRun run;
+        run.elementIndex = it->second;
+        if (auto label = dynamic_cast<Label*>(child))
+            run.text = label->getString();
+        run.position = child->getPosition();
+        layout.runs.push_back(std::move(run));
+    }
+    layout.contentSize = _contentSize;
+    s_layoutCache.add(key, std::move(layout));
+}
+
 namespace {
     inline bool isUTF8CharWrappable(const StringUtils::StringUTF8::CharUTF8& ch)
     {
@@ -1671,30 +2092,9 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
             }
             ++splitParts;
 
-            Label* textRenderer = fileExist ? Label::createWithTTF(currentText, fontName, fontSize)
-                : Label::createWithSystemFont(currentText, fontName, fontSize);
-
-            if (flags & RichElementText::ITALICS_FLAG)
-                textRenderer->enableItalics();
-            if (flags & RichElementText::BOLD_FLAG)
-                textRenderer->enableBold();
-            if (flags & RichElementText::UNDERLINE_FLAG)
-                textRenderer->enableUnderline();
-            if (flags & RichElementText::STRIKETHROUGH_FLAG)
-                textRenderer->enableStrikethrough();
-            if (flags & RichElementText::URL_FLAG)
-                textRenderer->addComponent(ListenerComponent::create(textRenderer,
-                                                                     url,
-                                                                     std::bind(&RichText::openUrl, this, std::placeholders::_1)));
-            if (flags & RichElementText::OUTLINE_FLAG)
-                textRenderer->enableOutline(Color4B(outlineColor), outlineSize);
-            if (flags & RichElementText::SHADOW_FLAG)
-                textRenderer->enableShadow(Color4B(shadowColor), shadowOffset, shadowBlurRadius);
-            if (flags & RichElementText::GLOW_FLAG)
-                textRenderer->enableGlow(Color4B(glowColor));
-
-            textRenderer->setTextColor(Color4B(color));
-            textRenderer->setOpacity(opacity);
+            Label* textRenderer = createTextRenderer(currentText, fontName, fontSize, fileExist, color, opacity, flags, url,
+                                                     outlineColor, outlineSize, shadowColor, shadowOffset, shadowBlurRadius,
+                                                     glowColor);
 
             // textRendererWidth will get 0.0f, when we've got glError: 0x0501 in Label::getContentSize
             // It happens when currentText is very very long so that can't generate a texture
@@ -1729,6 +2129,12 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
                 textRenderer->setString(utf8Text.getAsCharSequence(0, leftLength));
                 pushToContainer(textRenderer);
             }
+            else
+            {
+                // nothing fits on this line, let the next part reuse the label
+                _textRendererPool[_textRendererKeys[textRenderer]].pushBack(textRenderer);
+                _textRendererKeys.erase(textRenderer);
+            }
 
             StringUtils::StringUTF8::CharUTF8Store& str = utf8Text.getString();
 
@@ -1741,21 +2147,10 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
 
 void RichText::handleImageRenderer(const std::string& filePath, const Color3B &/*color*/, uint8_t /*opacity*/, int width, int height, const std::string& url)
 {
-    Sprite* imageRenderer = Sprite::create(filePath);
+    Sprite* imageRenderer = createImageRenderer(filePath, width, height, url);
     if (imageRenderer)
     {
-        auto currentSize = imageRenderer->getContentSize();
-        if (width != -1)
-            imageRenderer->setScaleX(width / currentSize.width);
-        if (height != -1)
-            imageRenderer->setScaleY(height / currentSize.height);
-        imageRenderer->setContentSize(Size(currentSize.width * imageRenderer->getScaleX(),
-                                             currentSize.height * imageRenderer->getScaleY()));
-        imageRenderer->setScale(1.f, 1.f);
         handleCustomRenderer(imageRenderer);
-        imageRenderer->addComponent(ListenerComponent::create(imageRenderer,
-                                                              url,
-                                                              std::bind(&RichText::openUrl, this, std::placeholders::_1)));
     }
 }
 
@@ -1941,6 +2336,7 @@ void RichText::pushToContainer(cocos2d::Node *renderer)
         return;
     }
     _elementRenders[_elementRenders.size()-1].pushBack(renderer);
+    _rendererElementIndices[renderer] = _formattingElementIndex;
 }
     
 void RichText::setVerticalSpace(float space)
@@ -37,6 +37,7 @@ NS_CC_BEGIN
  */
 
 class Label;
+class Sprite;
 
 namespace ui {
 
@@ -369,6 +370,12 @@ public:
      * @result text attributes and RichElement
      */
     typedef std::function<std::pair<ValueMap, RichElement*>(const ValueMap& tagAttrValueMap)> VisitEnterHandler;
+
+    /**
+     * @brief called on the main thread once a RichText created asynchronously is ready
+     * @param richText the formatted RichText, or nullptr if the XML couldn't be parsed
+     */
+    typedef std::function<void(RichText* richText)> CreateCallback;
     
     static const std::string KEY_VERTICAL_SPACE;                    /*!< key of vertical space */
     static const std::string KEY_WRAP_MODE;                         /*!< key of per word, or per char */
@@ -438,6 +445,32 @@ public:
      */
     static RichText* createWithXML(const std::string& xml, const ValueMap& defaults = ValueMap(), const OpenUrlHandler& handleOpenUrl = nullptr);
 
+    /**
+     * @brief Create a RichText from an XML without blocking the main thread.
+     * The XML is parsed on a worker thread. The elements are then created and formatted on the main thread,
+     * right before the callback receives the RichText ready to be added to the scene.
+     *
+     * @param xml The XML markup.
+     * @param defaults The default values, see `setDefaults`.
+     * @param callback Called on the main thread with the RichText, or nullptr if the XML couldn't be parsed.
+     * @param handleOpenUrl The callback for open URL.
+     */
+    static void createWithXMLAsync(const std::string& xml, const ValueMap& defaults, const CreateCallback& callback,
+                                   const OpenUrlHandler& handleOpenUrl = nullptr);
+
+    /**
+     * @brief Set how many formatted layouts are kept to be reused by RichTexts with the same content and width.
+     * Layouts with custom node elements, or with images when the content size is ignored, are not cached.
+     *
+     * @param capacity Number of layouts kept, 0 disables the cache.
+     */
+    static void setLayoutCacheCapacity(size_t capacity);
+
+    /**
+     * @brief Remove all the formatted layouts kept for reuse.
+     */
+    static void purgeLayoutCache();
+
     /**
      * @brief Insert a RichElement at a given index.
      *
@@ -556,6 +589,8 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithXML(const std::string& xml, const ValueMap& defaults = ValueMap(), const OpenUrlHandler& handleOpenUrl = nullptr);
 
 protected:
+    bool initWithDefaults(const ValueMap& defaults, const OpenUrlHandler& handleOpenUrl);
+    std::string getXMLWithDefaultFont(const std::string& xml);
     virtual void adaptRenderers() override;
 
     virtual void initRenderer() override;
@@ -571,6 +606,16 @@ protected:
     void addNewLine();
 	void doHorizontalAlignment(const Vector<Node*>& row, float rowWidth);
 	float stripTrailingWhitespace(const Vector<Node*>& row);
+    Label* createTextRenderer(const std::string& text, const std::string& fontName, float fontSize, bool fileExist,
+                              const Color3B& color, uint8_t opacity, uint32_t flags, const std::string& url,
+                              const Color3B& outlineColor, int outlineSize,
+                              const Color3B& shadowColor, const Size& shadowOffset, int shadowBlurRadius,
+                              const Color3B& glowColor);
+    Sprite* createImageRenderer(const std::string& filePath, int width, int height, const std::string& url);
+    void recycleRenderers();
+    std::string getLayoutCacheKey();
+    bool applyCachedLayout(const std::string& key);
+    void addCachedLayout(const std::string& key);
 
     bool _formatTextDirty;
     Vector<RichElement*> _richElements;
@@ -578,6 +623,13 @@ protected:
     std::vector<float> _lineHeights;
     float _leftSpaceWidth;
 
+    // text renderers kept across formats, keyed by font and effects so reusing one only changes its string
+    std::unordered_map<Node*, std::string> _textRendererKeys;
+    std::unordered_map<std::string, Vector<Label*>> _textRendererPool;
+    // element index of each renderer created by the format in progress
+    std::unordered_map<Node*, int> _rendererElementIndices;
+    int _formattingElementIndex;
+
     ValueMap _defaults;             /*!< default values */
     OpenUrlHandler _handleOpenUrl;  /*!< the callback for open URL */
 };
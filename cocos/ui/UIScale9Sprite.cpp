@@ -24,6 +24,7 @@
  ****************************************************************************/
 
 #include "ui/UIScale9Sprite.h"
+#include "ui/UIScale9SpriteBatchNode.h"
 #include "2d/CCSprite.h"
 #include "2d/CCSpriteFrameCache.h"
 #include "base/CCVector.h"
@@ -500,6 +501,40 @@ void Scale9Sprite::resetRender()
     // nothing. keeping it to be backwards compatible
 }
 
+void Scale9Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
+{
+    auto batchNode = Scale9SpriteBatchNode::getVisitingBatchNode();
+    if (batchNode == nullptr || _texture == nullptr || _texture->getBackendTexture() == nullptr)
+    {
+        Sprite::draw(renderer, transform, flags);
+        return;
+    }
+
+#if CC_USE_CULLING
+    // same culling as Sprite::draw
+    auto visitingCamera = Camera::getVisitingCamera();
+    auto defaultCamera = Camera::getDefaultCamera();
+    if (visitingCamera == nullptr)
+        _insideBounds = true;
+    else if (visitingCamera == defaultCamera)
+        _insideBounds = ((flags & FLAGS_TRANSFORM_DIRTY) || visitingCamera->isViewProjectionUpdated()) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
+    else
+        _insideBounds = renderer->checkVisibility(transform, _contentSize);
+
+    if (!_insideBounds)
+        return;
+#endif
+
+    if (!batchNode->addSprite(this, flags))
+    {
+        Sprite::draw(renderer, transform, flags);
+        return;
+    }
+
+    if (_texture->isStreamed())
+        requestTextureDensity(transform);
+}
+
 void Scale9Sprite::setupSlice9(Texture2D* texture, const Rect& capInsets)
 {
     if (texture && texture->isContain9PatchInfo()) {
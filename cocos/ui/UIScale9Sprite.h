@@ -546,6 +546,11 @@ namespace ui {
 
         void resetRender();
 
+        /**
+         * Draws the sprite, or adds it to the Scale9SpriteBatchNode being visited when it can be batched.
+         */
+        virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+
     protected:
         void updateCapInset();
         void setupSlice9(Texture2D* texture, const Rect& capInsets);
@@ -0,0 +1,351 @@
+/****************************************************************************
+Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "ui/UIScale9SpriteBatchNode.h"
+#include "ui/UIScale9Sprite.h"
+#include "ui/UILayout.h"
+#include "2d/CCClippingNode.h"
+#include "2d/CCClippingRectangleNode.h"
+#include "base/CCDirector.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "renderer/backend/ProgramState.h"
+#include <algorithm>
+#include <stddef.h> // offsetof
+#include <string.h>
+
+NS_CC_BEGIN
+
+namespace ui {
+
+namespace {
+    // 32 bit indices aren't supported by every GLES2 device, a command draws at most this many vertices
+    const size_t MAX_VERTICES_PER_COMMAND = 65536;
+}
+
+Scale9SpriteBatchNode* Scale9SpriteBatchNode::s_visitingBatchNode = nullptr;
+
+Scale9SpriteBatchNode::Segment::Segment()
+{
+    command.setDrawType(CustomCommand::DrawType::ELEMENT);
+    command.setPrimitiveType(CustomCommand::PrimitiveType::TRIANGLE);
+}
+
+Scale9SpriteBatchNode* Scale9SpriteBatchNode::create(Texture2D* texture)
+{
+    auto ret = new (std::nothrow) Scale9SpriteBatchNode();
+    if (ret && ret->initWithTexture(texture))
+    {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+Scale9SpriteBatchNode* Scale9SpriteBatchNode::create(const std::string& textureFile)
+{
+    auto texture = Director::getInstance()->getTextureCache()->addImage(textureFile);
+    return texture ? create(texture) : nullptr;
+}
+
+Scale9SpriteBatchNode::Scale9SpriteBatchNode()
+: _texture(nullptr)
+, _blendFunc(BlendFunc::ALPHA_PREMULTIPLIED)
+, _programState(nullptr)
+, _streamLayoutDirty(true)
+, _visitedFrame(0)
+, _segmentCount(0)
+{
+}
+
+Scale9SpriteBatchNode::~Scale9SpriteBatchNode()
+{
+    CC_SAFE_RELEASE_NULL(_programState);
+    CC_SAFE_RELEASE_NULL(_texture);
+}
+
+bool Scale9SpriteBatchNode::initWithTexture(Texture2D* texture)
+{
+    if (!texture || !Node::init())
+    {
+        return false;
+    }
+
+    _texture = texture;
+    _texture->retain();
+    // same blend function as Sprite::updateBlendFunc, so that default sprites of the texture match
+    _blendFunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+
+    auto program = backend::Program::getBuiltinProgram(backend::ProgramType::POSITION_TEXTURE_COLOR);
+    auto programState = new (std::nothrow) backend::ProgramState(program);
+    _programState = programState;
+    _mvpMatrixLocation = programState->getUniformLocation(backend::Uniform::MVP_MATRIX);
+    _textureLocation = programState->getUniformLocation(backend::Uniform::TEXTURE);
+
+    auto vertexLayout = programState->getVertexLayout();
+    vertexLayout->setAttribute(backend::ATTRIBUTE_NAME_POSITION,
+                               programState->getAttributeLocation(backend::Attribute::POSITION),
+                               backend::VertexFormat::FLOAT3,
+                               0,
+                               false);
+    vertexLayout->setAttribute(backend::ATTRIBUTE_NAME_TEXCOORD,
+                               programState->getAttributeLocation(backend::Attribute::TEXCOORD),
+                               backend::VertexFormat::FLOAT2,
+                               offsetof(V3F_C4B_T2F, texCoords),
+                               false);
+    vertexLayout->setAttribute(backend::ATTRIBUTE_NAME_COLOR,
+                               programState->getAttributeLocation(backend::Attribute::COLOR),
+                               backend::VertexFormat::UBYTE4,
+                               offsetof(V3F_C4B_T2F, colors),
+                               true);
+    vertexLayout->setLayout(sizeof(V3F_C4B_T2F));
+    return true;
+}
+
+bool Scale9SpriteBatchNode::isBatchable(Scale9Sprite* sprite) const
+{
+    if (sprite->getTexture() != _texture
+        || sprite->getState() != Scale9Sprite::State::NORMAL
+        || !(sprite->getBlendFunc() == _blendFunc)
+        || sprite->getGlobalZOrder() != _globalZOrder)
+        return false;
+
+    auto programState = sprite->getProgramState();
+    if (!programState || programState->getProgram()->getProgramType() != backend::ProgramType::POSITION_TEXTURE_COLOR)
+        return false;
+
+    // the stream is drawn outside of the clipping of the nodes between the sprite and the batch node
+    for (auto node = sprite->getParent(); node != this; node = node->getParent())
+    {
+        if (node == nullptr
+            || dynamic_cast<ClippingNode*>(node)
+            || dynamic_cast<ClippingRectangleNode*>(node))
+            return false;
+
+        auto layout = dynamic_cast<Layout*>(node);
+        if (layout && layout->isClippingEnabled())
+            return false;
+    }
+    return true;
+}
+
+bool Scale9SpriteBatchNode::addSprite(Scale9Sprite* sprite, uint32_t flags)
+{
+    if (!isBatchable(sprite))
+        return false;
+
+    auto& entry = _sprites[sprite];
+    bool isNew = (entry.visitedFrame == 0);
+    entry.visitedFrame = _visitedFrame;
+
+    const auto& triangles = sprite->getPolygonInfo().triangles;
+    bool geometryChanged = entry.sourceVerts.size() != triangles.vertCount
+        || entry.indices.size() != triangles.indexCount
+        || memcmp(entry.sourceVerts.data(), triangles.verts, triangles.vertCount * sizeof(V3F_C4B_T2F)) != 0
+        || memcmp(entry.indices.data(), triangles.indices, triangles.indexCount * sizeof(unsigned short)) != 0;
+    if (geometryChanged)
+    {
+        if (entry.sourceVerts.size() != triangles.vertCount || entry.indices.size() != triangles.indexCount)
+            _streamLayoutDirty = true;
+        entry.sourceVerts.assign(triangles.verts, triangles.verts + triangles.vertCount);
+        entry.indices.assign(triangles.indices, triangles.indices + triangles.indexCount);
+    }
+
+    // the transform to the batch node can only change when one of the node transforms did
+    bool transformChanged = false;
+    if (isNew || (flags & FLAGS_TRANSFORM_DIRTY))
+    {
+        Mat4 transform = sprite->getNodeToParentTransform(this);
+        transformChanged = isNew || memcmp(transform.m, entry.transform.m, sizeof(transform.m)) != 0;
+        entry.transform = transform;
+    }
+
+    if (geometryChanged || transformChanged)
+    {
+        entry.verts.resize(entry.sourceVerts.size());
+        for (size_t i = 0, count = entry.sourceVerts.size(); i < count; ++i)
+        {
+            entry.verts[i] = entry.sourceVerts[i];
+            entry.transform.transformPoint(&entry.verts[i].vertices);
+        }
+        entry.dirty = true;
+    }
+
+    _drawOrder.push_back(sprite);
+    return true;
+}
+
+void Scale9SpriteBatchNode::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+    {
+        return;
+    }
+
+    if (++_visitedFrame == 0)
+        ++_visitedFrame;
+    _drawOrder.clear();
+
+    auto previousBatchNode = s_visitingBatchNode;
+    s_visitingBatchNode = this;
+    Node::visit(renderer, parentTransform, parentFlags);
+    s_visitingBatchNode = previousBatchNode;
+
+    updateStream();
+
+    // the group command was queued by draw(), before the sprites of the subtree were visited
+    for (size_t i = 0; i < _segmentCount; ++i)
+    {
+        auto& command = _segments[i].command;
+        command.init(_globalZOrder, _blendFunc);
+        renderer->addCommand(&command, _groupCommand.getRenderQueueID());
+    }
+}
+
+Scale9SpriteBatchNode::Segment& Scale9SpriteBatchNode::addSegment()
+{
+    if (_segmentCount == _segments.size())
+    {
+        _segments.emplace_back();
+        _segments.back().command.getPipelineDescriptor().programState = _programState;
+    }
+
+    auto& segment = _segments[_segmentCount++];
+    segment.indices.clear();
+    segment.vertexBegin = _vertices.size();
+    segment.vertexCount = 0;
+    segment.dirtyBegin = segment.dirtyEnd = 0;
+    return segment;
+}
+
+void Scale9SpriteBatchNode::uploadSegment(Segment& segment)
+{
+    if (segment.vertexCount > segment.vertexCapacity)
+    {
+        segment.vertexCapacity = std::min(std::max(segment.vertexCount + segment.vertexCount / 2, static_cast<size_t>(64)), MAX_VERTICES_PER_COMMAND);
+        segment.command.createVertexBuffer(sizeof(V3F_C4B_T2F), segment.vertexCapacity, CustomCommand::BufferUsage::DYNAMIC);
+    }
+    if (segment.indices.size() > segment.indexCapacity)
+    {
+        segment.indexCapacity = std::max(segment.indices.size() + segment.indices.size() / 2, static_cast<size_t>(256));
+        segment.command.createIndexBuffer(CustomCommand::IndexFormat::U_SHORT, segment.indexCapacity, CustomCommand::BufferUsage::DYNAMIC);
+    }
+    segment.command.updateVertexBuffer(_vertices.data() + segment.vertexBegin, segment.vertexCount * sizeof(V3F_C4B_T2F));
+    segment.command.updateIndexBuffer(segment.indices.data(), segment.indices.size() * sizeof(unsigned short));
+    segment.command.setIndexDrawInfo(0, segment.indices.size());
+}
+
+void Scale9SpriteBatchNode::updateStream()
+{
+    // forget the sprites that weren't drawn by this visit
+    for (auto it = _sprites.begin(); it != _sprites.end();)
+    {
+        if (it->second.visitedFrame != _visitedFrame)
+            it = _sprites.erase(it);
+        else
+            ++it;
+    }
+
+    if (_streamLayoutDirty || _drawOrder != _streamOrder)
+    {
+        // a new segment starts when the next sprite would push the current one past the 16 bit index range
+        _vertices.clear();
+        _segmentCount = 0;
+        Segment* segment = nullptr;
+        for (auto sprite : _drawOrder)
+        {
+            auto& entry = _sprites[sprite];
+            if (segment == nullptr || segment->vertexCount + entry.verts.size() > MAX_VERTICES_PER_COMMAND)
+                segment = &addSegment();
+
+            entry.vertexOffset = static_cast<unsigned int>(_vertices.size());
+            entry.segment = static_cast<unsigned int>(_segmentCount - 1);
+            entry.dirty = false;
+            auto localOffset = static_cast<unsigned short>(segment->vertexCount);
+            _vertices.insert(_vertices.end(), entry.verts.begin(), entry.verts.end());
+            for (auto index : entry.indices)
+                segment->indices.push_back(static_cast<unsigned short>(localOffset + index));
+            segment->vertexCount += entry.verts.size();
+        }
+
+        for (size_t i = 0; i < _segmentCount; ++i)
+            uploadSegment(_segments[i]);
+
+        _streamOrder = _drawOrder;
+        _streamLayoutDirty = false;
+        return;
+    }
+
+    // same sprites in the same order, only upload the vertices of the ones that changed
+    for (auto sprite : _drawOrder)
+    {
+        auto& entry = _sprites[sprite];
+        if (!entry.dirty)
+            continue;
+
+        std::copy(entry.verts.begin(), entry.verts.end(), _vertices.begin() + entry.vertexOffset);
+        auto& segment = _segments[entry.segment];
+        size_t begin = entry.vertexOffset - segment.vertexBegin;
+        size_t end = begin + entry.verts.size();
+        if (segment.dirtyBegin < segment.dirtyEnd)
+        {
+            begin = std::min(begin, segment.dirtyBegin);
+            end = std::max(end, segment.dirtyEnd);
+        }
+        segment.dirtyBegin = begin;
+        segment.dirtyEnd = end;
+        entry.dirty = false;
+    }
+    for (size_t i = 0; i < _segmentCount; ++i)
+    {
+        auto& segment = _segments[i];
+        if (segment.dirtyBegin < segment.dirtyEnd)
+        {
+            segment.command.updateVertexBuffer(_vertices.data() + segment.vertexBegin + segment.dirtyBegin,
+                                               segment.dirtyBegin * sizeof(V3F_C4B_T2F),
+                                               (segment.dirtyEnd - segment.dirtyBegin) * sizeof(V3F_C4B_T2F));
+            segment.dirtyBegin = segment.dirtyEnd = 0;
+        }
+    }
+}
+
+void Scale9SpriteBatchNode::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    // the stream is filled by the sprites visited after this call, visit() adds its commands to the group
+    const auto& projection = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Mat4 matrixMVP = projection * transform;
+
+    _programState->setUniform(_mvpMatrixLocation, matrixMVP.m, sizeof(matrixMVP.m));
+    _programState->setTexture(_textureLocation, 0, _texture->getBackendTexture());
+
+    _groupCommand.init(_globalZOrder);
+    renderer->addCommand(&_groupCommand);
+}
+
+}
+
+NS_CC_END
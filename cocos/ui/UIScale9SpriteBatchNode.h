@@ -0,0 +1,169 @@
+/****************************************************************************
+Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __UISCALE9SPRITEBATCHNODE_H__
+#define __UISCALE9SPRITEBATCHNODE_H__
+
+#include "2d/CCNode.h"
+#include "base/ccTypes.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCGroupCommand.h"
+#include "ui/GUIExport.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @addtogroup ui
+ * @{
+ */
+NS_CC_BEGIN
+
+class Texture2D;
+
+namespace ui {
+
+class Scale9Sprite;
+
+/**
+ *@brief Draws the Scale9Sprites of its subtree that share one texture with a single draw call.
+ *
+ * Panels, buttons and list cells usually take their backgrounds from one atlas. Under a Scale9SpriteBatchNode,
+ * every visible Scale9Sprite of the subtree that uses the batch texture, the normal state, the default shader and
+ * the batch blend function writes its triangles into a vertex stream owned by the batch node instead of issuing
+ * its own command. The triangles of a sprite are only transformed again when its geometry, color or transform
+ * relative to the batch node changes, and only the vertices of those sprites are uploaded.
+ *
+ * The stream is indexed with 16 bit indices, so it is drawn by one command per 65536 vertices.
+ *
+ * The stream is drawn where the batch node itself draws: batched sprites appear in visit order among themselves,
+ * above the children of the batch node with a negative local z order and below everything else of the subtree
+ * (labels, icons, sprites of other textures). Sprites under a clipping node or a clipping Layout, or with a
+ * different global z order than the batch node, are not batched. Nest batch nodes to keep groups that overlap,
+ * like a popup above a list, in order.
+ */
+class CC_GUI_DLL Scale9SpriteBatchNode : public Node
+{
+public:
+    /**
+     * Creates a batch node for the Scale9Sprites using a texture.
+     */
+    static Scale9SpriteBatchNode* create(Texture2D* texture);
+
+    /**
+     * Creates a batch node for the Scale9Sprites using the texture of an image file.
+     */
+    static Scale9SpriteBatchNode* create(const std::string& textureFile);
+
+    /**
+     * Returns the batch node being visited, if any.
+     */
+    static Scale9SpriteBatchNode* getVisitingBatchNode() { return s_visitingBatchNode; }
+
+    /**
+     * Adds the triangles of a sprite to the stream drawn this frame.
+     * Called by Scale9Sprite::draw while the batch node is visited.
+     *
+     * @param sprite A visible sprite of the subtree.
+     * @param flags The flags the sprite is drawn with.
+     * @return false if the sprite can't be batched and has to draw itself.
+     */
+    bool addSprite(Scale9Sprite* sprite, uint32_t flags);
+
+    Texture2D* getTexture() const { return _texture; }
+
+    /** Returns the number of sprites drawn by the batch node in the last frame. */
+    size_t getBatchedSpriteCount() const { return _drawOrder.size(); }
+
+    virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    Scale9SpriteBatchNode();
+    virtual ~Scale9SpriteBatchNode();
+
+    bool initWithTexture(Texture2D* texture);
+
+protected:
+    struct BatchedSprite
+    {
+        Mat4 transform;                         // from the sprite to the batch node
+        std::vector<V3F_C4B_T2F> sourceVerts;   // sprite vertices the batch vertices were made from
+        std::vector<unsigned short> indices;
+        std::vector<V3F_C4B_T2F> verts;         // vertices in the batch node space
+        unsigned int vertexOffset = 0;          // in the stream
+        unsigned int segment = 0;
+        unsigned int visitedFrame = 0;
+        bool dirty = true;
+    };
+
+    /// part of the stream drawn by one command
+    struct Segment
+    {
+        Segment();
+
+        CustomCommand command;
+        std::vector<unsigned short> indices;
+        size_t vertexBegin = 0;                 // in the stream
+        size_t vertexCount = 0;
+        size_t vertexCapacity = 0;
+        size_t indexCapacity = 0;
+        size_t dirtyBegin = 0;
+        size_t dirtyEnd = 0;
+    };
+
+    bool isBatchable(Scale9Sprite* sprite) const;
+    Segment& addSegment();
+    void uploadSegment(Segment& segment);
+    void updateStream();
+
+    static Scale9SpriteBatchNode* s_visitingBatchNode;
+
+    Texture2D* _texture;
+    BlendFunc _blendFunc;
+    backend::ProgramState* _programState;
+    GroupCommand _groupCommand;                 // queued by draw(), the segments are added to it after the visit
+    backend::UniformLocation _mvpMatrixLocation;
+    backend::UniformLocation _textureLocation;
+
+    std::unordered_map<Scale9Sprite*, BatchedSprite> _sprites;
+    std::vector<Scale9Sprite*> _drawOrder;      // sprites visited this frame
+    std::vector<Scale9Sprite*> _streamOrder;    // sprites the stream was laid out for
+    bool _streamLayoutDirty;
+    unsigned int _visitedFrame;
+
+    std::vector<V3F_C4B_T2F> _vertices;
+    std::deque<Segment> _segments;              // only grows, the first _segmentCount ones are drawn
+    size_t _segmentCount;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(Scale9SpriteBatchNode);
+};
+
+}
+NS_CC_END
+// end of ui group
+/// @}
+
+#endif /* defined(__UISCALE9SPRITEBATCHNODE_H__) */
@@ -0,0 +1,750 @@
+/****************************************************************************
+Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "ui/UIVirtualListView.h"
+#include <algorithm>
+
+NS_CC_BEGIN
+
+static const float DEFAULT_ESTIMATED_ITEM_SIZE = 40.0f;
+static const float DEFAULT_OVERSCAN_RATIO = 0.5f;
+// measuring freshly created cells can move the visible range, settle it a few times at most
+static const int MAX_MEASURE_PASSES = 4;
+
+namespace ui {
+
+IMPLEMENT_CLASS_GUI_INFO(VirtualListView)
+
+VirtualListView::VirtualListView():
+_itemCountCallback(nullptr),
+_itemSizeCallback(nullptr),
+_cellFactory(nullptr),
+_cellRecycledCallback(nullptr),
+_itemCount(0),
+_firstCellIndex(0),
+_estimatedItemSize(DEFAULT_ESTIMATED_ITEM_SIZE),
+_overscanRatio(DEFAULT_OVERSCAN_RATIO),
+_itemsMargin(0.0f),
+_leftPadding(0.0f),
+_topPadding(0.0f),
+_rightPadding(0.0f),
+_bottomPadding(0.0f),
+_cellsDirty(true),
+_lastScrollOffset(0.0f)
+{
+    this->setTouchEnabled(true);
+}
+
+VirtualListView::~VirtualListView()
+{
+    _cells.clear();
+    _reusableCells.clear();
+}
+
+VirtualListView* VirtualListView::create()
+{
+    VirtualListView* widget = new (std::nothrow) VirtualListView();
+    if (widget && widget->init())
+    {
+        widget->autorelease();
+        return widget;
+    }
+    CC_SAFE_DELETE(widget);
+    return nullptr;
+}
+
+bool VirtualListView::init()
+{
+    if (ScrollView::init())
+    {
+        setDirection(Direction::VERTICAL);
+        return true;
+    }
+    return false;
+}
+
+void VirtualListView::setItemCountCallback(const ccItemCountCallback& callback)
+{
+    _itemCountCallback = callback;
+}
+
+void VirtualListView::setItemSizeCallback(const ccItemSizeCallback& callback)
+{
+    _itemSizeCallback = callback;
+}
+
+void VirtualListView::setCellFactory(const ccCellFactory& factory)
+{
+    _cellFactory = factory;
+}
+
+void VirtualListView::setCellRecycledCallback(const ccCellRecycledCallback& callback)
+{
+    _cellRecycledCallback = callback;
+}
+
+void VirtualListView::setEstimatedItemSize(float size)
+{
+    _estimatedItemSize = MAX(size, 0.0f);
+}
+
+float VirtualListView::getEstimatedItemSize() const
+{
+    return _estimatedItemSize;
+}
+
+void VirtualListView::setOverscanRatio(float ratio)
+{
+    _overscanRatio = MAX(ratio, 0.0f);
+    _cellsDirty = true;
+}
+
+float VirtualListView::getOverscanRatio() const
+{
+    return _overscanRatio;
+}
+
+void VirtualListView::setItemsMargin(float margin)
+{
+    if (_itemsMargin == margin)
+    {
+        return;
+    }
+    _itemsMargin = margin;
+    rebuildExtentTree();
+    updateInnerContainerSize();
+}
+
+float VirtualListView::getItemsMargin() const
+{
+    return _itemsMargin;
+}
+
+void VirtualListView::setPadding(float l, float t, float r, float b)
+{
+    if (l == _leftPadding && t == _topPadding && r == _rightPadding && b == _bottomPadding)
+    {
+        return;
+    }
+    _leftPadding = l;
+    _topPadding = t;
+    _rightPadding = r;
+    _bottomPadding = b;
+    updateInnerContainerSize();
+    _cellsDirty = true;
+}
+
+float VirtualListView::getLeftPadding() const
+{
+    return _leftPadding;
+}
+
+float VirtualListView::getTopPadding() const
+{
+    return _topPadding;
+}
+
+float VirtualListView::getRightPadding() const
+{
+    return _rightPadding;
+}
+
+float VirtualListView::getBottomPadding() const
+{
+    return _bottomPadding;
+}
+
+void VirtualListView::setDirection(Direction dir)
+{
+    if (dir != Direction::VERTICAL && dir != Direction::HORIZONTAL)
+    {
+        CCLOG("VirtualListView only scrolls vertically or horizontally!");
+        return;
+    }
+    ScrollView::setDirection(dir);
+    // item sizes are measured along the scrolling direction
+    reloadData();
+}
+
+void VirtualListView::reloadData()
+{
+    recycleAllCells();
+
+    _itemCount = _itemCountCallback ? MAX(_itemCountCallback(this), 0) : 0;
+    _itemSizes.resize(_itemCount);
+    for (ssize_t i = 0; i < _itemCount; ++i)
+    {
+        _itemSizes[i] = queryItemSize(i);
+    }
+    rebuildExtentTree();
+    updateInnerContainerSize();
+    _cellsDirty = true;
+}
+
+void VirtualListView::notifyItemChanged(ssize_t index)
+{
+    if (index < 0 || index >= _itemCount)
+    {
+        return;
+    }
+
+    if (_itemSizeCallback)
+    {
+        float size = _itemSizeCallback(this, index);
+        float delta = size - _itemSizes[index];
+        if (delta != 0.0f)
+        {
+            // keep the visible items still when an item above them changes
+            bool beforeView = getItemOffset(index) + _itemSizes[index] <= getScrollOffset();
+            setItemSize(index, size);
+            updateInnerContainerSize();
+            if (beforeView)
+            {
+                setScrollOffset(getScrollOffset() + delta);
+            }
+        }
+    }
+
+    ssize_t cellIndex = index - _firstCellIndex;
+    if (cellIndex >= 0 && cellIndex < static_cast<ssize_t>(_cells.size()))
+    {
+        recycleCell(_cells[cellIndex], index);
+        _cells[cellIndex] = createCell(index);
+    }
+    _cellsDirty = true;
+}
+
+void VirtualListView::notifyItemsInserted(ssize_t index, ssize_t count)
+{
+    index = MAX(MIN(index, _itemCount), 0);
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // cells at and after the insertion point now show other items
+    while (!_cells.empty() && _firstCellIndex + static_cast<ssize_t>(_cells.size()) > index)
+    {
+        recycleCell(_cells.back(), _firstCellIndex + _cells.size() - 1);
+        _cells.pop_back();
+    }
+
+    bool beforeView = _itemCount > 0 && getItemOffset(index) < getScrollOffset();
+    float offset = getScrollOffset();
+
+    _itemSizes.insert(_itemSizes.begin() + index, count, 0.0f);
+    _itemCount += count;
+    float insertedLength = 0.0f;
+    for (ssize_t i = index; i < index + count; ++i)
+    {
+        _itemSizes[i] = queryItemSize(i);
+        insertedLength += _itemSizes[i] + _itemsMargin;
+    }
+    rebuildExtentTree();
+    updateInnerContainerSize();
+    if (beforeView)
+    {
+        setScrollOffset(offset + insertedLength);
+    }
+    _cellsDirty = true;
+}
+
+void VirtualListView::notifyItemsRemoved(ssize_t index, ssize_t count)
+{
+    if (index < 0 || index >= _itemCount || count <= 0)
+    {
+        return;
+    }
+    count = MIN(count, _itemCount - index);
+
+    while (!_cells.empty() && _firstCellIndex + static_cast<ssize_t>(_cells.size()) > index)
+    {
+        recycleCell(_cells.back(), _firstCellIndex + _cells.size() - 1);
+        _cells.pop_back();
+    }
+
+    float offset = getScrollOffset();
+    float removedLength = getExtentPrefix(index + count) - getExtentPrefix(index);
+    bool beforeView = getItemOffset(index) + removedLength <= offset;
+
+    _itemSizes.erase(_itemSizes.begin() + index, _itemSizes.begin() + index + count);
+    _itemCount -= count;
+    rebuildExtentTree();
+    updateInnerContainerSize();
+    if (beforeView)
+    {
+        setScrollOffset(clampScrollOffset(offset - removedLength));
+    }
+    _cellsDirty = true;
+}
+
+Widget* VirtualListView::dequeueCell()
+{
+    if (_reusableCells.empty())
+    {
+        return nullptr;
+    }
+    Widget* cell = _reusableCells.back();
+    // the pool holds the only reference, keep the cell alive until the caller adds it back
+    cell->retain();
+    cell->autorelease();
+    _reusableCells.popBack();
+    return cell;
+}
+
+ssize_t VirtualListView::getItemCount() const
+{
+    return _itemCount;
+}
+
+Widget* VirtualListView::getCellAtIndex(ssize_t index) const
+{
+    ssize_t cellIndex = index - _firstCellIndex;
+    if (cellIndex < 0 || cellIndex >= static_cast<ssize_t>(_cells.size()))
+    {
+        return nullptr;
+    }
+    return _cells[cellIndex];
+}
+
+ssize_t VirtualListView::getIndexOfCell(Widget* cell) const
+{
+    if (nullptr == cell)
+    {
+        return -1;
+    }
+    auto iter = std::find(_cells.begin(), _cells.end(), cell);
+    return iter == _cells.end() ? -1 : _firstCellIndex + (iter - _cells.begin());
+}
+
+ssize_t VirtualListView::getFirstCellIndex() const
+{
+    return _cells.empty() ? -1 : _firstCellIndex;
+}
+
+ssize_t VirtualListView::getLastCellIndex() const
+{
+    return _cells.empty() ? -1 : _firstCellIndex + _cells.size() - 1;
+}
+
+ssize_t VirtualListView::getItemIndexAtOffset(float offset) const
+{
+    if (_itemCount == 0)
+    {
+        return -1;
+    }
+
+    // descend the binary indexed tree to count the items ending before the offset
+    float remaining = offset - getStartPadding();
+    ssize_t position = 0;
+    ssize_t step = 1;
+    while (step * 2 <= _itemCount)
+    {
+        step *= 2;
+    }
+    for (; step > 0; step /= 2)
+    {
+        if (position + step <= _itemCount && _extentTree[position + step] <= remaining)
+        {
+            position += step;
+            remaining -= _extentTree[position];
+        }
+    }
+    return MIN(position, _itemCount - 1);
+}
+
+float VirtualListView::getItemOffset(ssize_t index) const
+{
+    return getStartPadding() + getExtentPrefix(index);
+}
+
+void VirtualListView::jumpToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint)
+{
+    if (itemIndex < 0 || itemIndex >= _itemCount)
+    {
+        return;
+    }
+
+    float size = _itemSizes[itemIndex];
+    float offset = getItemOffset(itemIndex);
+    if (isVertical())
+    {
+        offset += (1.0f - itemAnchorPoint.y) * size - (1.0f - positionRatioInView.y) * _contentSize.height;
+    }
+    else
+    {
+        offset += itemAnchorPoint.x * size - positionRatioInView.x * _contentSize.width;
+    }
+    jumpToDestination(getInnerContainerPositionForOffset(clampScrollOffset(offset)));
+}
+
+void VirtualListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint, float timeInSec)
+{
+    if (itemIndex < 0 || itemIndex >= _itemCount)
+    {
+        return;
+    }
+
+    float size = _itemSizes[itemIndex];
+    float offset = getItemOffset(itemIndex);
+    if (isVertical())
+    {
+        offset += (1.0f - itemAnchorPoint.y) * size - (1.0f - positionRatioInView.y) * _contentSize.height;
+    }
+    else
+    {
+        offset += itemAnchorPoint.x * size - positionRatioInView.x * _contentSize.width;
+    }
+    startAutoScrollToDestination(getInnerContainerPositionForOffset(clampScrollOffset(offset)), timeInSec, true);
+}
+
+void VirtualListView::onSizeChanged()
+{
+    ScrollView::onSizeChanged();
+    updateInnerContainerSize();
+    _cellsDirty = true;
+}
+
+void VirtualListView::doLayout()
+{
+    ScrollView::doLayout();
+    if (_cellsDirty || getScrollOffset() != _lastScrollOffset)
+    {
+        updateCells();
+    }
+}
+
+float VirtualListView::getStartPadding() const
+{
+    return isVertical() ? _topPadding : _leftPadding;
+}
+
+float VirtualListView::getEndPadding() const
+{
+    return isVertical() ? _bottomPadding : _rightPadding;
+}
+
+float VirtualListView::getViewLength() const
+{
+    return isVertical() ? _contentSize.height : _contentSize.width;
+}
+
+float VirtualListView::getContentLength() const
+{
+    float length = getStartPadding() + getEndPadding() + getExtentPrefix(_itemCount);
+    if (_itemCount > 0)
+    {
+        length -= _itemsMargin;
+    }
+    return length;
+}
+
+float VirtualListView::getScrollOffset() const
+{
+    if (isVertical())
+    {
+        return _innerContainer->getTopBoundary() - _contentSize.height;
+    }
+    return -_innerContainer->getLeftBoundary();
+}
+
+Vec2 VirtualListView::getInnerContainerPositionForOffset(float offset) const
+{
+    Vec2 position = _innerContainer->getPosition();
+    const Size& innerSize = _innerContainer->getContentSize();
+    const Vec2& anchorPoint = _innerContainer->getAnchorPoint();
+    if (isVertical())
+    {
+        position.y = _contentSize.height + offset - (1.0f - anchorPoint.y) * innerSize.height;
+    }
+    else
+    {
+        position.x = -offset + anchorPoint.x * innerSize.width;
+    }
+    return position;
+}
+
+void VirtualListView::setScrollOffset(float offset)
+{
+    Vec2 position = getInnerContainerPositionForOffset(offset);
+    if (_autoScrolling)
+    {
+        // auto scrolling moves from its start position, shift it along with the content
+        Vec2 delta = position - getInnerContainerPosition();
+        _autoScrollStartPosition += delta;
+        _autoScrollBrakingStartPosition += delta;
+    }
+    setInnerContainerPosition(position);
+}
+
+float VirtualListView::clampScrollOffset(float offset) const
+{
+    const Size& innerSize = _innerContainer->getContentSize();
+    float maxOffset = (isVertical() ? innerSize.height : innerSize.width) - getViewLength();
+    return clampf(offset, 0.0f, MAX(maxOffset, 0.0f));
+}
+
+float VirtualListView::getItemExtent(ssize_t index) const
+{
+    return _itemSizes[index] + _itemsMargin;
+}
+
+float VirtualListView::queryItemSize(ssize_t index) const
+{
+    if (_itemSizeCallback)
+    {
+        return MAX(_itemSizeCallback(const_cast<VirtualListView*>(this), index), 0.0f);
+    }
+    return _estimatedItemSize;
+}
+
+void VirtualListView::rebuildExtentTree()
+{
+    _extentTree.assign(_itemCount + 1, 0.0f);
+    for (ssize_t i = 1; i <= _itemCount; ++i)
+    {
+        _extentTree[i] += getItemExtent(i - 1);
+        ssize_t parent = i + (i & -i);
+        if (parent <= _itemCount)
+        {
+            _extentTree[parent] += _extentTree[i];
+        }
+    }
+}
+
+void VirtualListView::addToExtentTree(ssize_t index, float delta)
+{
+    for (ssize_t i = index + 1; i <= _itemCount; i += (i & -i))
+    {
+        _extentTree[i] += delta;
+    }
+}
+
+float VirtualListView::getExtentPrefix(ssize_t count) const
+{
+    float sum = 0.0f;
+    for (ssize_t i = MIN(count, _itemCount); i > 0; i -= (i & -i))
+    {
+        sum += _extentTree[i];
+    }
+    return sum;
+}
+
+void VirtualListView::setItemSize(ssize_t index, float size)
+{
+    float delta = size - _itemSizes[index];
+    if (delta != 0.0f)
+    {
+        _itemSizes[index] = size;
+        addToExtentTree(index, delta);
+    }
+}
+
+void VirtualListView::updateInnerContainerSize()
+{
+    float length = getContentLength();
+    Size size = isVertical() ? Size(_contentSize.width, length) : Size(length, _contentSize.height);
+    Size innerSize = _innerContainer->getContentSize();
+    size.width = MAX(size.width, _contentSize.width);
+    size.height = MAX(size.height, _contentSize.height);
+    if (size.equals(innerSize))
+    {
+        return;
+    }
+
+    // setInnerContainerSize snaps back to the start, keep the current scroll offset instead
+    float offset = getScrollOffset();
+    setInnerContainerSize(size);
+    setScrollOffset(clampScrollOffset(offset));
+    _cellsDirty = true;
+}
+
+void VirtualListView::updateCells()
+{
+    _cellsDirty = false;
+    if (_itemCount == 0 || !_cellFactory)
+    {
+        recycleAllCells();
+        _lastScrollOffset = getScrollOffset();
+        return;
+    }
+
+    float viewLength = getViewLength();
+    float overscan = viewLength * _overscanRatio;
+    for (int pass = 0; pass < MAX_MEASURE_PASSES; ++pass)
+    {
+        float offset = getScrollOffset();
+        ssize_t first = getItemIndexAtOffset(offset - overscan);
+        ssize_t last = getItemIndexAtOffset(offset + viewLength + overscan);
+
+        while (!_cells.empty() && _firstCellIndex < first)
+        {
+            recycleCell(_cells.front(), _firstCellIndex);
+            _cells.pop_front();
+            ++_firstCellIndex;
+        }
+        while (!_cells.empty() && _firstCellIndex + static_cast<ssize_t>(_cells.size()) - 1 > last)
+        {
+            recycleCell(_cells.back(), _firstCellIndex + _cells.size() - 1);
+            _cells.pop_back();
+        }
+        if (_cells.empty())
+        {
+            _firstCellIndex = first;
+        }
+
+        while (_firstCellIndex > first)
+        {
+            --_firstCellIndex;
+            _cells.push_front(createCell(_firstCellIndex));
+        }
+        while (_firstCellIndex + static_cast<ssize_t>(_cells.size()) <= last)
+        {
+            _cells.push_back(createCell(_firstCellIndex + _cells.size()));
+        }
+
+        // measured cells may have changed the item offsets
+        if (!_cellsDirty)
+        {
+            break;
+        }
+        _cellsDirty = false;
+    }
+
+    for (ssize_t i = 0; i < static_cast<ssize_t>(_cells.size()); ++i)
+    {
+        if (_cells[i])
+        {
+            positionCell(_cells[i], _firstCellIndex + i);
+        }
+    }
+    _lastScrollOffset = getScrollOffset();
+}
+
+void VirtualListView::recycleCell(Widget* cell, ssize_t index)
+{
+    if (nullptr == cell)
+    {
+        return;
+    }
+    _reusableCells.pushBack(cell);
+    ScrollView::removeChild(cell, true);
+    if (_cellRecycledCallback)
+    {
+        _cellRecycledCallback(this, cell, index);
+    }
+}
+
+void VirtualListView::recycleAllCells()
+{
+    for (ssize_t i = 0; i < static_cast<ssize_t>(_cells.size()); ++i)
+    {
+        recycleCell(_cells[i], _firstCellIndex + i);
+    }
+    _cells.clear();
+    _firstCellIndex = 0;
+}
+
+Widget* VirtualListView::createCell(ssize_t index)
+{
+    Widget* cell = _cellFactory(this, index);
+    if (nullptr == cell)
+    {
+        CCLOG("VirtualListView: no cell for item %d", static_cast<int>(index));
+        return nullptr;
+    }
+    if (cell->getParent() != _innerContainer)
+    {
+        CCASSERT(cell->getParent() == nullptr, "A cell can't be added to the list while it has another parent!");
+        ScrollView::addChild(cell);
+    }
+
+    if (!_itemSizeCallback)
+    {
+        float size = isVertical() ? cell->getContentSize().height : cell->getContentSize().width;
+        float delta = size - _itemSizes[index];
+        if (delta != 0.0f)
+        {
+            bool beforeView = getItemOffset(index) + _itemSizes[index] <= getScrollOffset();
+            setItemSize(index, size);
+            updateInnerContainerSize();
+            if (beforeView)
+            {
+                setScrollOffset(getScrollOffset() + delta);
+            }
+            _cellsDirty = true;
+        }
+    }
+    return cell;
+}
+
+void VirtualListView::positionCell(Widget* cell, ssize_t index)
+{
+    const Size& innerSize = _innerContainer->getContentSize();
+    const Size& cellSize = cell->getContentSize();
+    Vec2 anchorPoint = cell->isIgnoreAnchorPointForPosition() ? Vec2::ZERO : cell->getAnchorPoint();
+    float offset = getItemOffset(index);
+    if (isVertical())
+    {
+        cell->setPosition(Vec2(_leftPadding + anchorPoint.x * cellSize.width,
+                               innerSize.height - offset - (1.0f - anchorPoint.y) * cellSize.height));
+    }
+    else
+    {
+        cell->setPosition(Vec2(offset + anchorPoint.x * cellSize.width,
+                               innerSize.height - _topPadding - (1.0f - anchorPoint.y) * cellSize.height));
+    }
+}
+
+std::string VirtualListView::getDescription() const
+{
+    return "VirtualListView";
+}
+
+Widget* VirtualListView::createCloneInstance()
+{
+    return VirtualListView::create();
+}
+
+void VirtualListView::copySpecialProperties(Widget *widget)
+{
+    VirtualListView* listView = dynamic_cast<VirtualListView*>(widget);
+    if (listView)
+    {
+        ScrollView::copySpecialProperties(widget);
+        _itemCountCallback = listView->_itemCountCallback;
+        _itemSizeCallback = listView->_itemSizeCallback;
+        _cellFactory = listView->_cellFactory;
+        _cellRecycledCallback = listView->_cellRecycledCallback;
+        _estimatedItemSize = listView->_estimatedItemSize;
+        _overscanRatio = listView->_overscanRatio;
+        _itemsMargin = listView->_itemsMargin;
+        setPadding(listView->_leftPadding, listView->_topPadding, listView->_rightPadding, listView->_bottomPadding);
+        setDirection(listView->_direction);
+    }
+}
+
+}
+NS_CC_END
@@ -0,0 +1,296 @@
+/****************************************************************************
+Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __UIVIRTUALLISTVIEW_H__
+#define __UIVIRTUALLISTVIEW_H__
+
+#include "ui/UIScrollView.h"
+#include "ui/GUIExport.h"
+#include <deque>
+
+/**
+ * @addtogroup ui
+ * @{
+ */
+NS_CC_BEGIN
+
+namespace ui{
+
+/**
+ *@brief VirtualListView is a ScrollView that displays a large list of items without keeping a widget per item.
+ * The number of items, their sizes and their cells are provided by callbacks. Only the items inside the view,
+ * plus an overscan distance on both sides, are backed by a cell widget; cells that scroll out are recycled
+ * into a reuse pool that the cell factory draws from with `dequeueCell`.
+ * Item offsets are kept in a binary indexed tree, so finding the item at an offset, jumping to an item or
+ * changing the size of one item costs O(log n) no matter how long the list is.
+ */
+class CC_GUI_DLL VirtualListView : public ScrollView
+{
+
+    DECLARE_CLASS_GUI_INFO
+public:
+    /**
+     * Returns the number of items in the list.
+     */
+    typedef std::function<ssize_t(VirtualListView*)> ccItemCountCallback;
+
+    /**
+     * Returns the size of an item along the scrolling direction.
+     */
+    typedef std::function<float(VirtualListView*, ssize_t)> ccItemSizeCallback;
+
+    /**
+     * Returns a cell showing the item at the given index, usually a cell from `dequeueCell` set up again.
+     */
+    typedef std::function<Widget*(VirtualListView*, ssize_t)> ccCellFactory;
+
+    /**
+     * Called when the cell of an item goes back to the reuse pool.
+     */
+    typedef std::function<void(VirtualListView*, Widget*, ssize_t)> ccCellRecycledCallback;
+
+    /**
+     * Default constructor
+     * @js ctor
+     * @lua new
+     */
+    VirtualListView();
+
+    /**
+     * Default destructor
+     * @js NA
+     * @lua NA
+     */
+    virtual ~VirtualListView();
+
+    /**
+     * Create an empty VirtualListView.
+     *@return A VirtualListView instance.
+     */
+    static VirtualListView* create();
+
+    /**
+     * Set the callback returning the number of items.
+     */
+    void setItemCountCallback(const ccItemCountCallback& callback);
+
+    /**
+     * Set the callback returning the size of each item along the scrolling direction.
+     * Without it items are laid out with the estimated item size and measured from their cell
+     * content size the first time they become visible.
+     */
+    void setItemSizeCallback(const ccItemSizeCallback& callback);
+
+    /**
+     * Set the callback creating or reusing the cell of an item.
+     */
+    void setCellFactory(const ccCellFactory& factory);
+
+    /**
+     * Set the callback called when a cell goes back to the reuse pool.
+     */
+    void setCellRecycledCallback(const ccCellRecycledCallback& callback);
+
+    /**
+     * Set the size used for items that have not been measured yet.
+     * Only used when no item size callback is set.
+     */
+    void setEstimatedItemSize(float size);
+    float getEstimatedItemSize() const;
+
+    /**
+     * Set how far beyond each side of the view cells are kept alive, as a ratio of the view size.
+     * @param ratio Overscan ratio, 0.5 by default.
+     */
+    void setOverscanRatio(float ratio);
+    float getOverscanRatio() const;
+
+    /**
+     * Set the margin between each item.
+     */
+    void setItemsMargin(float margin);
+    float getItemsMargin() const;
+
+    /**
+     * Change padding with left, top, right, and bottom padding.
+     */
+    void setPadding(float l, float t, float r, float b);
+    float getLeftPadding() const;
+    float getTopPadding() const;
+    float getRightPadding() const;
+    float getBottomPadding() const;
+
+    /**
+     * Query the item count again, throw away all item sizes and rebind the visible cells.
+     */
+    void reloadData();
+
+    /**
+     * Query the size of an item again and rebind its cell if it is visible.
+     */
+    void notifyItemChanged(ssize_t index);
+
+    /**
+     * Items were inserted in the data source at the given index.
+     */
+    void notifyItemsInserted(ssize_t index, ssize_t count = 1);
+
+    /**
+     * Items were removed from the data source at the given index.
+     */
+    void notifyItemsRemoved(ssize_t index, ssize_t count = 1);
+
+    /**
+     * Take a cell from the reuse pool.
+     * @return A recycled cell or nullptr if the pool is empty.
+     */
+    Widget* dequeueCell();
+
+    /**
+     * Return the number of items.
+     */
+    ssize_t getItemCount() const;
+
+    /**
+     * Return the cell showing an item.
+     * @return A cell or nullptr if the item has no cell at the moment.
+     */
+    Widget* getCellAtIndex(ssize_t index) const;
+
+    /**
+     * Return the index of the item shown by a cell.
+     * @return An index or -1 if the widget is not a live cell.
+     */
+    ssize_t getIndexOfCell(Widget* cell) const;
+
+    /**
+     * Return the index of the first item backed by a cell, or -1 if there is none.
+     */
+    ssize_t getFirstCellIndex() const;
+
+    /**
+     * Return the index of the last item backed by a cell, or -1 if there is none.
+     */
+    ssize_t getLastCellIndex() const;
+
+    /**
+     * Return the index of the item at an offset from the start of the content along the scrolling direction.
+     */
+    ssize_t getItemIndexAtOffset(float offset) const;
+
+    /**
+     * Return the offset of an item from the start of the content along the scrolling direction.
+     */
+    float getItemOffset(ssize_t index) const;
+
+    /**
+     * @brief Jump to specific item
+     * @param itemIndex Specifies the item's index
+     * @param positionRatioInView Specifies the position with ratio in list view's content size.
+     * @param itemAnchorPoint Specifies an anchor point of each item for position to calculate distance.
+     */
+    void jumpToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint);
+
+    /**
+     * @brief Scroll to specific item
+     * @param positionRatioInView Specifies the position with ratio in list view's content size.
+     * @param itemAnchorPoint Specifies an anchor point of each item for position to calculate distance.
+     * @param timeInSec Scroll time
+     */
+    void scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint, float timeInSec);
+
+    /**
+     * Changes scroll direction of the list, only VERTICAL and HORIZONTAL are supported.
+     */
+    virtual void setDirection(Direction dir) override;
+
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    virtual bool init() override;
+
+protected:
+    virtual void onSizeChanged() override;
+    virtual void doLayout() override;
+    virtual Widget* createCloneInstance() override;
+    virtual void copySpecialProperties(Widget* model) override;
+
+    bool isVertical() const { return _direction != Direction::HORIZONTAL; }
+    float getStartPadding() const;
+    float getEndPadding() const;
+    float getViewLength() const;
+    float getContentLength() const;
+    float getScrollOffset() const;
+    Vec2 getInnerContainerPositionForOffset(float offset) const;
+    void setScrollOffset(float offset);
+    float clampScrollOffset(float offset) const;
+    float getItemExtent(ssize_t index) const;
+    float queryItemSize(ssize_t index) const;
+
+    void rebuildExtentTree();
+    void addToExtentTree(ssize_t index, float delta);
+    float getExtentPrefix(ssize_t count) const;
+    void setItemSize(ssize_t index, float size);
+
+    void updateInnerContainerSize();
+    void updateCells();
+    void recycleCell(Widget* cell, ssize_t index);
+    void recycleAllCells();
+    Widget* createCell(ssize_t index);
+    void positionCell(Widget* cell, ssize_t index);
+
+protected:
+    ccItemCountCallback _itemCountCallback;
+    ccItemSizeCallback _itemSizeCallback;
+    ccCellFactory _cellFactory;
+    ccCellRecycledCallback _cellRecycledCallback;
+
+    ssize_t _itemCount;
+    // item sizes along the scrolling direction and a binary indexed tree over size + margin
+    std::vector<float> _itemSizes;
+    std::vector<float> _extentTree;
+
+    // live cells of the items [_firstCellIndex, _firstCellIndex + _cells.size())
+    std::deque<Widget*> _cells;
+    ssize_t _firstCellIndex;
+    Vector<Widget*> _reusableCells;
+
+    float _estimatedItemSize;
+    float _overscanRatio;
+    float _itemsMargin;
+    float _leftPadding;
+    float _topPadding;
+    float _rightPadding;
+    float _bottomPadding;
+
+    bool _cellsDirty;
+    float _lastScrollOffset;
+};
+
+}
+NS_CC_END
+// end of ui group
+/// @}
+
+#endif /* defined(__UIVIRTUALLISTVIEW_H__) */
@@ -330,6 +330,21 @@ void Widget::setContentSize(const cocos2d::Size &contentSize)
         _sizePercent.set(spx, spy);
     }
     onSizeChanged();
+
+    if (_running)
+    {
+        // only the layouts that depend on this size are marked, they are refreshed before the next frame
+        Layout* layoutParent = dynamic_cast<Layout*>(_parent);
+        if (layoutParent && layoutParent->getLayoutType() != Layout::Type::ABSOLUTE)
+        {
+            layoutParent->requestDoLayout();
+        }
+        auto layoutComponent = static_cast<LayoutComponent*>(this->getComponent(__LAYOUT_COMPONENT_NAME));
+        if (layoutComponent)
+        {
+            layoutComponent->requestLayout();
+        }
+    }
 }
 
 void Widget::setSizePercent(const Vec2 &percent)
@@ -31,6 +31,8 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <algorithm>
+#include <memory>
 
 NS_CC_BEGIN
 
@@ -59,65 +61,84 @@ struct CC_DLL Particle3D
     std::unordered_map<std::string, void*> userDefs;
 };
 
+/**
+ * Particle storage. Active and inactive particles are kept in two contiguous arrays,
+ * a particle that expires is swapped with the last active one, so both emitting and
+ * expiring are O(1) and iteration walks memory linearly. Particles allocated with
+ * addDataBlock() also live next to each other in memory.
+ */
 template<typename T>
 class CC_DLL DataPool
 {
 public:
-    typedef typename std::list<T*> PoolList;
-    typedef typename std::list<T*>::iterator PoolIterator;
+    typedef typename std::vector<T*> PoolList;
+    typedef typename std::vector<T*>::iterator PoolIterator;
 
-    DataPool(){};
+    DataPool() : _releasedIndex(0) {};
     ~DataPool(){};
 
     T* createData(){
         if (_locked.empty()) return nullptr;
-        T* p = _locked.front();
-        //_released.push_back(p);
-        //_locked.erase(_locked.begin());
-        _released.splice(_released.end(), _locked, _locked.begin());
+        T* p = _locked.back();
+        _locked.pop_back();
+        _released.push_back(p);
         return p;
     }
 
+    /** Deactivates the particle last returned by getFirst()/getNext(), iteration goes on with the particle moved into its slot. */
     void lockLatestData(){
-        _locked.push_back(*_releasedIter);
-        _releasedIter = _released.erase(_releasedIter);
-        if (_releasedIter != _released.begin() && _releasedIter != _released.end())
-        {
-            --_releasedIter;
-        }
+        lockAt(_releasedIndex, _locked);
+        --_releasedIndex;
     }
 
+    /** Like lockLatestData(), but createData() doesn't reuse the particle before unlockExpiredDatas(). */
+    void expireLatestData(){
+        lockAt(_releasedIndex, _expired);
+        --_releasedIndex;
+    }
+
+    /** Makes the particles deactivated by expireLatestData() available to createData() again. */
+    void unlockExpiredDatas(){
+        _locked.insert(_locked.end(), _expired.begin(), _expired.end());
+        _expired.clear();
+    }
+
+    /** Deactivates data, may be called while iterating with getFirst()/getNext() without skipping a particle. */
     void lockData(T *data){
-        PoolIterator tempIter = _releasedIter;
-        T *ptr = getFirst();
-        while (ptr)
-        {
-            if (ptr == data) break;
-            ptr = getNext();
-        }
-        if (ptr)
+        auto iter = std::find(_released.begin(), _released.end(), data);
+        if (iter == _released.end())
+            return;
+
+        ptrdiff_t index = iter - _released.begin();
+        if (index <= _releasedIndex && _releasedIndex < (ptrdiff_t)_released.size()){
+            // the last particle must not move behind the iteration, so the current one takes the slot
+            // and the last one is moved into the current slot to be visited next, like lockLatestData()
+            std::swap(_released[index], _released[_releasedIndex]);
             lockLatestData();
-        _releasedIter = tempIter;
+        }
+        else{
+            lockAt(index, _locked);
+        }
     }
 
     void lockAllDatas(){
-        _locked.splice(_locked.end(), _released);
-        //_locked.insert(_locked.end(), _released.begin(), _released.end());
-        //_released.clear();
-        _releasedIter = _released.begin();
+        unlockExpiredDatas();
+        _locked.insert(_locked.end(), _released.begin(), _released.end());
+        _released.clear();
+        _releasedIndex = 0;
     }
 
     T* getFirst(){
-        _releasedIter = _released.begin();
-        if (_releasedIter == _released.end()) return nullptr;
-        return *_releasedIter;
+        _releasedIndex = 0;
+        if (_released.empty()) return nullptr;
+        return _released[0];
     }
 
     T* getNext(){
-        if (_releasedIter == _released.end()) return nullptr;
-        ++_releasedIter;
-        if (_releasedIter == _released.end()) return nullptr;
-        return *_releasedIter;
+        if (_releasedIndex >= (ptrdiff_t)_released.size()) return nullptr;
+        ++_releasedIndex;
+        if (_releasedIndex >= (ptrdiff_t)_released.size()) return nullptr;
+        return _released[_releasedIndex];
     }
 
     const PoolList& getActiveDataList() const { return _released; };
@@ -127,21 +148,60 @@ public:
         _locked.push_back(data); 
     }
 
+    /** Allocates count inactive particles of type U in one contiguous block owned by the pool. */
+    template<typename U>
+    U* addDataBlock(unsigned int count){
+        if (count == 0) return nullptr;
+        U* block = new (std::nothrow) U[count];
+        if (block == nullptr) return nullptr;
+        _blocks.push_back(Block{ block, block + count, std::shared_ptr<void>(block, [](void* p){ delete [] static_cast<U*>(p); }) });
+        _locked.reserve(_locked.size() + count);
+        _released.reserve(_released.size() + count);
+        for (unsigned int i = 0; i < count; ++i){
+            _locked.push_back(block + i);
+        }
+        return block;
+    }
+
     bool empty() const { return _released.empty(); };
 
     void removeAllDatas(){
         lockAllDatas();
         for (auto iter : _locked){
-            delete iter;
+            if (!isInBlock(iter))
+                delete iter;
         }
         _locked.clear();
+        _blocks.clear();
     }
 
 private:
+    struct Block
+    {
+        const void* begin;
+        const void* end;
+        std::shared_ptr<void> storage;
+    };
+
+    void lockAt(ptrdiff_t index, PoolList &list){
+        list.push_back(_released[index]);
+        _released[index] = _released.back();
+        _released.pop_back();
+    }
+
+    bool isInBlock(const T* data) const {
+        for (auto& block : _blocks){
+            if (std::less_equal<const void*>()(block.begin, data) && std::less<const void*>()(data, block.end))
+                return true;
+        }
+        return false;
+    }
 
-    PoolIterator _releasedIter;
+    ptrdiff_t _releasedIndex;
     PoolList _released;
     PoolList _locked;
+    PoolList _expired;
+    std::vector<Block> _blocks;
 };
 
 typedef DataPool<Particle3D> ParticlePool;
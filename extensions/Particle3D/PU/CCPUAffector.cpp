@@ -48,6 +48,14 @@ void PUAffector::updatePUAffector(PUParticle3D* /*particle*/, float /*delta*/)
     
 }
 
+void PUAffector::updateAffectorBatch(PUParticle3D** particles, size_t count, float delta)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        updatePUAffector(particles[i], delta);
+    }
+}
+
 const Vec3& PUAffector::getDerivedPosition()
 {
     PUParticleSystem3D *ps = static_cast<PUParticleSystem3D *>(_particleSystem);
@@ -232,4 +240,24 @@ void PUAffector::process( PUParticle3D* particle, float delta, bool firstParticl
     updatePUAffector(particle, delta);
 }
 
+void PUAffector::processBatch(PUParticle3D** particles, size_t count, float delta, bool firstParticle)
+{
+    if (count == 0)
+        return;
+
+    if (firstParticle){
+        firstParticleUpdate(particles[0], delta);
+    }
+
+    if (!_excludedEmitters.empty()){
+        // excluded emitters are checked particle by particle
+        for (size_t i = 0; i < count; ++i){
+            process(particles[i], delta, false);
+        }
+        return;
+    }
+
+    updateAffectorBatch(particles, count, delta);
+}
+
 NS_CC_END
@@ -65,7 +65,12 @@ public:
     virtual void postUpdateAffector(float deltaTime);
     virtual void firstParticleUpdate(PUParticle3D *particle, float deltaTime);
     virtual void initParticleForEmission(PUParticle3D* particle);
+    /** Updates count particles at once. The default implementation calls updatePUAffector() for each of them,
+        affectors on the hot path override it to run the whole batch in one loop.
+    */
+    virtual void updateAffectorBatch(PUParticle3D** particles, size_t count, float delta);
     void process(PUParticle3D* particle, float delta, bool firstParticle);
+    void processBatch(PUParticle3D** particles, size_t count, float delta, bool firstParticle);
 
     void setLocalPosition(const Vec3 &pos) { _position = pos; };
     const Vec3 getLocalPosition() const { return _position; };
@@ -26,6 +26,7 @@
 
 #include "CCPUColorAffector.h"
 #include "extensions/Particle3D/PU/CCPUParticleSystem3D.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
@@ -126,6 +127,49 @@ void PUColorAffector::updatePUAffector( PUParticle3D *particle, float /*deltaTim
     }
 }
 
+void PUColorAffector::updateAffectorBatch( PUParticle3D **particles, size_t count, float /*deltaTime*/ )
+{
+    // Fast rejection
+    if (_colorMap.empty())
+        return;
+
+    // Walk the color map as arrays, the same keys are looked up for every particle
+    _batchTimes.clear();
+    _batchColors.clear();
+    for (auto& entry : _colorMap)
+    {
+        _batchTimes.push_back(entry.first);
+        _batchColors.push_back(entry.second);
+    }
+    const size_t last = _batchTimes.size() - 1;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        PUParticle3D *particle = particles[i];
+        float timeFraction = (particle->totalTimeToLive - particle->timeToLive) / particle->totalTimeToLive;
+
+        // Same key as findNearestColorMapIterator(): the last one not after timeFraction, or the first one
+        size_t index = std::upper_bound(_batchTimes.begin(), _batchTimes.end(), timeFraction) - _batchTimes.begin();
+        index = index > 0 ? index - 1 : 0;
+
+        Vec4 color = _batchColors[index];
+        if (index < last)
+        {
+            // Interpolate colour
+            color += (_batchColors[index + 1] - _batchColors[index]) * ((timeFraction - _batchTimes[index]) / (_batchTimes[index + 1] - _batchTimes[index]));
+        }
+
+        if (_colorOperation == CAO_SET)
+        {
+            particle->color = color;
+        }
+        else
+        {
+            particle->color = Vec4(color.x * particle->originalColor.x, color.y * particle->originalColor.y, color.z * particle->originalColor.z, color.w * particle->originalColor.w);
+        }
+    }
+}
+
 PUColorAffector* PUColorAffector::create()
 {
     auto pca = new (std::nothrow) PUColorAffector();
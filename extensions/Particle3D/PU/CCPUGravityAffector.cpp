@@ -77,6 +77,27 @@ void PUGravityAffector::updatePUAffector( PUParticle3D *particle, float deltaTim
     }
 }
 
+void PUGravityAffector::updateAffectorBatch( PUParticle3D **particles, size_t count, float deltaTime )
+{
+    float scaleVelocity = (static_cast<PUParticleSystem3D *>(_particleSystem))->getParticleSystemScaleVelocity();
+    float gravity = scaleVelocity * _gravity * _mass * deltaTime;
+    bool specialised = _affectSpecialisation != AFSP_DEFAULT;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        PUParticle3D *particle = particles[i];
+        Vec3 distance = _derivedPosition - particle->position;
+        float length = distance.lengthSquared();
+        if (length > 0)
+        {
+            float force = gravity * particle->mass / length;
+            if (specialised)
+                force *= calculateAffectSpecialisationFactor(particle);
+            particle->direction += force * distance;
+        }
+    }
+}
+
 void PUGravityAffector::preUpdateAffector( float /*deltaTime*/ )
 {
     getDerivedPosition();
@@ -43,6 +43,7 @@ public:
 
     virtual void preUpdateAffector(float deltaTime) override;
     virtual void updatePUAffector(PUParticle3D *particle, float deltaTime) override;
+    virtual void updateAffectorBatch(PUParticle3D **particles, size_t count, float deltaTime) override;
 
     /** 
     */
@@ -56,6 +56,34 @@ void PULinearForceAffector::updatePUAffector( PUParticle3D *particle, float /*de
 
 }
 
+void PULinearForceAffector::updateAffectorBatch( PUParticle3D **particles, size_t count, float /*deltaTime*/ )
+{
+    if (_forceApplication == FA_ADD)
+    {
+        if (_affectSpecialisation == AFSP_DEFAULT)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                particles[i]->direction += _scaledVector;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                particles[i]->direction += _scaledVector * calculateAffectSpecialisationFactor(particles[i]);
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            particles[i]->direction = (particles[i]->direction + _forceVector) / 2;
+        }
+    }
+}
+
 PULinearForceAffector* PULinearForceAffector::create()
 {
     auto plfa = new (std::nothrow) PULinearForceAffector();
@@ -41,6 +41,7 @@ public:
 
     virtual void preUpdateAffector(float deltaTime) override;
     virtual void updatePUAffector(PUParticle3D *particle, float deltaTime) override;
+    virtual void updateAffectorBatch(PUParticle3D **particles, size_t count, float deltaTime) override;
 
     virtual void copyAttributesTo (PUAffector* affector) override;
 
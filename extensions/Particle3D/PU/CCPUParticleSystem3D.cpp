@@ -31,6 +31,8 @@
 #include "extensions/Particle3D/PU/CCPUAffectorManager.h"
 #include "extensions/Particle3D/CCParticle3DRender.h"
 #include "extensions/Particle3D/PU/CCPUScriptCompiler.h"
+#include "extensions/Particle3D/PU/CCPUScriptLexer.h"
+#include "extensions/Particle3D/PU/CCPUScriptParser.h"
 #include "extensions/Particle3D/PU/CCPUMaterialManager.h"
 #include "extensions/Particle3D/PU/CCPUTranslateManager.h"
 #include "extensions/Particle3D/PU/CCPUListener.h"
@@ -38,9 +40,41 @@
 #include "extensions/Particle3D/PU/CCPUObserverManager.h"
 #include "extensions/Particle3D/PU/CCPUBehaviour.h"
 #include "platform/CCFileUtils.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 
 NS_CC_BEGIN
 
+namespace
+{
+    // Translated systems by script path, create() clones them instead of translating the script again.
+    // The map owns one reference to each prototype, which keeps its renderers, materials and textures
+    // alive; removeAllPrototypes() drops them and runs on Director::reset() and purgeCachedData().
+    std::unordered_map<std::string, PUParticleSystem3D*> s_prototypes;
+    EventListenerCustom* s_resetListener = nullptr;
+    EventListenerCustom* s_purgeListener = nullptr;
+
+    // Result of lexing and parsing a script on the loading thread
+    struct ParsedScript
+    {
+        std::string fullPath;
+        PUScriptTokenList tokens;
+        PUConcreteNodeList nodes;
+
+        ~ParsedScript()
+        {
+            for (auto iter : nodes){
+                delete iter;
+            }
+            for (auto iter : tokens){
+                delete iter;
+            }
+        }
+    };
+}
+
 float PUParticle3D::DEFAULT_TTL = 10.0f;
 float PUParticle3D::DEFAULT_MASS = 1.0f;
 
@@ -201,18 +235,18 @@ PUParticleSystem3D::~PUParticleSystem3D()
 
     _particlePool.removeAllDatas();
 
-    for (auto iter : _emittedEmitterParticlePool){
-        auto pool = iter.second;
-        auto lockedList = pool.getUnActiveDataList();
+    for (auto &iter : _emittedEmitterParticlePool){
+        auto &pool = iter.second;
+        auto &lockedList = pool.getUnActiveDataList();
         for (auto iter2 : lockedList){
             static_cast<PUParticle3D *>(iter2)->particleEntityPtr->release();
         }
         iter.second.removeAllDatas();
     }
 
-    for (auto iter : _emittedSystemParticlePool){
-        auto pool = iter.second;
-        auto lockedList = pool.getUnActiveDataList();
+    for (auto &iter : _emittedSystemParticlePool){
+        auto &pool = iter.second;
+        auto &lockedList = pool.getUnActiveDataList();
         for (auto iter2 : lockedList){
             static_cast<PUParticle3D *>(iter2)->particleEntityPtr->release();
         }
@@ -245,32 +279,96 @@ PUParticleSystem3D* PUParticleSystem3D::create()
 
 PUParticleSystem3D* PUParticleSystem3D::create( const std::string &filePath, const std::string &materialPath )
 {
-    PUParticleSystem3D *ret = new (std::nothrow) PUParticleSystem3D();
-    if (ret && ret->initWithFilePathAndMaterialPath(filePath, materialPath))
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+    convertToUnixStylePath(fullPath);
+    std::string matfullPath = FileUtils::getInstance()->fullPathForFilename(materialPath);
+    convertToUnixStylePath(matfullPath);
+    auto prototype = getPrototype(fullPath, matfullPath);
+    return prototype ? prototype->cloneFromPrototype() : nullptr;
+}
+
+PUParticleSystem3D* PUParticleSystem3D::create( const std::string &filePath )
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+    convertToUnixStylePath(fullPath);
+    auto prototype = getPrototype(fullPath, "");
+    return prototype ? prototype->cloneFromPrototype() : nullptr;
+}
+
+void PUParticleSystem3D::createAsync( const std::string &filePath, const std::function<void(PUParticleSystem3D*, void*)>& callback, void* callbackparam )
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+    convertToUnixStylePath(fullPath);
+    if (s_prototypes.find(fullPath) != s_prototypes.end())
     {
-        ret->autorelease();
-        return ret;
+        if (callback)
+            callback(create(fullPath), callbackparam);
+        return;
     }
-    else
+
+    auto parsed = std::make_shared<ParsedScript>();
+    parsed->fullPath = fullPath;
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [parsed, callback](void* param)
     {
-        CC_SAFE_DELETE(ret);
-        return nullptr;
-    }
+        // Back on the main thread: the translators create nodes and load materials and textures
+        PUScriptCompiler::Instance()->compileParsed(parsed->nodes, parsed->fullPath);
+        auto prototype = getPrototype(parsed->fullPath, "");
+        if (callback)
+            callback(prototype ? prototype->cloneFromPrototype() : nullptr, param);
+    }, callbackparam, [parsed]()
+    {
+        std::string data = FileUtils::getInstance()->getStringFromFile(parsed->fullPath);
+        PUScriptLexer lexer;
+        PUScriptParser parser;
+        lexer.openLexer(data, parsed->fullPath, parsed->tokens);
+        parser.parse(parsed->nodes, parsed->tokens);
+    });
 }
 
-PUParticleSystem3D* PUParticleSystem3D::create( const std::string &filePath )
+void PUParticleSystem3D::removeAllPrototypes()
 {
-    PUParticleSystem3D *ret = new (std::nothrow) PUParticleSystem3D();
-    if (ret && ret->initWithFilePath(filePath))
+    for (auto &iter : s_prototypes){
+        iter.second->release();
+    }
+    s_prototypes.clear();
+
+    if (s_resetListener)
     {
-        ret->autorelease();
-        return ret;
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        dispatcher->removeEventListener(s_resetListener);
+        dispatcher->removeEventListener(s_purgeListener);
+        s_resetListener = nullptr;
+        s_purgeListener = nullptr;
     }
-    else
+}
+
+PUParticleSystem3D* PUParticleSystem3D::getPrototype( const std::string &fullPath, const std::string &materialFullPath )
+{
+    std::string key = materialFullPath.empty() ? fullPath : fullPath + '|' + materialFullPath;
+    auto iter = s_prototypes.find(key);
+    if (iter != s_prototypes.end())
+        return iter->second;
+
+    PUParticleSystem3D *prototype = new (std::nothrow) PUParticleSystem3D();
+    bool ok = prototype && (materialFullPath.empty() ? prototype->initWithFilePath(fullPath)
+                                                     : prototype->initWithFilePathAndMaterialPath(fullPath, materialFullPath));
+    if (!ok)
     {
-        CC_SAFE_DELETE(ret);
+        CC_SAFE_DELETE(prototype);
         return nullptr;
     }
+
+    // the listeners live as long as there are prototypes to release
+    if (!s_resetListener)
+    {
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        s_resetListener = dispatcher->addCustomEventListener(Director::EVENT_RESET, [](EventCustom*){ removeAllPrototypes(); });
+        s_purgeListener = dispatcher->addCustomEventListener(Director::EVENT_PURGE_CACHED_DATA, [](EventCustom*){ removeAllPrototypes(); });
+    }
+
+    // the cache owns the reference returned by new
+    s_prototypes[key] = prototype;
+    return prototype;
 }
 
 bool PUParticleSystem3D::initWithFilePath( const std::string &filePath )
@@ -508,25 +606,25 @@ void PUParticleSystem3D::prepared()
                 PUEmitter *emitter = static_cast<PUEmitter*>(it);
                 if (emitter->getEmitsType() == PUParticle3D::PT_EMITTER){
                     PUEmitter *emitted = static_cast<PUEmitter*>(emitter->getEmitsEntityPtr());
-                    for (unsigned int i = 0; i < _emittedEmitterQuota; ++i){
-                        auto p = new (std::nothrow) PUParticle3D();
+                    auto particles = _emittedEmitterParticlePool[emitted->getName()].addDataBlock<PUParticle3D>(_emittedEmitterQuota);
+                    for (unsigned int i = 0; particles && i < _emittedEmitterQuota; ++i){
+                        auto p = particles + i;
                         p->particleType = PUParticle3D::PT_EMITTER;
                         p->particleEntityPtr = emitted->clone();
                         p->particleEntityPtr->retain();
                         p->copyBehaviours(_behaviourTemplates);
-                        _emittedEmitterParticlePool[emitted->getName()].addData(p);
                     }
                 }
                 else if (emitter->getEmitsType() == PUParticle3D::PT_TECHNIQUE){
                     PUParticleSystem3D *emitted = static_cast<PUParticleSystem3D*>(emitter->getEmitsEntityPtr());
-                    for (unsigned int i = 0; i < _emittedSystemQuota; ++i){
+                    auto particles = _emittedSystemParticlePool[emitted->getName()].addDataBlock<PUParticle3D>(_emittedSystemQuota);
+                    for (unsigned int i = 0; particles && i < _emittedSystemQuota; ++i){
                         PUParticleSystem3D *clonePS = emitted->clone();
-                        auto p = new (std::nothrow) PUParticle3D();
+                        auto p = particles + i;
                         p->particleType = PUParticle3D::PT_TECHNIQUE;
                         p->particleEntityPtr = clonePS;
                         p->particleEntityPtr->retain();
                         p->copyBehaviours(_behaviourTemplates);
-                        _emittedSystemParticlePool[emitted->getName()].addData(p);
                         clonePS->prepared();
                     }
                     //emitted->stopParticle();
@@ -534,10 +632,9 @@ void PUParticleSystem3D::prepared()
 
             }
 
-            for (unsigned int i = 0; i < _particleQuota; ++i){
-                auto p = new (std::nothrow) PUParticle3D();
-                p->copyBehaviours(_behaviourTemplates);
-                _particlePool.addData(p);
+            auto particles = _particlePool.addDataBlock<PUParticle3D>(_particleQuota);
+            for (unsigned int i = 0; particles && i < _particleQuota; ++i){
+                particles[i].copyBehaviours(_behaviourTemplates);
             }
             _poolPrepared = true;
         }
@@ -1074,11 +1171,11 @@ void PUParticleSystem3D::copyAttributesTo(PUParticleSystem3D* system )
     system->removeAllBehaviourTemplate();
     system->removeAllListener();
     system->_particlePool.removeAllDatas();
-    for (auto iter : system->_emittedEmitterParticlePool){
+    for (auto &iter : system->_emittedEmitterParticlePool){
         iter.second.removeAllDatas();
     }
 
-    for (auto iter : system->_emittedSystemParticlePool){
+    for (auto &iter : system->_emittedSystemParticlePool){
         iter.second.removeAllDatas();
     }
 
@@ -1144,6 +1241,23 @@ PUParticleSystem3D* PUParticleSystem3D::clone()
     return ps;
 }
 
+PUParticleSystem3D* PUParticleSystem3D::cloneFromPrototype()
+{
+    auto ps = PUParticleSystem3D::create();
+    copyAttributesTo(ps);
+    ps->setPosition3D(getPosition3D());
+    ps->setRotationQuat(getRotationQuat());
+    ps->setScaleX(getScaleX());
+    ps->setScaleY(getScaleY());
+    ps->setScaleZ(getScaleZ());
+    for (auto &iter : _children){
+        PUParticleSystem3D *child = dynamic_cast<PUParticleSystem3D *>(iter);
+        if (child)
+            ps->addChild(child->cloneFromPrototype());
+    }
+    return ps;
+}
+
 void PUParticleSystem3D::removeAllEmitter()
 {
     for (auto iter : _emitters){
@@ -1196,12 +1310,13 @@ void PUParticleSystem3D::draw( Renderer *renderer, const Mat4 &transform, uint32
 
 void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveParticle, bool &firstParticle, float elapsedTime )
 {
+    // The pool is walked in three passes: behaviours and emitters, then every affector over all
+    // live particles in one batch, then rendering, emission, motion and observers.
+    // Each particle still gets its updates in the same order.
     Vec3 scale = getDerivedScale();
+    _visitedParticles.clear();
+    _liveParticles.clear();
     PUParticle3D *particle = static_cast<PUParticle3D *>(pool.getFirst());
-    //Mat4 ltow = getNodeToWorldTransform();
-    //Vec3 scl;
-    //Quaternion rot;
-    //ltow.decompose(&scl, &rot, nullptr);
     while (particle){
 
         if (!isExpired(particle, elapsedTime)){
@@ -1215,12 +1330,33 @@ void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveP
                     (static_cast<PUEmitter*>(it))->updateEmitter(particle, elapsedTime);
                 }
             }
+            _liveParticles.push_back(particle);
+        }
+        else{
+            // kept out of emission until the end, it is still visited by the observers below
+            initParticleForExpiration(particle, elapsedTime);
+            pool.expireLatestData();
+        }
 
-            for (auto& it : _affectors) {
-                if (it->isEnabled()){
-                    (static_cast<PUAffector*>(it))->process(particle, elapsedTime, firstActiveParticle);
-                }
+        _visitedParticles.push_back(particle);
+        particle = static_cast<PUParticle3D *>(pool.getNext());
+    }
+
+    if (!_liveParticles.empty()){
+        for (auto& it : _affectors) {
+            if (it->isEnabled()){
+                (static_cast<PUAffector*>(it))->processBatch(_liveParticles.data(), _liveParticles.size(), elapsedTime, firstActiveParticle);
             }
+        }
+    }
+
+    // _liveParticles is in the same order as _visitedParticles
+    size_t liveIndex = 0;
+    for (auto visited : _visitedParticles){
+        particle = visited;
+
+        if (liveIndex < _liveParticles.size() && _liveParticles[liveIndex] == particle){
+            ++liveIndex;
 
             if (_render)
                 static_cast<PURender *>(_render)->updateRender(particle, elapsedTime, firstActiveParticle);
@@ -1271,10 +1407,6 @@ void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveP
             //}
             processMotion(particle, elapsedTime, scale, firstActiveParticle);
         }
-        else{
-            initParticleForExpiration(particle, elapsedTime);
-            pool.lockLatestData();
-        }
 
         for (auto it : _observers){
             if (it->isEnabled()){
@@ -1294,8 +1426,9 @@ void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveP
 
         particle->timeToLive -= elapsedTime;
         firstParticle = false;
-        particle = static_cast<PUParticle3D *>(pool.getNext());
     }
+
+    pool.unlockExpiredDatas();
 }
 
 bool PUParticleSystem3D::makeParticleLocal( PUParticle3D* particle )
@@ -33,6 +33,7 @@
 #include "extensions/Particle3D/CCParticleSystem3D.h"
 #include <vector>
 #include <map>
+#include <functional>
 
 NS_CC_BEGIN
 
@@ -229,6 +230,21 @@ public:
     static PUParticleSystem3D* create();
     static PUParticleSystem3D* create(const std::string &filePath);
     static PUParticleSystem3D* create(const std::string &filePath, const std::string &materialPath);
+
+    /**
+     * Lexes and parses the script on a background thread, then translates it on the main thread.
+     * The translated system is kept as a prototype, so later create(filePath) calls only clone it.
+     * @param filePath path of the particle system script
+     * @param callback called on the main thread with the new system, nullptr on failure. May be nullptr to just prewarm.
+     * @param callbackparam user defined parameter for the callback
+     */
+    static void createAsync(const std::string &filePath, const std::function<void(PUParticleSystem3D*, void*)>& callback, void* callbackparam);
+
+    /** Releases the prototypes kept by create() and createAsync(); the next create() translates its script again.
+     * The cache owns the prototypes, along with their renderers, materials and textures, until this is called.
+     * It is called on Director::reset() and Director::purgeCachedData().
+     */
+    static void removeAllPrototypes();
     
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
@@ -353,6 +369,8 @@ public:
 
     virtual PUParticleSystem3D* clone();
     virtual void copyAttributesTo(PUParticleSystem3D* system);
+    /** Like clone(), but also copies the node transforms set by the script. */
+    PUParticleSystem3D* cloneFromPrototype();
 
     bool initSystem(const std::string &filePath);
 
@@ -365,6 +383,8 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
 
+    static PUParticleSystem3D* getPrototype(const std::string &fullPath, const std::string &materialFullPath);
+
     void prepared();
     void unPrepared();
     void preUpdator(float elapsedTime);
@@ -392,6 +412,10 @@ protected:
     ParticlePoolMap              _emittedEmitterParticlePool;
     ParticlePoolMap              _emittedSystemParticlePool;
 
+    // scratch lists of processParticle(), kept to avoid allocating every frame
+    std::vector<PUParticle3D*>   _visitedParticles;
+    std::vector<PUParticle3D*>   _liveParticles;
+
     unsigned int                 _emittedEmitterQuota;
     unsigned int                 _emittedSystemQuota;
 
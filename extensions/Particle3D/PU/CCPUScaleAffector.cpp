@@ -259,6 +259,15 @@ void PUScaleAffector::updatePUAffector( PUParticle3D *particle, float deltaTime
 
 }
 
+void PUScaleAffector::updateAffectorBatch( PUParticle3D **particles, size_t count, float deltaTime )
+{
+    // Non virtual calls to the per particle update, everything else depends on the particle
+    for (size_t i = 0; i < count; ++i)
+    {
+        PUScaleAffector::updatePUAffector(particles[i], deltaTime);
+    }
+}
+
 PUScaleAffector* PUScaleAffector::create()
 {
     auto psa = new (std::nothrow) PUScaleAffector();
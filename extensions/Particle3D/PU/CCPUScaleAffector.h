@@ -46,6 +46,7 @@ public:
     static PUScaleAffector* create();
 
     virtual void updatePUAffector(PUParticle3D *particle, float deltaTime) override;
+    virtual void updateAffectorBatch(PUParticle3D **particles, size_t count, float deltaTime) override;
 
     /** 
     */
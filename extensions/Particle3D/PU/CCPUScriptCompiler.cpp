@@ -254,6 +254,19 @@ const PUAbstractNodeList* PUScriptCompiler::compile(const std::string &file, boo
 
 
 
+const PUAbstractNodeList* PUScriptCompiler::compileParsed(const PUConcreteNodeList &nodes, const std::string &file)
+{
+    auto iter = _compiledScripts.find(file);
+    if (iter != _compiledScripts.end()){
+        return &iter->second;
+    }
+
+    if (compile(nodes, file)){
+        return &_compiledScripts[file];
+    }
+    return nullptr;
+}
+
 void PUScriptCompiler::convertToAST(const PUConcreteNodeList &nodes,PUAbstractNodeList &aNodes)
 {
 
@@ -145,6 +145,8 @@ public:
     void setParticleSystem3D(PUParticleSystem3D *pu);
 
     const PUAbstractNodeList* compile(const std::string &file, bool &isFirstCompile);
+    // compiles nodes that were lexed and parsed elsewhere, e.g. on a loading thread
+    const PUAbstractNodeList* compileParsed(const PUConcreteNodeList &nodes, const std::string &file);
     
     void convertToAST(const PUConcreteNodeList &nodes,PUAbstractNodeList &aNodes);
     
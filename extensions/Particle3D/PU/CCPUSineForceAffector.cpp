@@ -107,6 +107,24 @@ void PUSineForceAffector::updatePUAffector( PUParticle3D *particle, float /*delt
     }
 }
 
+void PUSineForceAffector::updateAffectorBatch( PUParticle3D **particles, size_t count, float /*deltaTime*/ )
+{
+    if (_forceApplication == FA_ADD)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            particles[i]->direction += _scaledVector;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            particles[i]->direction = (particles[i]->direction + _forceVector) / 2;
+        }
+    }
+}
+
 PUSineForceAffector* PUSineForceAffector::create()
 {
     auto psfa = new (std::nothrow) PUSineForceAffector();
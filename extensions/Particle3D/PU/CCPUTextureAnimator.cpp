@@ -249,6 +249,34 @@ void PUTextureAnimator::updatePUAffector( PUParticle3D *particle, float deltaTim
     }
 }
 
+void PUTextureAnimator::updateAffectorBatch( PUParticle3D **particles, size_t count, float deltaTime )
+{
+    if (_animationTimeStepSet)
+    {
+        // The global time step decides for all particles at once
+        if (!_nextIndex)
+            return;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            determineNextTextureCoords(particles[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            PUParticle3D *particle = particles[i];
+            particle->textureAnimationTimeStepCount += deltaTime;
+            if (particle->textureAnimationTimeStepCount > particle->textureAnimationTimeStep)
+            {
+                particle->textureAnimationTimeStepCount -= particle->textureAnimationTimeStep;
+                determineNextTextureCoords(particle);
+            }
+        }
+    }
+}
+
 PUTextureAnimator* PUTextureAnimator::create()
 {
     auto pta = new (std::nothrow) PUTextureAnimator();
@@ -55,6 +55,7 @@ public:
     virtual void preUpdateAffector(float deltaTime) override;
     virtual void initParticleForEmission(PUParticle3D* particle) override;
     virtual void updatePUAffector(PUParticle3D *particle, float deltaTime) override;
+    virtual void updateAffectorBatch(PUParticle3D **particles, size_t count, float deltaTime) override;
 
     /** Returns the AnimationTimeStep. The AnimationTimeStep defines the time between each animation frame. */
     float getAnimationTimeStep() const;
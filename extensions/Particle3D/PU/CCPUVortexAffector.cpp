@@ -99,6 +99,26 @@ void PUVortexAffector::updatePUAffector( PUParticle3D *particle, float /*deltaTi
     }
 }
 
+void PUVortexAffector::updateAffectorBatch( PUParticle3D **particles, size_t count, float /*deltaTime*/ )
+{
+    // The rotation is the same for every particle, build the matrix once
+    Mat4 rotMat;
+    Mat4::createRotation(_rotation, &rotMat);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        PUParticle3D *particle = particles[i];
+        // Explicitly check on 'freezed', because it passes the techniques' validation.
+        if (particle->isFreezed())
+            continue;
+
+        Vec3 local = particle->position - _derivedPosition;
+        particle->position = _derivedPosition + rotMat * local;
+        particle->direction = rotMat * particle->direction;
+        particle->orientation = _rotation * particle->orientation;
+    }
+}
+
 void PUVortexAffector::preUpdateAffector( float deltaTime )
 {
     PUParticleSystem3D* sys = static_cast<PUParticleSystem3D *>(_particleSystem);